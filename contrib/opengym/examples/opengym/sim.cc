@@ -139,11 +139,13 @@ main (int argc, char *argv[])
   double simulationTime = 1; //seconds
   double envStepTime = 0.1; //seconds, ns3gym env step time interval
   uint32_t openGymPort = 5555;
+  uint32_t openGymEnvId = 0;
   uint32_t testArg = 0;
 
   CommandLine cmd;
   // required parameters for OpenGym interface
   cmd.AddValue ("openGymPort", "Port number for OpenGym env. Default: 5555", openGymPort);
+  cmd.AddValue ("openGymEnvId", "Index of OpenGym env when run by Ns3VecEnv. Default: 0", openGymEnvId);
   cmd.AddValue ("simSeed", "Seed for random generator. Default: 1", simSeed);
   // optional parameters
   cmd.AddValue ("simTime", "Simulation time in seconds. Default: 10s", simulationTime);
@@ -153,6 +155,7 @@ main (int argc, char *argv[])
   NS_LOG_UNCOND("Ns3Env parameters:");
   NS_LOG_UNCOND("--simulationTime: " << simulationTime);
   NS_LOG_UNCOND("--openGymPort: " << openGymPort);
+  NS_LOG_UNCOND("--openGymEnvId: " << openGymEnvId);
   NS_LOG_UNCOND("--envStepTime: " << envStepTime);
   NS_LOG_UNCOND("--seed: " << simSeed);
   NS_LOG_UNCOND("--testArg: " << testArg);
@@ -161,7 +164,7 @@ main (int argc, char *argv[])
   RngSeedManager::SetRun (simSeed);
 
   // OpenGym Env
-  Ptr<OpenGymInterface> openGym = CreateObject<OpenGymInterface> (openGymPort);
+  Ptr<OpenGymInterface> openGym = CreateObject<OpenGymVecInterface> (openGymPort, openGymEnvId);
   openGym->SetGetActionSpaceCb( MakeCallback (&MyGetActionSpace) );
   openGym->SetGetObservationSpaceCb( MakeCallback (&MyGetObservationSpace) );
   openGym->SetGetGameOverCb( MakeCallback (&MyGetGameOver) );
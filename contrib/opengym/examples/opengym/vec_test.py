@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import argparse
+from ns3gym import ns3env
+
+
+parser = argparse.ArgumentParser(description='Run several simulations behind one agent')
+parser.add_argument('--envs',
+                    type=int,
+                    default=4,
+                    help='Number of simulations stepped together, Default: 4')
+parser.add_argument('--steps',
+                    type=int,
+                    default=20,
+                    help='Number of vectorized steps, Default: 20')
+args = parser.parse_args()
+numEnvs = int(args.envs)
+stepNum = int(args.steps)
+
+port = 5555
+simTime = 20 # seconds
+stepTime = 0.5  # seconds
+seed = 0
+simArgs = {"--simTime": simTime,
+           "--testArg": 123}
+debug = False
+
+env = ns3env.Ns3VecEnv(numEnvs, port=port, stepTime=stepTime, startSim=True, simSeed=seed, simArgs=simArgs, debug=debug)
+
+print("Observation space (single env): ", env.observation_space)
+print("Action space (single env): ", env.action_space)
+
+try:
+    obs = env.reset()
+    print("---obs: ", obs)
+
+    for stepIdx in range(stepNum):
+        actions = env.get_random_action()
+        obs, rewards, dones, infos = env.step(actions)
+
+        print("Step: ", stepIdx)
+        print("---obs, rewards, dones: ", obs, rewards, dones)
+
+except KeyboardInterrupt:
+    print("Ctrl-C -> Exit")
+finally:
+    env.close()
+    print("Done")
@@ -28,6 +28,126 @@ NS_LOG_COMPONENT_DEFINE ("OpenGymDataContainer");
 
 NS_OBJECT_ENSURE_REGISTERED (OpenGymDataContainer);
 
+uint16_t
+OpenGymFloatToHalf (float value)
+{
+  uint32_t f;
+  std::memcpy (&f, &value, sizeof (f));
+  uint16_t sign = (f >> 16) & 0x8000;
+  int32_t exp = ((f >> 23) & 0xff) - 127 + 15;
+  uint32_t mant = f & 0x7fffff;
+
+  if (((f >> 23) & 0xff) == 0xff)
+    {
+      // inf or nan, keep nan quiet
+      return sign | 0x7c00 | (mant ? 0x200 | (mant >> 13) : 0);
+    }
+  if (exp >= 0x1f)
+    {
+      // overflow -> inf
+      return sign | 0x7c00;
+    }
+  if (exp <= 0)
+    {
+      // subnormal half or zero
+      if (exp < -10)
+        {
+          return sign;
+        }
+      mant |= 0x800000;
+      uint32_t shift = 14 - exp;
+      uint32_t half = mant >> shift;
+      uint32_t rest = mant & ((1u << shift) - 1);
+      uint32_t mid = 1u << (shift - 1);
+      if (rest > mid || (rest == mid && (half & 1)))
+        {
+          half++;
+        }
+      return sign | half;
+    }
+
+  uint32_t half = (exp << 10) | (mant >> 13);
+  uint32_t rest = mant & 0x1fff;
+  // round to nearest even, a carry into the exponent is fine (up to inf)
+  if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+    {
+      half++;
+    }
+  return sign | half;
+}
+
+float
+OpenGymHalfToFloat (uint16_t value)
+{
+  uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+  int32_t exp = (value >> 10) & 0x1f;
+  uint32_t mant = value & 0x3ff;
+  uint32_t f;
+
+  if (exp == 0x1f)
+    {
+      f = sign | 0x7f800000 | (mant << 13);
+    }
+  else if (exp == 0)
+    {
+      if (mant == 0)
+        {
+          f = sign;
+        }
+      else
+        {
+          // normalize subnormal half
+          exp = 1;
+          while (!(mant & 0x400))
+            {
+              mant <<= 1;
+              exp--;
+            }
+          mant &= 0x3ff;
+          f = sign | ((uint32_t)(exp - 15 + 127) << 23) | (mant << 13);
+        }
+    }
+  else
+    {
+      f = sign | ((uint32_t)(exp - 15 + 127) << 23) | (mant << 13);
+    }
+
+  float result;
+  std::memcpy (&result, &f, sizeof (result));
+  return result;
+}
+
+template <typename T>
+static Ptr<OpenGymDataContainer>
+CreateBoxFromRawData (const ns3opengym::BoxDataContainer &boxContainerPbMsg)
+{
+  const std::string &rawData = boxContainerPbMsg.rawdata();
+  std::vector<T> myData(rawData.size() / sizeof(T));
+  std::memcpy(myData.data(), rawData.data(), myData.size() * sizeof(T));
+
+  std::vector<uint32_t> shape(boxContainerPbMsg.shape().begin(), boxContainerPbMsg.shape().end());
+  Ptr<OpenGymBoxContainer<T> > box = CreateObject<OpenGymBoxContainer<T> >(shape);
+  box->SetData(myData);
+  return box;
+}
+
+static Ptr<OpenGymDataContainer>
+CreateBoxFromRawHalfData (const ns3opengym::BoxDataContainer &boxContainerPbMsg)
+{
+  const std::string &rawData = boxContainerPbMsg.rawdata();
+  std::vector<float> myData(rawData.size() / sizeof(uint16_t));
+  for (uint32_t i = 0; i < myData.size(); i++) {
+    uint16_t half;
+    std::memcpy(&half, rawData.data() + i * sizeof(uint16_t), sizeof(half));
+    myData[i] = OpenGymHalfToFloat(half);
+  }
+
+  std::vector<uint32_t> shape(boxContainerPbMsg.shape().begin(), boxContainerPbMsg.shape().end());
+  Ptr<OpenGymBoxContainer<float> > box = CreateObject<OpenGymBoxContainer<float> >(shape);
+  box->SetData(myData);
+  return box;
+}
+
 
 TypeId
 OpenGymDataContainer::GetTypeId (void)
@@ -61,6 +181,12 @@ OpenGymDataContainer::DoInitialize (void)
   //NS_LOG_FUNCTION (this);
 }
 
+ns3opengym::DataContainer
+OpenGymDataContainer::GetShmDataContainerPbMsg(Ptr<OpenGymShmBuffer> shm)
+{
+  return GetDataContainerPbMsg();
+}
+
 Ptr<OpenGymDataContainer>
 OpenGymDataContainer::CreateFromDataContainerPbMsg(ns3opengym::DataContainer &dataContainerPbMsg)
 {
@@ -79,8 +205,34 @@ OpenGymDataContainer::CreateFromDataContainerPbMsg(ns3opengym::DataContainer &da
   {
     ns3opengym::BoxDataContainer boxContainerPbMsg;
     dataContainerPbMsg.data().UnpackTo(&boxContainerPbMsg);
-
-    if (boxContainerPbMsg.dtype() == ns3opengym::INT) {
+    std::string elemType = boxContainerPbMsg.elemtype();
+
+    if (!boxContainerPbMsg.rawdata().empty()) {
+      if (elemType == "int8") {
+        actDataContainer = CreateBoxFromRawData<int8_t>(boxContainerPbMsg);
+      } else if (elemType == "int16") {
+        actDataContainer = CreateBoxFromRawData<int16_t>(boxContainerPbMsg);
+      } else if (elemType == "int32") {
+        actDataContainer = CreateBoxFromRawData<int32_t>(boxContainerPbMsg);
+      } else if (elemType == "int64") {
+        actDataContainer = CreateBoxFromRawData<int64_t>(boxContainerPbMsg);
+      } else if (elemType == "uint8") {
+        actDataContainer = CreateBoxFromRawData<uint8_t>(boxContainerPbMsg);
+      } else if (elemType == "uint16") {
+        actDataContainer = CreateBoxFromRawData<uint16_t>(boxContainerPbMsg);
+      } else if (elemType == "uint32") {
+        actDataContainer = CreateBoxFromRawData<uint32_t>(boxContainerPbMsg);
+      } else if (elemType == "uint64") {
+        actDataContainer = CreateBoxFromRawData<uint64_t>(boxContainerPbMsg);
+      } else if (elemType == "float16") {
+        actDataContainer = CreateBoxFromRawHalfData(boxContainerPbMsg);
+      } else if (elemType == "float64") {
+        actDataContainer = CreateBoxFromRawData<double>(boxContainerPbMsg);
+      } else {
+        actDataContainer = CreateBoxFromRawData<float>(boxContainerPbMsg);
+      }
+
+    } else if (boxContainerPbMsg.dtype() == ns3opengym::INT) {
       Ptr<OpenGymBoxContainer<int32_t> > box = CreateObject<OpenGymBoxContainer<int32_t> >();
       std::vector<int32_t> myData;
       myData.assign(boxContainerPbMsg.intdata().begin(), boxContainerPbMsg.intdata().end());
@@ -283,6 +435,27 @@ OpenGymTupleContainer::GetDataContainerPbMsg()
   return dataContainerPbMsg;
 }
 
+ns3opengym::DataContainer
+OpenGymTupleContainer::GetShmDataContainerPbMsg(Ptr<OpenGymShmBuffer> shm)
+{
+  ns3opengym::DataContainer dataContainerPbMsg;
+  dataContainerPbMsg.set_type(ns3opengym::Tuple);
+
+  ns3opengym::TupleDataContainer tupleContainerPbMsg;
+
+  std::vector< Ptr<OpenGymDataContainer> >::iterator it;
+  for (it=m_tuple.begin(); it!=m_tuple.end(); ++it)
+  {
+    Ptr<OpenGymDataContainer> subSpace = *it;
+    ns3opengym::DataContainer subDataContainer = subSpace->GetShmDataContainerPbMsg(shm);
+
+    tupleContainerPbMsg.add_element()->CopyFrom(subDataContainer);
+  }
+
+  dataContainerPbMsg.mutable_data()->PackFrom(tupleContainerPbMsg);
+  return dataContainerPbMsg;
+}
+
 bool
 OpenGymTupleContainer::Add(Ptr<OpenGymDataContainer> space)
 {
@@ -382,6 +555,30 @@ OpenGymDictContainer::GetDataContainerPbMsg()
   return dataContainerPbMsg;
 }
 
+ns3opengym::DataContainer
+OpenGymDictContainer::GetShmDataContainerPbMsg(Ptr<OpenGymShmBuffer> shm)
+{
+  ns3opengym::DataContainer dataContainerPbMsg;
+  dataContainerPbMsg.set_type(ns3opengym::Dict);
+
+  ns3opengym::DictDataContainer dictContainerPbMsg;
+
+  std::map< std::string, Ptr<OpenGymDataContainer> >::iterator it;
+  for (it=m_dict.begin(); it!=m_dict.end(); ++it)
+  {
+    std::string name = it->first;
+    Ptr<OpenGymDataContainer> subSpace = it->second;
+
+    ns3opengym::DataContainer subDataContainer = subSpace->GetShmDataContainerPbMsg(shm);
+    subDataContainer.set_name(name);
+
+    dictContainerPbMsg.add_element()->CopyFrom(subDataContainer);
+  }
+
+  dataContainerPbMsg.mutable_data()->PackFrom(dictContainerPbMsg);
+  return dataContainerPbMsg;
+}
+
 bool
 OpenGymDictContainer::Add(std::string key, Ptr<OpenGymDataContainer> data)
 {
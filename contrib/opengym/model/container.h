@@ -22,12 +22,31 @@
 #ifndef OPENGYM_CONTAINER_H
 #define OPENGYM_CONTAINER_H
 
+#include <cstring>
+#include <type_traits>
 #include "ns3/object.h"
 #include "ns3/type-name.h"
 #include "messages.pb.h"
+#include "opengym_shm.h"
 
 namespace ns3 {
 
+// IEEE 754 half precision conversion used for float16 packed Box data
+uint16_t OpenGymFloatToHalf (float value);
+float OpenGymHalfToFloat (uint16_t value);
+
+// numpy name of the element type of packed Box data
+inline const char *OpenGymElemType (int8_t) { return "int8"; }
+inline const char *OpenGymElemType (int16_t) { return "int16"; }
+inline const char *OpenGymElemType (int32_t) { return "int32"; }
+inline const char *OpenGymElemType (int64_t) { return "int64"; }
+inline const char *OpenGymElemType (uint8_t) { return "uint8"; }
+inline const char *OpenGymElemType (uint16_t) { return "uint16"; }
+inline const char *OpenGymElemType (uint32_t) { return "uint32"; }
+inline const char *OpenGymElemType (uint64_t) { return "uint64"; }
+inline const char *OpenGymElemType (float) { return "float32"; }
+inline const char *OpenGymElemType (double) { return "float64"; }
+
 class OpenGymDataContainer : public Object
 {
 public:
@@ -37,6 +56,8 @@ public:
   static TypeId GetTypeId ();
 
   virtual ns3opengym::DataContainer GetDataContainerPbMsg() = 0;
+  // Box data is placed in the shm segment; falls back to GetDataContainerPbMsg
+  virtual ns3opengym::DataContainer GetShmDataContainerPbMsg(Ptr<OpenGymShmBuffer> shm);
   static Ptr<OpenGymDataContainer> CreateFromDataContainerPbMsg(ns3opengym::DataContainer &dataContainer);
 
   virtual void Print(std::ostream& where) const = 0;
@@ -94,6 +115,7 @@ public:
   static TypeId GetTypeId ();
 
   virtual ns3opengym::DataContainer GetDataContainerPbMsg();
+  virtual ns3opengym::DataContainer GetShmDataContainerPbMsg(Ptr<OpenGymShmBuffer> shm);
 
   virtual void Print(std::ostream& where) const;
   friend std::ostream& operator<< (std::ostream& os, const Ptr<OpenGymBoxContainer> container)
@@ -110,6 +132,9 @@ public:
 
   std::vector<uint32_t> GetShape();
 
+  // pack float data as float16, halves the payload; only for floating point T
+  bool SetFloat16Packing(bool enable);
+
 protected:
   // Inherited
   virtual void DoInitialize (void);
@@ -117,9 +142,13 @@ protected:
 
 private:
   void SetDtype();
+  std::string GetElemType() const;
+  uint64_t GetPackedSize() const;
+  void PackData(uint8_t *dst) const;
 	std::vector<uint32_t> m_shape;
 	ns3opengym::Dtype m_dtype;
 	std::vector<T> m_data;
+  bool m_float16;
 };
 
 template <typename T>
@@ -136,14 +165,15 @@ OpenGymBoxContainer<T>::GetTypeId (void)
 }
 
 template <typename T>
-OpenGymBoxContainer<T>::OpenGymBoxContainer()
+OpenGymBoxContainer<T>::OpenGymBoxContainer():
+  m_float16(false)
 {
  SetDtype();
 }
 
 template <typename T>
 OpenGymBoxContainer<T>::OpenGymBoxContainer(std::vector<uint32_t> shape):
-	m_shape(shape)
+	m_shape(shape), m_float16(false)
 {
   SetDtype();
 }
@@ -189,28 +219,85 @@ OpenGymBoxContainer<T>::GetDataContainerPbMsg()
   ns3opengym::DataContainer dataContainerPbMsg;
   ns3opengym::BoxDataContainer boxContainerPbMsg;
 
-  std::vector<uint32_t> shape = GetShape();
-  *boxContainerPbMsg.mutable_shape() = {shape.begin(), shape.end()};
+  *boxContainerPbMsg.mutable_shape() = {m_shape.begin(), m_shape.end()};
+  boxContainerPbMsg.set_dtype(m_dtype);
 
+  // data goes as one packed bytes payload described by elemType and shape
+  boxContainerPbMsg.set_elemtype(GetElemType());
+  std::string *rawData = boxContainerPbMsg.mutable_rawdata();
+  rawData->resize(GetPackedSize());
+  if (!rawData->empty()) {
+    PackData(reinterpret_cast<uint8_t*>(&(*rawData)[0]));
+  }
 
-  boxContainerPbMsg.set_dtype(m_dtype);
-  std::vector<T> data = GetData();
+  dataContainerPbMsg.set_type(ns3opengym::Box);
+  dataContainerPbMsg.mutable_data()->PackFrom(boxContainerPbMsg);
+  return dataContainerPbMsg;
+}
 
-  if (m_dtype == ns3opengym::INT) {
-    *boxContainerPbMsg.mutable_intdata() = {data.begin(), data.end()};
+template <typename T>
+std::string
+OpenGymBoxContainer<T>::GetElemType () const
+{
+  if (m_float16)
+    return "float16";
+  return OpenGymElemType (T ());
+}
 
-  } else if (m_dtype == ns3opengym::UINT) {
-    *boxContainerPbMsg.mutable_uintdata() = {data.begin(), data.end()};
+template <typename T>
+uint64_t
+OpenGymBoxContainer<T>::GetPackedSize () const
+{
+  if (m_float16)
+    return m_data.size() * sizeof(uint16_t);
+  return m_data.size() * sizeof(T);
+}
 
-  } else if (m_dtype == ns3opengym::FLOAT) {
-    *boxContainerPbMsg.mutable_floatdata() = {data.begin(), data.end()};
+template <typename T>
+void
+OpenGymBoxContainer<T>::PackData (uint8_t *dst) const
+{
+  if (m_float16) {
+    uint16_t *half = reinterpret_cast<uint16_t*>(dst);
+    for (uint32_t i = 0; i < m_data.size(); i++) {
+      half[i] = OpenGymFloatToHalf(static_cast<float>(m_data[i]));
+    }
+    return;
+  }
+  std::memcpy(dst, m_data.data(), m_data.size() * sizeof(T));
+}
 
-  } else if (m_dtype == ns3opengym::DOUBLE) {
-    *boxContainerPbMsg.mutable_doubledata() = {data.begin(), data.end()};
+template <typename T>
+bool
+OpenGymBoxContainer<T>::SetFloat16Packing(bool enable)
+{
+  if (enable && !std::is_floating_point<T>::value) {
+    return false;
+  }
+  m_float16 = enable;
+  return true;
+}
 
-  } else {
-    *boxContainerPbMsg.mutable_floatdata() = {data.begin(), data.end()};
+template <typename T>
+ns3opengym::DataContainer
+OpenGymBoxContainer<T>::GetShmDataContainerPbMsg(Ptr<OpenGymShmBuffer> shm)
+{
+  uint64_t length = GetPackedSize();
+  uint64_t offset = 0;
+  uint8_t *dst = shm->Allocate(length, offset);
+  if (!dst) {
+    return GetDataContainerPbMsg();
   }
+  PackData(dst);
+
+  ns3opengym::DataContainer dataContainerPbMsg;
+  ns3opengym::BoxDataContainer boxContainerPbMsg;
+
+  *boxContainerPbMsg.mutable_shape() = {m_shape.begin(), m_shape.end()};
+  boxContainerPbMsg.set_dtype(m_dtype);
+  boxContainerPbMsg.set_elemtype(GetElemType());
+  boxContainerPbMsg.set_shmoffset(offset);
+  boxContainerPbMsg.set_shmlength(length);
 
   dataContainerPbMsg.set_type(ns3opengym::Box);
   dataContainerPbMsg.mutable_data()->PackFrom(boxContainerPbMsg);
@@ -285,6 +372,7 @@ public:
   static TypeId GetTypeId ();
 
   virtual ns3opengym::DataContainer GetDataContainerPbMsg();
+  virtual ns3opengym::DataContainer GetShmDataContainerPbMsg(Ptr<OpenGymShmBuffer> shm);
 
   virtual void Print(std::ostream& where) const;
   friend std::ostream& operator<< (std::ostream& os, const Ptr<OpenGymTupleContainer> container)
@@ -314,6 +402,7 @@ public:
   static TypeId GetTypeId ();
 
   virtual ns3opengym::DataContainer GetDataContainerPbMsg();
+  virtual ns3opengym::DataContainer GetShmDataContainerPbMsg(Ptr<OpenGymShmBuffer> shm);
 
   virtual void Print(std::ostream& where) const;
   friend std::ostream& operator<< ( std::ostream& os, const Ptr<OpenGymDictContainer> container)
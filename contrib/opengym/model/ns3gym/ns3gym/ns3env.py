@@ -2,6 +2,11 @@ import os
 import sys
 import zmq
 import time
+import signal
+import mmap
+import struct
+import ctypes
+import ctypes.util
 
 import numpy as np
 
@@ -22,9 +27,88 @@ __version__ = "0.1.0"
 __email__ = "gawlowicz@tkn.tu-berlin.de"
 
 
+class Ns3ShmChannel(object):
+    """Agent side of the shared-memory transport (see opengym_shm.h)"""
+    MAGIC = 0x6e733367
+    VERSION = 1
+    HEADER_FMT = "<IIIIQQQQQQQ"
+    STATE_LEN_OFFSET = 56
+    ACT_LEN_OFFSET = 64
+    STATE_SEM_OFFSET = 128
+    ACT_SEM_OFFSET = 160
+
+    class _Timespec(ctypes.Structure):
+        _fields_ = [("tv_sec", ctypes.c_long), ("tv_nsec", ctypes.c_long)]
+
+    _libc = None
+
+    def __init__(self, name, simPid=None):
+        if Ns3ShmChannel._libc is None:
+            Ns3ShmChannel._libc = ctypes.CDLL(ctypes.util.find_library('pthread') or None, use_errno=True)
+
+        self.name = name
+        self.simPid = simPid
+        fd = os.open("/dev/shm" + name, os.O_RDWR)
+        try:
+            self.mm = mmap.mmap(fd, 0)
+        finally:
+            os.close(fd)
+
+        (magic, version, self.nSlots, _, self.slotSize, self.msgSize,
+         self.stateMsgOffset, self.actMsgOffset, self.slotsOffset, _, _) = struct.unpack_from(self.HEADER_FMT, self.mm, 0)
+        if magic != self.MAGIC or version != self.VERSION:
+            raise RuntimeError("Shared-memory segment %s has unknown layout" % name)
+
+        self._base = ctypes.addressof(ctypes.c_char.from_buffer(self.mm))
+        self._stateSem = ctypes.c_void_p(self._base + self.STATE_SEM_OFFSET)
+        self._actSem = ctypes.c_void_p(self._base + self.ACT_SEM_OFFSET)
+
+    def recv(self):
+        # wait in short rounds to stay responsive to Ctrl-C and to a dead simulation
+        while True:
+            deadline = time.time() + 1.0
+            ts = self._Timespec(int(deadline), int((deadline % 1) * 1e9))
+            if self._libc.sem_timedwait(self._stateSem, ctypes.byref(ts)) == 0:
+                break
+            if self.simPid:
+                try:
+                    os.kill(self.simPid, 0)
+                except OSError:
+                    self.close()
+                    raise RuntimeError("Simulation process %d is gone" % self.simPid)
+
+        (stateLen,) = struct.unpack_from("<Q", self.mm, self.STATE_LEN_OFFSET)
+        return self.mm[self.stateMsgOffset:self.stateMsgOffset + stateLen]
+
+    def send(self, msg):
+        if len(msg) > self.msgSize:
+            raise RuntimeError("EnvActMsg of %d bytes exceeds shm message area" % len(msg))
+        self.mm[self.actMsgOffset:self.actMsgOffset + len(msg)] = msg
+        struct.pack_into("<Q", self.mm, self.ACT_LEN_OFFSET, len(msg))
+        self._libc.sem_post(self._actSem)
+
+    def close(self):
+        # the simulation unlinks the segment when it stops by itself, not
+        # when it is killed or crashes
+        try:
+            os.unlink("/dev/shm" + self.name)
+        except OSError:
+            pass
+
+    def get_array(self, boxContainerPb):
+        # zero-copy view, valid until the simulation reuses the slot nSlots steps later
+        dtype = np.dtype(boxContainerPb.elemType)
+        count = boxContainerPb.shmLength // dtype.itemsize
+        data = np.frombuffer(self.mm, dtype=dtype, count=count, offset=boxContainerPb.shmOffset)
+        shape = tuple(boxContainerPb.shape)
+        if shape and int(np.prod(shape)) == count:
+            data = data.reshape(shape)
+        return data
+
+
 class Ns3ZmqBridge(object):
     """docstring for Ns3ZmqBridge"""
-    def __init__(self, port=0, startSim=True, simSeed=0, simArgs={}, debug=False):
+    def __init__(self, port=0, startSim=True, simSeed=0, simArgs={}, debug=False, transport="zmq", actionLag=False, forkReset=False):
         super(Ns3ZmqBridge, self).__init__()
         port = int(port)
         self.port = port
@@ -35,6 +119,25 @@ class Ns3ZmqBridge(object):
         self.simPid = None
         self.wafPid = None
         self.ns3Process = None
+        self.shm = None
+
+        if transport == "shm":
+            simArgs = dict(simArgs)
+            simArgs["--OpenGymInterface::Transport"] = "Shm"
+            self.simArgs = simArgs
+
+        # actions sent in step() are applied by the simulation one step later,
+        # it keeps simulating while the agent computes them
+        if actionLag:
+            simArgs = dict(simArgs)
+            simArgs["--OpenGymInterface::ActionLag"] = "true"
+            self.simArgs = simArgs
+
+        # the simulation is built once and forks a new process per episode
+        if forkReset:
+            simArgs = dict(simArgs)
+            simArgs["--OpenGymInterface::ForkReset"] = "true"
+            self.simArgs = simArgs
 
         context = zmq.Context()
         self.socket = context.socket(zmq.REP)
@@ -78,6 +181,7 @@ class Ns3ZmqBridge(object):
         self.gameOverReason = None
         self.extraInfo = None
         self.newStateRx = False
+        self.stopCmdSent = False
 
     def close(self):
         try:
@@ -95,6 +199,9 @@ class Ns3ZmqBridge(object):
                     self.wafPid = None
         except Exception as e:
             pass
+        if self.shm:
+            self.shm.close()
+            self.shm = None
 
     def _create_space(self, spaceDesc):
         space = None
@@ -157,6 +264,10 @@ class Ns3ZmqBridge(object):
         self._action_space = self._create_space(simInitMsg.actSpace)
         self._observation_space = self._create_space(simInitMsg.obsSpace)
 
+        # after the ack all traffic goes through shared memory
+        if simInitMsg.shmName:
+            self.shm = Ns3ShmChannel(simInitMsg.shmName, self.simPid)
+
         reply = pb.SimInitAck()
         reply.done = True
         reply.stopSimReq = False
@@ -164,6 +275,17 @@ class Ns3ZmqBridge(object):
         self.socket.send(replyMsg)
         return True
 
+    def _recv_msg(self):
+        if self.shm:
+            return self.shm.recv()
+        return self.socket.recv()
+
+    def _send_msg(self, msg):
+        if self.shm:
+            self.shm.send(msg)
+        else:
+            self.socket.send(msg)
+
     def get_action_space(self):
         return self._action_space
 
@@ -177,7 +299,7 @@ class Ns3ZmqBridge(object):
         if self.newStateRx:
             return
 
-        request = self.socket.recv()
+        request = self._recv_msg()
         envStateMsg = pb.EnvStateMsg()
         envStateMsg.ParseFromString(request)
 
@@ -205,10 +327,30 @@ class Ns3ZmqBridge(object):
         reply.stopSimReq = True
 
         replyMsg = reply.SerializeToString()
-        self.socket.send(replyMsg)
+        self._send_msg(replyMsg)
         self.newStateRx = False
+        self.stopCmdSent = True
         return True
 
+    def next_episode(self, stepInterval):
+        # ForkReset: stop the process of the current episode and wait for
+        # the simulation to fork the process of the next one
+        if not self.stopCmdSent:
+            self.force_env_stop()
+            self.rx_env_state()
+            if not self.stopCmdSent:
+                self.send_close_command()
+
+        self.envStopped = False
+        self.forceEnvStop = False
+        self.stopCmdSent = False
+        self.gameOver = False
+        self.gameOverReason = None
+        self.newStateRx = False
+        self.shm = None
+        self.initialize_env(stepInterval)
+        self.rx_env_state()
+
     def send_actions(self, actions):
         reply = pb.EnvActMsg()
 
@@ -220,7 +362,7 @@ class Ns3ZmqBridge(object):
             reply.stopSimReq = True
 
         replyMsg = reply.SerializeToString()
-        self.socket.send(replyMsg)
+        self._send_msg(replyMsg)
         self.newStateRx = False
         return True
 
@@ -245,6 +387,18 @@ class Ns3ZmqBridge(object):
             dataContainerPb.data.Unpack(boxContainerPb)
             # print(boxContainerPb.shape, boxContainerPb.dtype, boxContainerPb.uintData)
 
+            if boxContainerPb.shmLength:
+                return self.shm.get_array(boxContainerPb)
+
+            if boxContainerPb.elemType:
+                # packed bytes, decoded without a per-element loop
+                data = np.frombuffer(boxContainerPb.rawData, dtype=np.dtype(boxContainerPb.elemType))
+                shape = tuple(boxContainerPb.shape)
+                if shape and int(np.prod(shape)) == data.size:
+                    data = data.reshape(shape)
+                return data
+
+            # simulation built against an older ns3gym, repeated fields
             if boxContainerPb.dtype == pb.INT:
                 data = boxContainerPb.intData
             elif boxContainerPb.dtype == pb.UINT:
@@ -304,28 +458,33 @@ class Ns3ZmqBridge(object):
         elif spaceType == spaces.Box:
             dataContainer.type = pb.Box
             boxContainerPb = pb.BoxDataContainer()
-            shape = [len(actions)]
-            boxContainerPb.shape.extend(shape)
 
+            # packed bytes, in the element type the simulation used to get
+            # from the repeated fields: int32, uint32, float32 or float64
             if (spaceDesc.dtype in ['int', 'int8', 'int16', 'int32', 'int64']):
                 boxContainerPb.dtype = pb.INT
-                boxContainerPb.intData.extend(actions)
+                elemType = np.int32
 
             elif (spaceDesc.dtype in ['uint', 'uint8', 'uint16', 'uint32', 'uint64']):
                 boxContainerPb.dtype = pb.UINT
-                boxContainerPb.uintData.extend(actions)
+                elemType = np.uint32
 
             elif (spaceDesc.dtype in ['float', 'float32', 'float64']):
                 boxContainerPb.dtype = pb.FLOAT
-                boxContainerPb.floatData.extend(actions)
+                elemType = np.float32
 
             elif (spaceDesc.dtype in ['double']):
                 boxContainerPb.dtype = pb.DOUBLE
-                boxContainerPb.doubleData.extend(actions)
+                elemType = np.float64
 
             else:
                 boxContainerPb.dtype = pb.FLOAT
-                boxContainerPb.floatData.extend(actions)
+                elemType = np.float32
+
+            data = np.ascontiguousarray(actions, dtype=elemType)
+            boxContainerPb.shape.extend(data.shape)
+            boxContainerPb.elemType = data.dtype.name
+            boxContainerPb.rawData = data.tobytes()
 
             dataContainer.data.Pack(boxContainerPb)
 
@@ -360,13 +519,16 @@ class Ns3ZmqBridge(object):
 
 
 class Ns3Env(gym.Env):
-    def __init__(self, stepTime=0, port=0, startSim=True, simSeed=0, simArgs={}, debug=False):
+    def __init__(self, stepTime=0, port=0, startSim=True, simSeed=0, simArgs={}, debug=False, transport="zmq", actionLag=False, forkReset=False):
         self.stepTime = stepTime
         self.port = port
         self.startSim = startSim
         self.simSeed = simSeed
         self.simArgs = simArgs
         self.debug = debug
+        self.transport = transport
+        self.actionLag = actionLag
+        self.forkReset = forkReset
 
         # Filled in reset function
         self.ns3ZmqBridge = None
@@ -377,7 +539,7 @@ class Ns3Env(gym.Env):
         self.state = None
         self.steps_beyond_done = None
 
-        self.ns3ZmqBridge = Ns3ZmqBridge(self.port, self.startSim, self.simSeed, self.simArgs, self.debug)
+        self.ns3ZmqBridge = Ns3ZmqBridge(self.port, self.startSim, self.simSeed, self.simArgs, self.debug, self.transport, self.actionLag, self.forkReset)
         self.ns3ZmqBridge.initialize_env(self.stepTime)
         self.action_space = self.ns3ZmqBridge.get_action_space()
         self.observation_space = self.ns3ZmqBridge.get_observation_space()
@@ -407,12 +569,17 @@ class Ns3Env(gym.Env):
             obs = self.ns3ZmqBridge.get_obs()
             return obs
 
+        if self.forkReset and self.ns3ZmqBridge:
+            self.envDirty = False
+            self.ns3ZmqBridge.next_episode(self.stepTime)
+            return self.ns3ZmqBridge.get_obs()
+
         if self.ns3ZmqBridge:
             self.ns3ZmqBridge.close()
             self.ns3ZmqBridge = None
 
         self.envDirty = False
-        self.ns3ZmqBridge = Ns3ZmqBridge(self.port, self.startSim, self.simSeed, self.simArgs, self.debug)
+        self.ns3ZmqBridge = Ns3ZmqBridge(self.port, self.startSim, self.simSeed, self.simArgs, self.debug, self.transport, self.actionLag, self.forkReset)
         self.ns3ZmqBridge.initialize_env(self.stepTime)
         self.action_space = self.ns3ZmqBridge.get_action_space()
         self.observation_space = self.ns3ZmqBridge.get_observation_space()
@@ -434,4 +601,274 @@ class Ns3Env(gym.Env):
             self.ns3ZmqBridge = None
 
         if self.viewer:
-            self.viewer.close()
\ No newline at end of file
+            self.viewer.close()
+
+
+class Ns3VecZmqBridge(Ns3ZmqBridge):
+    """ZMQ bridge serving numEnvs simulation processes through one ROUTER socket"""
+    def __init__(self, numEnvs, port=0, startSim=True, simSeed=0, simArgs={}, debug=False, actionLag=False):
+        port = int(port)
+        self.numEnvs = numEnvs
+        self.port = port
+        self.startSim = startSim
+        self.simSeed = simSeed
+        self.simArgs = dict(simArgs)
+        if actionLag:
+            self.simArgs["--OpenGymInterface::ActionLag"] = "true"
+        self.debug = debug
+        self.envStopped = False
+
+        context = zmq.Context()
+        self.socket = context.socket(zmq.ROUTER)
+        try:
+            if port == 0 and self.startSim:
+                port = self.socket.bind_to_random_port('tcp://*', min_port=5001, max_port=10000, max_tries=100)
+                print("Got new port for ns3gm interface: ", port)
+                self.port = port
+
+            elif port == 0 and not self.startSim:
+                print("Cannot use port %s to bind" % str(port) )
+                print("Please specify correct port" )
+                sys.exit()
+
+            else:
+                self.socket.bind ("tcp://*:%s" % str(port))
+
+        except Exception as e:
+            print("Cannot bind to tcp://*:%s as port is already in use" % str(port) )
+            print("Please specify different port or use 0 to get free port" )
+            sys.exit()
+
+        if (startSim == True and simSeed == 0):
+            maxSeed = np.iinfo(np.uint32).max - numEnvs
+            simSeed = np.random.randint(0, maxSeed)
+            self.simSeed = simSeed
+
+        self._action_space = None
+        self._observation_space = None
+
+        # per env slot state, indexed by envId
+        self.identities = [None] * numEnvs
+        self.episodes = [0] * numEnvs
+        self.ns3Processes = [None] * numEnvs
+        self.simPids = [None] * numEnvs
+        self.wafPids = [None] * numEnvs
+        self.envStates = [None] * numEnvs
+        self.envIds = {}
+        # envs waiting for the init msg of their (re)started process
+        self.pendingEnvIds = set()
+        # processes sent the close command, their late msgs are dropped
+        self.closedIdentities = set()
+        # the shared-memory transport is not used for vectorized envs
+        self.shm = None
+
+        for envId in range(numEnvs):
+            self.start_env(envId)
+
+    def start_env(self, envId):
+        simArgs = dict(self.simArgs)
+        simArgs["--openGymEnvId"] = envId
+        # every env and every restarted episode gets its own RNG run number
+        simSeed = self.simSeed + envId + self.episodes[envId] * self.numEnvs
+        self.identities[envId] = None
+        self.envStates[envId] = None
+        self.pendingEnvIds.add(envId)
+
+        if self.startSim:
+            self.ns3Processes[envId] = start_sim_script(self.port, simSeed, simArgs, self.debug)
+        else:
+            print("Waiting for simulation script with --openGymEnvId={} to connect on port: tcp://localhost:{}".format(envId, self.port))
+
+    def _stop_env(self, envId):
+        if self.ns3Processes[envId]:
+            self.ns3Processes[envId].kill()
+            self.ns3Processes[envId] = None
+        if self.simPids[envId]:
+            try:
+                os.kill(self.simPids[envId], signal.SIGTERM)
+            except OSError:
+                pass
+            self.simPids[envId] = None
+        if self.wafPids[envId]:
+            try:
+                os.kill(self.wafPids[envId], signal.SIGTERM)
+            except OSError:
+                pass
+            self.wafPids[envId] = None
+
+    def _send(self, envId, msg):
+        self.socket.send_multipart([self.identities[envId], b'', msg.SerializeToString()])
+
+    def _handle_init(self, identity, request):
+        simInitMsg = pb.SimInitMsg()
+        try:
+            simInitMsg.ParseFromString(request)
+        except Exception as e:
+            return False
+        envId = int(simInitMsg.envId)
+        if envId not in self.pendingEnvIds:
+            return False
+
+        self.pendingEnvIds.discard(envId)
+        self.identities[envId] = identity
+        self.envIds[identity] = envId
+        self.simPids[envId] = int(simInitMsg.simProcessId)
+        self.wafPids[envId] = int(simInitMsg.wafShellProcessId)
+        # all envs run the same scenario, the first one defines the spaces
+        if self._action_space is None:
+            self._action_space = self._create_space(simInitMsg.actSpace)
+            self._observation_space = self._create_space(simInitMsg.obsSpace)
+
+        reply = pb.SimInitAck()
+        reply.done = True
+        reply.stopSimReq = False
+        self._send(envId, reply)
+        return True
+
+    def _handle_state(self, envId, request):
+        envStateMsg = pb.EnvStateMsg()
+        envStateMsg.ParseFromString(request)
+
+        extraInfo = envStateMsg.info
+        if not extraInfo:
+            extraInfo = {}
+
+        self.envStates[envId] = (self._create_data(envStateMsg.obsData),
+                                 envStateMsg.reward,
+                                 envStateMsg.isGameOver,
+                                 extraInfo)
+
+    def rx_env_states(self, envIds):
+        # sim processes answer in any order, a (re)started one first sends its init msg
+        while any(self.envStates[envId] is None for envId in envIds):
+            identity, empty, request = self.socket.recv_multipart()
+            envId = self.envIds.get(identity)
+            if envId is not None and self.identities[envId] == identity:
+                self._handle_state(envId, request)
+            elif identity in self.closedIdentities or not self._handle_init(identity, request):
+                # a late msg of a closed process, or garbage
+                if self.debug:
+                    print("Dropped a msg from an unknown sim process")
+
+    def initialize_env(self, stepInterval):
+        self.rx_env_states(range(self.numEnvs))
+        return True
+
+    def send_close_command(self, envId):
+        reply = pb.EnvActMsg()
+        reply.stopSimReq = True
+        self._send(envId, reply)
+        self.envStates[envId] = None
+        self.envIds.pop(self.identities[envId], None)
+        self.closedIdentities.add(self.identities[envId])
+        return True
+
+    def send_actions(self, envId, actions):
+        reply = pb.EnvActMsg()
+
+        actionMsg = self._pack_data(actions, self._action_space)
+        reply.actData.CopyFrom(actionMsg)
+        reply.stopSimReq = False
+
+        self._send(envId, reply)
+        self.envStates[envId] = None
+        return True
+
+    def reset_env(self, envId):
+        self.send_close_command(envId)
+        self._stop_env(envId)
+        self.episodes[envId] += 1
+        self.start_env(envId)
+
+    def step(self, actions):
+        envIds = range(self.numEnvs)
+        for envId in envIds:
+            self.send_actions(envId, actions[envId])
+        self.rx_env_states(envIds)
+
+        states = list(self.envStates)
+        terminalObs = [None] * self.numEnvs
+        doneEnvIds = [envId for envId in envIds if states[envId][2]]
+        for envId in doneEnvIds:
+            terminalObs[envId] = states[envId][0]
+            self.reset_env(envId)
+        # start episodes of finished envs at once, then wait for their first state
+        if doneEnvIds:
+            self.rx_env_states(doneEnvIds)
+            for envId in doneEnvIds:
+                obs = self.envStates[envId][0]
+                states[envId] = (obs,) + states[envId][1:]
+
+        return states, terminalObs
+
+    def get_states(self):
+        return list(self.envStates)
+
+    def close(self):
+        if self.envStopped:
+            return
+        self.envStopped = True
+        for envId in range(self.numEnvs):
+            try:
+                if self.envStates[envId] is not None:
+                    self.send_close_command(envId)
+            except Exception as e:
+                pass
+            self._stop_env(envId)
+
+
+class Ns3VecEnv(object):
+    """Steps numEnvs ns-3 simulations in lockstep and returns stacked batches.
+
+    All simulations run the same scenario script and connect to a single agent
+    port; each one must instantiate OpenGymVecInterface with the env id passed
+    via --openGymEnvId. Envs whose episode ended are restarted automatically,
+    the last observation of the finished episode is returned in
+    info["terminal_observation"].
+    """
+    def __init__(self, numEnvs, stepTime=0, port=0, startSim=True, simSeed=0, simArgs={}, debug=False, actionLag=False):
+        self.num_envs = numEnvs
+        self.stepTime = stepTime
+        self.port = port
+        self.startSim = startSim
+        self.simSeed = simSeed
+        self.simArgs = simArgs
+        self.debug = debug
+
+        self.ns3ZmqBridge = Ns3VecZmqBridge(numEnvs, self.port, self.startSim, self.simSeed, self.simArgs, self.debug, actionLag)
+        self.ns3ZmqBridge.initialize_env(self.stepTime)
+        # spaces of a single env
+        self.action_space = self.ns3ZmqBridge.get_action_space()
+        self.observation_space = self.ns3ZmqBridge.get_observation_space()
+
+    def _stack(self, data):
+        if isinstance(self.observation_space, (spaces.Box, spaces.Discrete)):
+            return np.stack([np.asarray(d) for d in data])
+        return list(data)
+
+    def reset(self):
+        states = self.ns3ZmqBridge.get_states()
+        return self._stack([state[0] for state in states])
+
+    def step(self, actions):
+        states, terminalObs = self.ns3ZmqBridge.step(actions)
+
+        obs = self._stack([state[0] for state in states])
+        rewards = np.array([state[1] for state in states], dtype=np.float32)
+        dones = np.array([state[2] for state in states], dtype=np.bool_)
+        infos = []
+        for state, termObs in zip(states, terminalObs):
+            info = {"info": state[3]}
+            if termObs is not None:
+                info["terminal_observation"] = termObs
+            infos.append(info)
+
+        return obs, rewards, dones, infos
+
+    def get_random_action(self):
+        return [self.action_space.sample() for _ in range(self.num_envs)]
+
+    def close(self):
+        if self.ns3ZmqBridge:
+            self.ns3ZmqBridge.close()
+            self.ns3ZmqBridge = None
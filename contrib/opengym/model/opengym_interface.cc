@@ -20,11 +20,27 @@
  */
 
 #include <sys/types.h>
+#include <sys/wait.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <iostream>
 #include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#include <signal.h>
+#endif
 #include "ns3/log.h"
+#include "ns3/abort.h"
 #include "ns3/config.h"
 #include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/random-variable-stream.h"
 #include "opengym_interface.h"
+#include "opengym_shm.h"
 #include "opengym_env.h"
 #include "container.h"
 #include "spaces.h"
@@ -44,6 +60,44 @@ OpenGymInterface::GetTypeId (void)
     .SetParent<Object> ()
     .SetGroupName ("OpenGym")
     .AddConstructor<OpenGymInterface> ()
+    .AddAttribute ("ActionLag",
+                   "If true, NotifyCurrentState returns right after sending the state and "
+                   "the actions for it are applied at the next NotifyCurrentState, so the "
+                   "agent computes while the simulation advances by one step.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&OpenGymInterface::m_actionLag),
+                   MakeBooleanChecker ())
+    .AddAttribute ("ForkReset",
+                   "If true, the simulation is forked at the first NotifyCurrentState (or at an "
+                   "explicit ForkEpisodes call) and every episode runs in a fresh child process "
+                   "with the next RNG run number, so an agent reset does not rebuild the scenario.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&OpenGymInterface::SetForkReset,
+                                        &OpenGymInterface::GetForkReset),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Transport",
+                   "Transport used for env state and actions after the init handshake. "
+                   "Shm places Box data in a POSIX shared-memory ring the agent maps without copy.",
+                   EnumValue (ZMQ_TRANSPORT),
+                   MakeEnumAccessor (&OpenGymInterface::m_transport),
+                   MakeEnumChecker (ZMQ_TRANSPORT, "Zmq",
+                                    SHM_TRANSPORT, "Shm"))
+    .AddAttribute ("ShmSlots",
+                   "Number of data slots in the shared-memory ring; "
+                   "agent side views of an observation stay valid for that many steps.",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&OpenGymInterface::m_shmSlots),
+                   MakeUintegerChecker<uint32_t> (2))
+    .AddAttribute ("ShmSlotSize",
+                   "Size in bytes of a shared-memory data slot, i.e. of all Box data of one step",
+                   UintegerValue (8 * 1024 * 1024),
+                   MakeUintegerAccessor (&OpenGymInterface::m_shmSlotSize),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("ShmMsgSize",
+                   "Size in bytes of the shared-memory areas holding the serialized state and action messages",
+                   UintegerValue (1024 * 1024),
+                   MakeUintegerAccessor (&OpenGymInterface::m_shmMsgSize),
+                   MakeUintegerChecker<uint64_t> ())
     ;
   return tid;
 }
@@ -52,34 +106,14 @@ Ptr<OpenGymInterface>
 OpenGymInterface::Get (uint32_t port)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  return *DoGet (port);
-}
-
-Ptr<OpenGymInterface> *
-OpenGymInterface::DoGet (uint32_t port)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-  static Ptr<OpenGymInterface> ptr = 0;
-  if (ptr == 0)
-    {
-      ptr = CreateObject<OpenGymInterface> (port);
-      Config::RegisterRootNamespaceObject (ptr);
-      Simulator::ScheduleDestroy (&OpenGymInterface::Delete);
-    }
-  return &ptr;
-}
-
-void
-OpenGymInterface::Delete (void)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-  Config::UnregisterRootNamespaceObject (Get ());
-  (*DoGet ()) = 0;
+  return GetSingleton<OpenGymInterface> (port);
 }
 
 OpenGymInterface::OpenGymInterface(uint32_t port):
-  m_port(port), m_zmq_context(1), m_zmq_socket(m_zmq_context, ZMQ_REQ),
-  m_simEnd(false), m_stopEnvRequested(false), m_initSimMsgSent(false)
+  m_port(port), m_zmq_context(0), m_zmq_socket(0),
+  m_transport(ZMQ_TRANSPORT), m_shmSlots(4), m_shmSlotSize(0), m_shmMsgSize(0),
+  m_simEnd(false), m_stopEnvRequested(false), m_initSimMsgSent(false),
+  m_actionLag(false), m_actionsPending(false), m_forkReset(false), m_forked(false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -87,12 +121,19 @@ OpenGymInterface::OpenGymInterface(uint32_t port):
 OpenGymInterface::~OpenGymInterface ()
 {
   NS_LOG_FUNCTION (this);
+  delete m_zmq_socket;
+  delete m_zmq_context;
 }
 
 void
 OpenGymInterface::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_shm)
+  {
+    m_shm->Dispose();
+    m_shm = 0;
+  }
 }
 
 void
@@ -158,10 +199,17 @@ OpenGymInterface::Init()
   if (m_initSimMsgSent) {
     return;
   }
+
+  // zmq context must not be created before the fork, its threads do not survive it
+  if (m_forkReset && !m_forked) {
+    ForkEpisodes();
+  }
   m_initSimMsgSent = true;
 
+  m_zmq_context = new zmq::context_t(1);
+  m_zmq_socket = new zmq::socket_t(*m_zmq_context, ZMQ_REQ);
   std::string connectAddr = "tcp://localhost:" + std::to_string(m_port);
-  zmq_connect ((void*)m_zmq_socket, connectAddr.c_str());
+  zmq_connect ((void*)*m_zmq_socket, connectAddr.c_str());
 
   Ptr<OpenGymSpace> obsSpace = GetObservationSpace();
   Ptr<OpenGymSpace> actionSpace = GetActionSpace();
@@ -173,6 +221,19 @@ OpenGymInterface::Init()
   ns3opengym::SimInitMsg simInitMsg;
   simInitMsg.set_simprocessid(::getpid());
   simInitMsg.set_wafshellprocessid(::getppid());
+  simInitMsg.set_envid(GetEnvId());
+
+  if (m_transport == SHM_TRANSPORT) {
+    std::string shmName = "/ns3gym-" + std::to_string(::getpid()) + "-" + std::to_string(m_port);
+    m_shm = CreateObject<OpenGymShmBuffer> ();
+    if (m_shm->Create(shmName, m_shmSlots, m_shmSlotSize, m_shmMsgSize)) {
+      simInitMsg.set_shmname(shmName);
+      NS_LOG_UNCOND("Using shared-memory transport: " << shmName);
+    } else {
+      NS_LOG_WARN("Cannot create shared-memory segment, falling back to ZMQ transport");
+      m_shm = 0;
+    }
+  }
 
   if (obsSpace) {
     ns3opengym::SpaceDescription spaceDesc;
@@ -189,12 +250,12 @@ OpenGymInterface::Init()
   // send init msg to python
   zmq::message_t request(simInitMsg.ByteSize());;
   simInitMsg.SerializeToArray(request.data(), simInitMsg.ByteSize());
-  m_zmq_socket.send (request);
+  m_zmq_socket->send (request);
 
   // receive init ack msg form python
   ns3opengym::SimInitAck simInitAck;
   zmq::message_t reply;
-  m_zmq_socket.recv (&reply);
+  m_zmq_socket->recv (&reply);
   simInitAck.ParseFromArray(reply.data(), reply.size());
 
   bool done = simInitAck.done();
@@ -204,12 +265,71 @@ OpenGymInterface::Init()
   if (stopSim) {
     NS_LOG_DEBUG("---Stop requested: " << stopSim);
     m_stopEnvRequested = true;
+    if (m_shm) {
+      m_shm->Dispose();
+    }
     Simulator::Stop();
     Simulator::Destroy ();
     std::exit(0);
   }
 }
 
+void
+OpenGymInterface::SetForkReset(bool forkReset)
+{
+  NS_LOG_FUNCTION (this << forkReset);
+  m_forkReset = forkReset;
+}
+
+bool
+OpenGymInterface::GetForkReset() const
+{
+  return m_forkReset;
+}
+
+void
+OpenGymInterface::ForkEpisodes()
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_forkReset || m_forked) {
+    return;
+  }
+  NS_ABORT_MSG_IF (m_initSimMsgSent, "ForkEpisodes has to be called before the first NotifyCurrentState");
+  m_forked = true;
+
+  uint64_t run = RngSeedManager::GetRun ();
+  NS_LOG_UNCOND("Simulation warmed up at " << Simulator::Now().GetSeconds() << "s, forking one process per episode");
+
+  for (uint64_t episode = 0; ; episode++) {
+    std::cout.flush();
+    std::fflush(stdout);
+    pid_t pid = ::fork();
+    NS_ABORT_MSG_IF (pid < 0, "fork failed: " << std::strerror(errno));
+
+    if (pid == 0) {
+#ifdef __linux__
+      // do not outlive the parent, it is the one the agent kills on close
+      prctl(PR_SET_PDEATHSIG, SIGTERM);
+      if (::getppid() == 1) {
+        std::exit(0);
+      }
+#endif
+      RngSeedManager::SetRun (run + episode);
+      RandomVariableStream::ReseedAll ();
+      NS_LOG_UNCOND("Episode " << episode << " with RNG run " << run + episode);
+      return;
+    }
+
+    int status = 0;
+    while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      NS_LOG_UNCOND("Episode process " << pid << " failed, stop forking");
+      std::exit(1);
+    }
+  }
+}
+
 void
 OpenGymInterface::NotifyCurrentState()
 {
@@ -223,6 +343,12 @@ OpenGymInterface::NotifyCurrentState()
     return;
   }
 
+  // apply the agent's answer to the previous state before collecting the new one
+  if (m_actionsPending) {
+    m_actionsPending = false;
+    ReceiveActions();
+  }
+
   // collect current env state
   Ptr<OpenGymDataContainer> obsDataContainer = GetObservation();
   float reward = GetReward();
@@ -233,7 +359,12 @@ OpenGymInterface::NotifyCurrentState()
   // observation
   ns3opengym::DataContainer obsDataContainerPbMsg;
   if (obsDataContainer) {
-    obsDataContainerPbMsg = obsDataContainer->GetDataContainerPbMsg();
+    if (m_shm) {
+      m_shm->BeginStep();
+      obsDataContainerPbMsg = obsDataContainer->GetShmDataContainerPbMsg(m_shm);
+    } else {
+      obsDataContainerPbMsg = obsDataContainer->GetDataContainerPbMsg();
+    }
     envStateMsg.mutable_obsdata()->CopyFrom(obsDataContainerPbMsg);
   }
   // reward
@@ -254,15 +385,26 @@ OpenGymInterface::NotifyCurrentState()
   envStateMsg.set_info(extraInfo);
 
   // send env state msg to python
-  zmq::message_t request(envStateMsg.ByteSize());;
-  envStateMsg.SerializeToArray(request.data(), envStateMsg.ByteSize());
-  m_zmq_socket.send (request);
+  SendStateMsg (envStateMsg.SerializeAsString());
+
+  // action lag: keep simulating, the actions are applied at the next step
+  if (m_actionLag && !isGameOver) {
+    m_actionsPending = true;
+    return;
+  }
+
+  ReceiveActions();
+}
+
+void
+OpenGymInterface::ReceiveActions()
+{
+  NS_LOG_FUNCTION (this);
 
   // receive act msg form python
   ns3opengym::EnvActMsg envActMsg;
-  zmq::message_t reply;
-  m_zmq_socket.recv (&reply);
-  envActMsg.ParseFromArray(reply.data(), reply.size());
+  std::string reply = ReceiveActMsg ();
+  envActMsg.ParseFromString(reply);
 
   if (m_simEnd) {
     // if sim end only rx ms and quit
@@ -273,6 +415,9 @@ OpenGymInterface::NotifyCurrentState()
   if (stopSim) {
     NS_LOG_DEBUG("---Stop requested: " << stopSim);
     m_stopEnvRequested = true;
+    if (m_shm) {
+      m_shm->Dispose();
+    }
     Simulator::Stop();
     Simulator::Destroy ();
     std::exit(0);
@@ -282,7 +427,31 @@ OpenGymInterface::NotifyCurrentState()
   ns3opengym::DataContainer actDataContainerPbMsg = envActMsg.actdata();
   Ptr<OpenGymDataContainer> actDataContainer = OpenGymDataContainer::CreateFromDataContainerPbMsg(actDataContainerPbMsg);
   ExecuteActions(actDataContainer);
+}
 
+void
+OpenGymInterface::SendStateMsg (const std::string &msg)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_shm) {
+    m_shm->SendState(msg);
+    return;
+  }
+  zmq::message_t request(msg.size());
+  std::memcpy(request.data(), msg.data(), msg.size());
+  m_zmq_socket->send (request);
+}
+
+std::string
+OpenGymInterface::ReceiveActMsg ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_shm) {
+    return m_shm->ReceiveAct();
+  }
+  zmq::message_t reply;
+  m_zmq_socket->recv (&reply);
+  return std::string(static_cast<char*>(reply.data()), reply.size());
 }
 
 void
@@ -387,6 +556,13 @@ OpenGymInterface::ExecuteActions(Ptr<OpenGymDataContainer> action)
   return reply;
 }
 
+uint32_t
+OpenGymInterface::GetEnvId()
+{
+  NS_LOG_FUNCTION (this);
+  return 0;
+}
+
 void
 OpenGymInterface::Notify(Ptr<OpenGymEnv> entity)
 {
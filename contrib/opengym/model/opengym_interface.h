@@ -23,6 +23,8 @@
 #define OPENGYM_INTERFACE_H
 
 #include "ns3/object.h"
+#include "ns3/config.h"
+#include "ns3/simulator.h"
 #include <zmq.hpp>
 
 namespace ns3 {
@@ -30,10 +32,17 @@ namespace ns3 {
 class OpenGymSpace;
 class OpenGymDataContainer;
 class OpenGymEnv;
+class OpenGymShmBuffer;
 
 class OpenGymInterface : public Object
 {
 public:
+  enum Transport
+  {
+    ZMQ_TRANSPORT,
+    SHM_TRANSPORT
+  };
+
   static Ptr<OpenGymInterface> Get (uint32_t port=5555);
 
   OpenGymInterface (uint32_t port=5555);
@@ -42,6 +51,8 @@ public:
   static TypeId GetTypeId ();
 
   void Init();
+  // with ForkReset, run one episode per forked child from this point on
+  void ForkEpisodes();
   void NotifyCurrentState();
   void WaitForStop();
 
@@ -65,22 +76,51 @@ public:
 
   void Notify(Ptr<OpenGymEnv> entity);
 
+  virtual uint32_t GetEnvId();
+
 protected:
   // Inherited
   virtual void DoInitialize (void);
   virtual void DoDispose (void);
 
+  /**
+   * \return the instance of T built with these constructor arguments at
+   * the first call, registered as a root namespace object until the
+   * simulator is destroyed
+   */
+  template <typename T, typename... Args>
+  static Ptr<T> GetSingleton (Args... args);
+
 private:
-  static Ptr<OpenGymInterface> *DoGet (uint32_t port=5555);
-  static void Delete (void);
+  template <typename T>
+  static Ptr<T> &GetSingletonPointer (void);
+  template <typename T>
+  static void DeleteSingleton (void);
+
+  void SendStateMsg (const std::string &msg);
+  std::string ReceiveActMsg ();
+  void ReceiveActions();
+  void SetForkReset(bool forkReset);
+  bool GetForkReset() const;
 
   uint32_t m_port;
-  zmq::context_t m_zmq_context;
-  zmq::socket_t m_zmq_socket;
+  // created in Init, i.e. after a fork
+  zmq::context_t *m_zmq_context;
+  zmq::socket_t *m_zmq_socket;
+
+  Transport m_transport;
+  uint32_t m_shmSlots;
+  uint64_t m_shmSlotSize;
+  uint64_t m_shmMsgSize;
+  Ptr<OpenGymShmBuffer> m_shm;
 
   bool m_simEnd;
   bool m_stopEnvRequested;
   bool m_initSimMsgSent;
+  bool m_actionLag;
+  bool m_actionsPending;
+  bool m_forkReset;
+  bool m_forked;
 
   Callback< Ptr<OpenGymSpace> > m_actionSpaceCb;
   Callback< Ptr<OpenGymSpace> > m_observationSpaceCb;
@@ -91,6 +131,37 @@ private:
   Callback<bool, Ptr<OpenGymDataContainer> > m_actionCb;
 };
 
+template <typename T, typename... Args>
+Ptr<T>
+OpenGymInterface::GetSingleton (Args... args)
+{
+  Ptr<T> &ptr = GetSingletonPointer<T> ();
+  if (ptr == 0)
+    {
+      ptr = CreateObject<T> (args...);
+      Config::RegisterRootNamespaceObject (ptr);
+      Simulator::ScheduleDestroy (&OpenGymInterface::DeleteSingleton<T>);
+    }
+  return ptr;
+}
+
+template <typename T>
+Ptr<T> &
+OpenGymInterface::GetSingletonPointer (void)
+{
+  static Ptr<T> ptr = 0;
+  return ptr;
+}
+
+template <typename T>
+void
+OpenGymInterface::DeleteSingleton (void)
+{
+  Ptr<T> &ptr = GetSingletonPointer<T> ();
+  Config::UnregisterRootNamespaceObject (ptr);
+  ptr = 0;
+}
+
 } // end of namespace ns3
 
 #endif /* OPENGYM_INTERFACE_H */
@@ -0,0 +1,209 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+#include "opengym_shm.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("OpenGymShmBuffer");
+
+NS_OBJECT_ENSURE_REGISTERED (OpenGymShmBuffer);
+
+static_assert (sizeof (sem_t) <= 32, "sem_t does not fit the shm header layout");
+static_assert (sizeof (OpenGymShmHeader) == 192, "unexpected shm header layout");
+
+static uint64_t
+AlignUp (uint64_t value)
+{
+  const uint64_t alignment = 64;
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+TypeId
+OpenGymShmBuffer::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::OpenGymShmBuffer")
+    .SetParent<Object> ()
+    .SetGroupName ("OpenGym")
+    .AddConstructor<OpenGymShmBuffer> ()
+    ;
+  return tid;
+}
+
+OpenGymShmBuffer::OpenGymShmBuffer ()
+  : m_base (0),
+    m_size (0),
+    m_header (0),
+    m_slot (0),
+    m_slotUsed (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+OpenGymShmBuffer::~OpenGymShmBuffer ()
+{
+  NS_LOG_FUNCTION (this);
+  Destroy ();
+}
+
+void
+OpenGymShmBuffer::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Destroy ();
+}
+
+bool
+OpenGymShmBuffer::Create (std::string name, uint32_t nSlots, uint64_t slotSize, uint64_t msgSize)
+{
+  NS_LOG_FUNCTION (this << name << nSlots << slotSize << msgSize);
+  NS_ASSERT (m_base == 0);
+  NS_ASSERT (nSlots > 0);
+
+  uint64_t stateMsgOffset = AlignUp (sizeof (OpenGymShmHeader));
+  uint64_t actMsgOffset = stateMsgOffset + AlignUp (msgSize);
+  uint64_t slotsOffset = actMsgOffset + AlignUp (msgSize);
+  slotSize = AlignUp (slotSize);
+  uint64_t size = slotsOffset + nSlots * slotSize;
+
+  int fd = shm_open (name.c_str (), O_CREAT | O_RDWR | O_TRUNC, 0600);
+  if (fd < 0)
+    {
+      NS_LOG_WARN ("shm_open " << name << " failed: " << std::strerror (errno));
+      return false;
+    }
+  if (ftruncate (fd, size) != 0)
+    {
+      NS_LOG_WARN ("ftruncate " << name << " failed: " << std::strerror (errno));
+      close (fd);
+      shm_unlink (name.c_str ());
+      return false;
+    }
+  void *base = mmap (0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (base == MAP_FAILED)
+    {
+      NS_LOG_WARN ("mmap " << name << " failed: " << std::strerror (errno));
+      shm_unlink (name.c_str ());
+      return false;
+    }
+
+  m_name = name;
+  m_base = static_cast<uint8_t*> (base);
+  m_size = size;
+  m_header = reinterpret_cast<OpenGymShmHeader*> (m_base);
+
+  m_header->nSlots = nSlots;
+  m_header->slotSize = slotSize;
+  m_header->msgSize = msgSize;
+  m_header->stateMsgOffset = stateMsgOffset;
+  m_header->actMsgOffset = actMsgOffset;
+  m_header->slotsOffset = slotsOffset;
+  m_header->stateLen = 0;
+  m_header->actLen = 0;
+  sem_init (&m_header->stateReady.sem, 1, 0);
+  sem_init (&m_header->actReady.sem, 1, 0);
+  m_header->version = VERSION;
+  // written last, the agent checks it before using the segment
+  m_header->magic = MAGIC;
+
+  m_slot = nSlots - 1;
+  m_slotUsed = 0;
+  return true;
+}
+
+std::string
+OpenGymShmBuffer::GetName ()
+{
+  return m_name;
+}
+
+void
+OpenGymShmBuffer::BeginStep ()
+{
+  NS_LOG_FUNCTION (this);
+  m_slot = (m_slot + 1) % m_header->nSlots;
+  m_slotUsed = 0;
+}
+
+uint8_t*
+OpenGymShmBuffer::Allocate (uint64_t size, uint64_t &offset)
+{
+  NS_LOG_FUNCTION (this << size);
+  if (m_slotUsed + size > m_header->slotSize)
+    {
+      NS_LOG_WARN ("Data of " << size << " bytes does not fit into shm slot of " << m_header->slotSize << " bytes");
+      return 0;
+    }
+  offset = m_header->slotsOffset + m_slot * m_header->slotSize + m_slotUsed;
+  m_slotUsed = AlignUp (m_slotUsed + size);
+  return m_base + offset;
+}
+
+void
+OpenGymShmBuffer::SendState (const std::string &msg)
+{
+  NS_LOG_FUNCTION (this);
+  if (msg.size () > m_header->msgSize)
+    {
+      NS_FATAL_ERROR ("EnvStateMsg of " << msg.size () << " bytes exceeds shm message area of "
+                      << m_header->msgSize << " bytes, increase OpenGymInterface::ShmMsgSize");
+    }
+  std::memcpy (m_base + m_header->stateMsgOffset, msg.data (), msg.size ());
+  m_header->stateLen = msg.size ();
+  sem_post (&m_header->stateReady.sem);
+}
+
+std::string
+OpenGymShmBuffer::ReceiveAct ()
+{
+  NS_LOG_FUNCTION (this);
+  while (sem_wait (&m_header->actReady.sem) != 0)
+    {
+      if (errno != EINTR)
+        {
+          NS_FATAL_ERROR ("sem_wait on shm " << m_name << " failed: " << std::strerror (errno));
+        }
+    }
+  uint64_t len = std::min (m_header->actLen, m_header->msgSize);
+  return std::string (reinterpret_cast<char*> (m_base + m_header->actMsgOffset), len);
+}
+
+void
+OpenGymShmBuffer::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_base == 0)
+    {
+      return;
+    }
+  sem_destroy (&m_header->stateReady.sem);
+  sem_destroy (&m_header->actReady.sem);
+  munmap (m_base, m_size);
+  shm_unlink (m_name.c_str ());
+  m_base = 0;
+  m_header = 0;
+}
+
+}
@@ -0,0 +1,104 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef OPENGYM_SHM_H
+#define OPENGYM_SHM_H
+
+#include <semaphore.h>
+#include "ns3/object.h"
+
+namespace ns3 {
+
+/**
+ * Fixed header at the start of the shared-memory segment. The layout is
+ * mirrored in ns3gym/ns3env.py (Ns3ShmChannel), keep both in sync.
+ */
+struct OpenGymShmHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t nSlots;
+  uint32_t reserved;
+  uint64_t slotSize;
+  uint64_t msgSize;
+  uint64_t stateMsgOffset;
+  uint64_t actMsgOffset;
+  uint64_t slotsOffset;
+  uint64_t stateLen;
+  uint64_t actLen;
+  uint8_t padding[56];
+  union
+  {
+    sem_t sem;
+    uint8_t raw[32];
+  } stateReady;      //!< posted by the simulation when a new EnvStateMsg is available (offset 128)
+  union
+  {
+    sem_t sem;
+    uint8_t raw[32];
+  } actReady;        //!< posted by the agent when a new EnvActMsg is available (offset 160)
+};
+
+/**
+ * POSIX shared-memory transport between the simulation and the Gym agent.
+ *
+ * The segment holds one area for the serialized EnvStateMsg, one for the
+ * serialized EnvActMsg and a ring of data slots. Box observation data is
+ * copied once into the slot of the current step and only referenced by
+ * offset from the state message, so the agent can wrap it in a numpy array
+ * without a copy. Slot k is rewritten nSlots steps later, which bounds how
+ * long such views stay valid. Both sides hand over with process-shared
+ * semaphores living inside the header.
+ */
+class OpenGymShmBuffer : public Object
+{
+public:
+  static const uint32_t MAGIC = 0x6e733367;  // "ns3g"
+  static const uint32_t VERSION = 1;
+
+  OpenGymShmBuffer ();
+  virtual ~OpenGymShmBuffer ();
+
+  static TypeId GetTypeId ();
+
+  bool Create (std::string name, uint32_t nSlots, uint64_t slotSize, uint64_t msgSize);
+  std::string GetName ();
+
+  void BeginStep ();
+  uint8_t* Allocate (uint64_t size, uint64_t &offset);
+
+  void SendState (const std::string &msg);
+  std::string ReceiveAct ();
+
+protected:
+  // Inherited
+  virtual void DoDispose (void);
+
+private:
+  void Destroy ();
+
+  std::string m_name;
+  uint8_t *m_base;
+  uint64_t m_size;
+  OpenGymShmHeader *m_header;
+  uint32_t m_slot;
+  uint64_t m_slotUsed;
+};
+
+} // end of namespace ns3
+
+#endif /* OPENGYM_SHM_H */
+
@@ -0,0 +1,63 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "opengym_vec_interface.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("OpenGymVecInterface");
+
+NS_OBJECT_ENSURE_REGISTERED (OpenGymVecInterface);
+
+
+TypeId
+OpenGymVecInterface::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("OpenGymVecInterface")
+    .SetParent<OpenGymInterface> ()
+    .SetGroupName ("OpenGym")
+    .AddConstructor<OpenGymVecInterface> ()
+    ;
+  return tid;
+}
+
+Ptr<OpenGymVecInterface>
+OpenGymVecInterface::Get (uint32_t port, uint32_t envId)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return GetSingleton<OpenGymVecInterface> (port, envId);
+}
+
+OpenGymVecInterface::OpenGymVecInterface(uint32_t port, uint32_t envId):
+  OpenGymInterface(port), m_envId(envId)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+OpenGymVecInterface::~OpenGymVecInterface ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+OpenGymVecInterface::GetEnvId()
+{
+  NS_LOG_FUNCTION (this);
+  return m_envId;
+}
+
+}
@@ -0,0 +1,50 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef OPENGYM_VEC_INTERFACE_H
+#define OPENGYM_VEC_INTERFACE_H
+
+#include "opengym_interface.h"
+
+namespace ns3 {
+
+/**
+ * OpenGym interface of a single simulation that is one of K environments
+ * served by a vectorized agent (ns3gym Ns3VecEnv). All K simulation
+ * processes connect to the same agent port; the env id announced in the
+ * SimInitMsg tells the agent in which slot of the stacked
+ * observation/reward/done batch this simulation belongs.
+ */
+class OpenGymVecInterface : public OpenGymInterface
+{
+public:
+  static Ptr<OpenGymVecInterface> Get (uint32_t port=5555, uint32_t envId=0);
+
+  OpenGymVecInterface (uint32_t port=5555, uint32_t envId=0);
+  virtual ~OpenGymVecInterface ();
+
+  static TypeId GetTypeId ();
+
+  virtual uint32_t GetEnvId();
+
+private:
+  uint32_t m_envId;
+};
+
+} // end of namespace ns3
+
+#endif /* OPENGYM_VEC_INTERFACE_H */
+
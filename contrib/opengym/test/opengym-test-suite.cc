@@ -46,6 +46,126 @@ OpengymTestCase1::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+/**
+ * Check that Box data survives the packed encoding in both directions:
+ * containers packed by the simulation, including float16 packing, and
+ * actions packed by the agent as ns3env.py does it.
+ */
+class OpengymBoxPackingTestCase : public TestCase
+{
+public:
+  OpengymBoxPackingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Pack a container of T, decode the message and compare.
+   * \param values the data
+   */
+  template <typename T>
+  void CheckRoundTrip (std::vector<T> values);
+  /**
+   * Build an action message the way the agent does and decode it.
+   * \param dtype the dtype of the action space
+   * \param elemType the numpy name of T
+   * \param values the data
+   */
+  template <typename T>
+  void CheckAgentAction (ns3opengym::Dtype dtype, std::string elemType, std::vector<T> values);
+  /**
+   * Compare a decoded container with the expected data.
+   * \param container the decoded container
+   * \param values the expected data
+   */
+  template <typename T>
+  void CheckData (Ptr<OpenGymDataContainer> container, std::vector<T> values);
+};
+
+OpengymBoxPackingTestCase::OpengymBoxPackingTestCase ()
+  : TestCase ("Check the packed Box data encoding")
+{
+}
+
+template <typename T>
+void
+OpengymBoxPackingTestCase::CheckData (Ptr<OpenGymDataContainer> container, std::vector<T> values)
+{
+  Ptr<OpenGymBoxContainer<T> > box = DynamicCast<OpenGymBoxContainer<T> > (container);
+  NS_TEST_ASSERT_MSG_NE (box, 0, "decoded with the wrong element type, expected " << OpenGymElemType (T ()));
+  std::vector<uint32_t> shape = box->GetShape ();
+  NS_TEST_ASSERT_MSG_EQ (shape.size (), 1, "wrong shape");
+  NS_TEST_ASSERT_MSG_EQ (shape[0], values.size (), "wrong shape");
+  NS_TEST_ASSERT_MSG_EQ (box->GetData ().size (), values.size (), "wrong data size");
+  for (uint32_t i = 0; i < values.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (box->GetValue (i), values[i], "wrong value " << i << " of " << OpenGymElemType (T ()));
+    }
+}
+
+template <typename T>
+void
+OpengymBoxPackingTestCase::CheckRoundTrip (std::vector<T> values)
+{
+  std::vector<uint32_t> shape (1, values.size ());
+  Ptr<OpenGymBoxContainer<T> > box = CreateObject<OpenGymBoxContainer<T> > (shape);
+  box->SetData (values);
+  ns3opengym::DataContainer msg = box->GetDataContainerPbMsg ();
+  ns3opengym::BoxDataContainer boxMsg;
+  msg.data ().UnpackTo (&boxMsg);
+  NS_TEST_EXPECT_MSG_EQ (boxMsg.elemtype (), OpenGymElemType (T ()), "wrong element type name");
+  NS_TEST_EXPECT_MSG_EQ (boxMsg.rawdata ().size (), values.size () * sizeof (T), "data not packed");
+  CheckData (OpenGymDataContainer::CreateFromDataContainerPbMsg (msg), values);
+}
+
+template <typename T>
+void
+OpengymBoxPackingTestCase::CheckAgentAction (ns3opengym::Dtype dtype, std::string elemType, std::vector<T> values)
+{
+  ns3opengym::BoxDataContainer boxMsg;
+  boxMsg.set_dtype (dtype);
+  boxMsg.add_shape (values.size ());
+  boxMsg.set_elemtype (elemType);
+  boxMsg.set_rawdata (std::string (reinterpret_cast<const char *> (values.data ()), values.size () * sizeof (T)));
+  ns3opengym::DataContainer msg;
+  msg.set_type (ns3opengym::Box);
+  msg.mutable_data ()->PackFrom (boxMsg);
+  CheckData (OpenGymDataContainer::CreateFromDataContainerPbMsg (msg), values);
+}
+
+void
+OpengymBoxPackingTestCase::DoRun (void)
+{
+  CheckRoundTrip<int8_t> ({-128, 0, 127});
+  CheckRoundTrip<int16_t> ({-32768, 1, 32767});
+  CheckRoundTrip<int32_t> ({-2147483647, 2, 2147483647});
+  CheckRoundTrip<int64_t> ({-(int64_t (1) << 62), 3, int64_t (1) << 62});
+  CheckRoundTrip<uint8_t> ({0, 4, 255});
+  CheckRoundTrip<uint16_t> ({0, 5, 65535});
+  CheckRoundTrip<uint32_t> ({0, 6, 4294967295u});
+  CheckRoundTrip<uint64_t> ({0, 7, uint64_t (1) << 63});
+  CheckRoundTrip<float> ({-1.5f, 0.1f, 3e38f});
+  CheckRoundTrip<double> ({-1.5, 0.1, 1e300});
+
+  // values exactly representable as half precision come back unchanged
+  std::vector<float> halfValues = {-2.0f, 0.5f, 1024.0f, 0.0f};
+  Ptr<OpenGymBoxContainer<float> > half = CreateObject<OpenGymBoxContainer<float> > (std::vector<uint32_t> (1, halfValues.size ()));
+  half->SetFloat16Packing (true);
+  half->SetData (halfValues);
+  ns3opengym::DataContainer halfMsg = half->GetDataContainerPbMsg ();
+  ns3opengym::BoxDataContainer halfBoxMsg;
+  halfMsg.data ().UnpackTo (&halfBoxMsg);
+  NS_TEST_EXPECT_MSG_EQ (halfBoxMsg.elemtype (), "float16", "float16 packing not used");
+  NS_TEST_EXPECT_MSG_EQ (halfBoxMsg.rawdata ().size (), halfValues.size () * 2, "float16 packing not used");
+  CheckData (OpenGymDataContainer::CreateFromDataContainerPbMsg (halfMsg), halfValues);
+
+  // the element types ns3env.py packs actions in, per action space dtype
+  CheckAgentAction<int32_t> (ns3opengym::INT, "int32", {-7, 0, 7});
+  CheckAgentAction<uint32_t> (ns3opengym::UINT, "uint32", {0, 8, 4000000000u});
+  CheckAgentAction<float> (ns3opengym::FLOAT, "float32", {-0.25f, 9.5f});
+  CheckAgentAction<double> (ns3opengym::DOUBLE, "float64", {-0.25, 1e-300});
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -61,6 +181,7 @@ OpengymTestSuite::OpengymTestSuite ()
 {
   // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
   AddTestCase (new OpengymTestCase1, TestCase::QUICK);
+  AddTestCase (new OpengymBoxPackingTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
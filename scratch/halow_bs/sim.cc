@@ -24,6 +24,8 @@
 #include "ns3/pointer.h"
 #include "ns3/config.h"
 #include "ns3/rng-seed-manager.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/system-mutex.h"
 #include "sim.h"
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -38,6 +40,9 @@
 #include "ns3/udp-client-server-helper.h"
 #include "ns3/wifi-mac-queue.h"
 #include "ns3/yans-wifi-helper.h"
+#include "ns3/cached-propagation-model.h"
+#include "ns3/tabulated-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // ns3 models
@@ -60,6 +65,8 @@ NS_LOG_COMPONENT_DEFINE ("halow_bs");
 
 static std::map <Mac48Address, double> saturated_times, assoc_times;
 static std::map <Mac48Address, int> assoc_indices;
+// the stations call the association sinks from their own threads with ns3::MultiThreadedSimulatorImpl
+static SystemMutex assoc_mutex;
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -135,6 +142,7 @@ PopulateArpCache ()
 static void
 nonSaturatedAssoc (Mac48Address address)
 {
+  CriticalSection cs (assoc_mutex);
 	//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 	// Verify if the address was associated yet
   if (assoc_times.find(address) != assoc_times.end())
@@ -148,7 +156,7 @@ nonSaturatedAssoc (Mac48Address address)
   if (assoc_times.size () == Nsta)
     {      
       std::ofstream results;
-      results.open ("fa_data/simulationTime.dat", std::ofstream::out | std::ofstream::app);
+      results.open ((outputDir + "/simulationTime.dat").c_str (), std::ofstream::out | std::ofstream::app);
       if (results.is_open()){results << Nsta << "," << Nsaturated << ","
 																		 << Simulator::Now().GetSeconds() - initialTimeNewStations  << ","
 																		 << Simulator::Now().GetSeconds() << "," 
@@ -241,6 +249,7 @@ CreateAssociatingStas(void)
 static void
 saturatedAssoc (Mac48Address address)
 {
+  CriticalSection cs (assoc_mutex);
   if (saturated_times.find(address) != saturated_times.end())
     {
       std::cerr << "Double association from " << address << std::endl;
@@ -338,6 +347,10 @@ int main (int argc, char *argv[])
   cmd.AddValue ("frameCapture", "enable frame capture", dataCapture);
   cmd.AddValue ("preambleCapture", "enable preamble capture", preambleCapture);
   cmd.AddValue ("SinrDiffCapture", "Sinr Diff for packet capture (dB)", sinrDiffCapture);
+  cmd.AddValue ("policyFile", "exported policy weights evaluated in-process (algorithm 100/101)", policyFile);
+  cmd.AddValue ("outputDir", "existing directory for simulationTime.dat and the per-beacon fa_*.dat", outputDir);
+  cmd.AddValue ("cachePropagation", "compute the loss and the delay once per pair of fixed nodes", cachePropagation);
+  cmd.AddValue ("tabulateErrorRate", "interpolate the error rate from tables computed once per mode", tabulateErrorRate);
   cmd.Parse (argc,argv);
   //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
   // Log for OpenGym interface
@@ -367,8 +380,29 @@ int main (int argc, char *argv[])
   //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
   // Configure physical layer
   experiment->phy = YansWifiPhyHelper::Default ();
-  experiment->phy.SetErrorRateModel ("ns3::YansErrorRateModel");
-  experiment->phy.SetChannel (experiment->channel.Create ());
+  if (tabulateErrorRate)
+    {
+      experiment->phy.SetErrorRateModel ("ns3::TabulatedErrorRateModel",
+                                         "Model", PointerValue (CreateObject<YansErrorRateModel> ()));
+    }
+  else
+    {
+      experiment->phy.SetErrorRateModel ("ns3::YansErrorRateModel");
+    }
+  Ptr<YansWifiChannel> channel = experiment->channel.Create ();
+  if (cachePropagation)
+    {
+      PointerValue model;
+      channel->GetAttribute ("PropagationLossModel", model);
+      Ptr<CachedPropagationLossModel> loss = CreateObject<CachedPropagationLossModel> ();
+      loss->SetModel (model.Get<PropagationLossModel> ());
+      channel->SetPropagationLossModel (loss);
+      channel->GetAttribute ("PropagationDelayModel", model);
+      Ptr<CachedPropagationDelayModel> delay = CreateObject<CachedPropagationDelayModel> ();
+      delay->SetModel (model.Get<PropagationDelayModel> ());
+      channel->SetPropagationDelayModel (delay);
+    }
+  experiment->phy.SetChannel (channel);
   experiment->phy.Set ("ShortGuardEnabled", BooleanValue (false));
   experiment->phy.Set ("ChannelWidth", UintegerValue (bandWidth));
   experiment->phy.Set ("EnergyDetectionThreshold", DoubleValue (-116.0));
@@ -479,7 +513,7 @@ int main (int argc, char *argv[])
   //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
   // Setup out file 
   oss.str("");
-  oss << "fa_data/fa_" << algorithm << "_" << Nsta << "_" << 
+  oss << outputDir << "/fa_" << algorithm << "_" << Nsta << "_" << 
               Nsaturated << "_" << simSeed << ".dat";
   std::ofstream outfile;
   outfile.open(oss.str(), std::ofstream::out | std::ofstream::trunc);
@@ -500,6 +534,12 @@ int main (int argc, char *argv[])
   apmac->GetBKQueue()->SetAifsn (1);
   apmac->GetDcaTxop()->SetAifsn (1);
   apmac->TraceConnectWithoutContext ("beaconS1G", MakeCallback (&ap_assoc_trace));
+  if (!policyFile.empty ())
+    {
+      Ptr<MlpAuthThresholdPolicy> policy = CreateObject<MlpAuthThresholdPolicy> ();
+      policy->SetAttribute ("WeightsFile", StringValue (policyFile));
+      apmac->SetAttribute ("AuthThresholdPolicy", PointerValue (policy));
+    }
   //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
   //trace saturated-stations association
   if (Nsaturated > 0 )
@@ -527,6 +567,8 @@ int main (int argc, char *argv[])
   // Final configurations 
   Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
   PopulateArpCache ();
+  // the windows of ns3::MultiThreadedSimulatorImpl, which the other simulators do not have
+  Simulator::GetImplementation ()->SetAttributeFailSafe ("Lookahead", TimeValue (channel->GetMinimumDelay ()));
   Simulator::Run ();
   Simulator::Destroy ();
   delete experiment;
@@ -54,5 +54,9 @@ static double sinrDiffCapture = 10;
 static bool enableRaw = false;
 static bool dataCapture = false;
 static bool preambleCapture = false;
+static bool cachePropagation = false;
+static bool tabulateErrorRate = false;
 static std::string DataMode = "OfdmRate600KbpsBW1MHz";  
+static std::string policyFile = "";
+static std::string outputDir = "fa_data";
 
@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""Run scratch/halow_bs over a parameter grid on all cores.
+
+Every point of the grid (one value per parameter, one simSeed) is one
+run of the simulation in its own directory, passed as --outputDir:
+
+  <out>/runs/<point>.partial   while the run is going on
+  <out>/runs/<point>           once it exited with status 0
+  <out>/runs/<point>.failed    if it exited otherwise or timed out
+
+A directory is renamed only once the run is over, so a sweep that was
+interrupted (or crashed) resumes by running again the points without a
+finished directory.  Afterwards the simulationTime.dat of every finished
+run is merged into <out>/simulationTime.dat, written to a temporary file
+and renamed over the old one.
+
+Example, from the top directory once ./waf build has been run:
+
+  ./scratch/halow_bs/sweep.py --out fa_data/sweep --seeds 1:20 \\
+      Nsta=100,500,1000 Nsaturated=0,20 algorithm=0:10 Value=60
+"""
+
+import argparse
+import itertools
+import os
+import queue
+import shutil
+import subprocess
+import sys
+import threading
+import time
+
+
+def parse_values(text):
+    """'1,2,5' or '1:10' (inclusive) or a mix of both, e.g. '1:4,8'."""
+    values = []
+    for part in text.split(','):
+        if ':' in part:
+            first, last = part.split(':')
+            values.extend(str(v) for v in range(int(first), int(last) + 1))
+        else:
+            values.append(part)
+    return values
+
+
+def point_name(point):
+    return '_'.join('%s-%s' % (k, v) for k, v in point)
+
+
+def make_points(grid, seeds):
+    names = sorted(grid)
+    points = []
+    for combination in itertools.product(*(grid[n] for n in names)):
+        for seed in seeds:
+            points.append(tuple(zip(names, combination)) + (('simSeed', seed),))
+
+    # largest cells first, so that the longest runs do not trail at the end
+    def size(point):
+        p = dict(point)
+        return int(p.get('Nsta', 100)) + int(p.get('Nsaturated', 20))
+    points.sort(key=size, reverse=True)
+    return points
+
+
+class Sweep:
+    def __init__(self, args, points):
+        self.args = args
+        self.points = points
+        self.runs = os.path.join(args.out, 'runs')
+        self.lock = threading.Lock()
+        self.done = 0
+        self.failed = 0
+        self.children = set()
+        self.stopping = False
+
+    def pending(self):
+        todo = []
+        for point in self.points:
+            name = point_name(point)
+            if os.path.isdir(os.path.join(self.runs, name)):
+                continue
+            # left over by an interrupted sweep
+            shutil.rmtree(os.path.join(self.runs, name + '.partial'), ignore_errors=True)
+            todo.append(point)
+        return todo
+
+    def run_one(self, point):
+        name = point_name(point)
+        final = os.path.join(self.runs, name)
+        partial = final + '.partial'
+        os.makedirs(partial)
+        cmd = [self.args.program] + ['--%s=%s' % (k, v) for k, v in point]
+        cmd.append('--outputDir=' + partial)
+
+        start = time.time()
+        with open(os.path.join(partial, 'log.txt'), 'w') as log:
+            child = subprocess.Popen(cmd, stdout=log, stderr=subprocess.STDOUT)
+            with self.lock:
+                self.children.add(child)
+            try:
+                status = child.wait(timeout=self.args.timeout)
+            except subprocess.TimeoutExpired:
+                child.kill()
+                child.wait()
+                status = 'timeout'
+            with self.lock:
+                self.children.discard(child)
+        elapsed = time.time() - start
+        if self.stopping:
+            return
+
+        with open(os.path.join(partial, 'status'), 'w') as f:
+            f.write('%s %.1f %s\n' % (status, elapsed, ' '.join(cmd)))
+        # a rerun replaces the result of an earlier attempt, ok or failed
+        shutil.rmtree(final, ignore_errors=True)
+        shutil.rmtree(final + '.failed', ignore_errors=True)
+        if status != 0:
+            final += '.failed'
+        os.rename(partial, final)
+
+        with self.lock:
+            self.done += 1
+            if status != 0:
+                self.failed += 1
+            print('[%d/%d] %s %s %.1f s' % (self.done, self.total, name,
+                                            'ok' if status == 0 else 'FAILED (%s)' % status,
+                                            elapsed))
+            sys.stdout.flush()
+
+    def worker(self, todo):
+        # idle workers take the next point from the shared queue
+        while not self.stopping:
+            try:
+                point = todo.get_nowait()
+            except queue.Empty:
+                return
+            self.run_one(point)
+
+    def run(self):
+        os.makedirs(self.runs, exist_ok=True)
+        pending = self.pending()
+        self.total = len(pending)
+        print('%d points, %d already done, %d to run on %d workers'
+              % (len(self.points), len(self.points) - self.total, self.total, self.args.jobs))
+        todo = queue.Queue()
+        for point in pending:
+            todo.put(point)
+        workers = [threading.Thread(target=self.worker, args=(todo,))
+                   for _ in range(min(self.args.jobs, self.total))]
+        for w in workers:
+            w.daemon = True
+            w.start()
+        try:
+            for w in workers:
+                while w.is_alive():
+                    w.join(1)
+        except KeyboardInterrupt:
+            self.stopping = True
+            with self.lock:
+                for child in self.children:
+                    child.kill()
+            print('interrupted, run again to resume')
+            raise
+
+    def merge(self):
+        merged = os.path.join(self.args.out, 'simulationTime.dat')
+        tmp = merged + '.tmp'
+        lines = 0
+        with open(tmp, 'w') as out:
+            for point in sorted(self.points):
+                result = os.path.join(self.runs, point_name(point), 'simulationTime.dat')
+                if os.path.exists(result):
+                    with open(result) as f:
+                        for line in f:
+                            out.write(line)
+                            lines += 1
+        os.replace(tmp, merged)
+        print('%d results merged into %s' % (lines, merged))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Run scratch/halow_bs over a parameter grid',
+                                     epilog='Example: Nsta=100,500 Nsaturated=0,20 algorithm=0:10')
+    parser.add_argument('grid', nargs='*', metavar='NAME=VALUES',
+                        help='sim.cc parameter and its values, "1,2,5" or "1:10"')
+    parser.add_argument('--seeds', default='1',
+                        help='simSeed values, Default: 1')
+    parser.add_argument('--out', default='fa_data/sweep',
+                        help='Output directory, Default: fa_data/sweep')
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count() or 1,
+                        help='Number of simulations run at the same time, Default: number of cores')
+    parser.add_argument('--timeout', type=float, default=None,
+                        help='Seconds after which a run is killed and counted as failed')
+    parser.add_argument('--program', default=None,
+                        help='halow_bs executable, Default: <build-dir>/scratch/halow_bs/halow_bs')
+    parser.add_argument('--build-dir', default='build',
+                        help='ns-3 build directory with the libraries, Default: build')
+    parser.add_argument('--merge-only', action='store_true',
+                        help='Only merge the results of the finished runs')
+    args = parser.parse_args()
+
+    grid = {}
+    for item in args.grid:
+        if '=' not in item:
+            parser.error('expected NAME=VALUES, got ' + item)
+        name, values = item.split('=', 1)
+        if name == 'simSeed':
+            parser.error('use --seeds for simSeed')
+        grid[name] = parse_values(values)
+    points = make_points(grid, parse_values(args.seeds))
+
+    build = os.path.abspath(args.build_dir)
+    if args.program is None:
+        args.program = os.path.join(build, 'scratch', 'halow_bs', 'halow_bs')
+    args.program = os.path.abspath(args.program)
+    library_path = os.environ.get('LD_LIBRARY_PATH')
+    os.environ['LD_LIBRARY_PATH'] = build + (':' + library_path if library_path else '')
+
+    sweep = Sweep(args, points)
+    if not args.merge_only:
+        if not os.access(args.program, os.X_OK):
+            parser.error('cannot run %s, build it with ./waf build first' % args.program)
+        try:
+            sweep.run()
+        except KeyboardInterrupt:
+            sys.exit(1)
+    sweep.merge()
+    if sweep.failed:
+        print('%d runs failed, see the .failed directories in %s' % (sweep.failed, sweep.runs))
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BATCH_EVENT_H
+#define BATCH_EVENT_H
+
+#include "event-impl.h"
+#include "make-event.h"
+#include "nstime.h"
+#include <algorithm>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::BatchEventImpl declaration and ns3::MakeBatchEvent template
+ * implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup events
+ * The context, the delay and the argument of one of the events
+ * scheduled together by Simulator::ScheduleWithContexts.
+ *
+ * \tparam T The type of the argument.
+ */
+template <typename T>
+struct BatchTarget
+{
+  uint32_t context;  //!< the context of the event
+  Time delay;        //!< the delay of the event, relative to now
+  T arg;             //!< the argument passed to the event
+};
+
+/**
+ * \ingroup events
+ * \brief A group of simulation events sharing a single EventImpl.
+ *
+ * The simulator inserts one event per target into its scheduler, all
+ * pointing to this EventImpl, with consecutive uids.  The targets are
+ * sorted by delay, so the events expire in the order of the targets and
+ * Notify runs the target following the one it ran last.
+ */
+class BatchEventImpl : public EventImpl
+{
+public:
+  /** Destructor. */
+  virtual ~BatchEventImpl () = 0;
+  /**
+   * \returns the number of targets.
+   */
+  virtual uint32_t GetN (void) const = 0;
+  /**
+   * \param i the index of a target
+   * \returns the context of the target.
+   */
+  virtual uint32_t GetContext (uint32_t i) const = 0;
+  /**
+   * \param i the index of a target
+   * \returns the delay of the target, which does not decrease with i.
+   */
+  virtual Time GetDelay (uint32_t i) const = 0;
+};
+
+inline
+BatchEventImpl::~BatchEventImpl ()
+{
+}
+
+/**
+ * \ingroup makeeventmemptr
+ * Make a BatchEventImpl from a class method member taking two
+ * arguments: the first one shared by all the targets, the second one
+ * the argument of each target.
+ *
+ * The targets are copied and sorted by delay; targets with the same
+ * delay keep their order.
+ *
+ * \tparam MEM The class method function signature.
+ * \tparam OBJ The class type holding the method.
+ * \tparam T1 Type of the argument shared by all the targets.
+ * \tparam T2 Type of the argument of each target.
+ * \param mem_ptr Class method member function pointer
+ * \param obj Class instance.
+ * \param a1 The argument shared by all the targets.
+ * \param targets The targets.
+ * \returns The constructed BatchEventImpl.
+ */
+template <typename MEM, typename OBJ,
+          typename T1, typename T2>
+BatchEventImpl * MakeBatchEvent (MEM mem_ptr, OBJ obj, T1 a1,
+                                 const std::vector<BatchTarget<T2> > &targets)
+{
+  class BatchEventMemberImpl : public BatchEventImpl
+  {
+public:
+    BatchEventMemberImpl (OBJ obj, MEM function, T1 a1,
+                          const std::vector<BatchTarget<T2> > &targets)
+      : m_obj (obj),
+        m_function (function),
+        m_a1 (a1),
+        m_next (0)
+    {
+      m_targets.reserve (targets.size ());
+      for (uint32_t i = 0; i < targets.size (); i++)
+        {
+          Target target;
+          target.target = targets[i];
+          target.index = i;
+          m_targets.push_back (target);
+        }
+      std::sort (m_targets.begin (), m_targets.end ());
+    }
+    virtual uint32_t GetN (void) const
+    {
+      return m_targets.size ();
+    }
+    virtual uint32_t GetContext (uint32_t i) const
+    {
+      return m_targets[i].target.context;
+    }
+    virtual Time GetDelay (uint32_t i) const
+    {
+      return m_targets[i].target.delay;
+    }
+protected:
+    virtual ~BatchEventMemberImpl ()
+    {
+    }
+private:
+    virtual void Notify (void)
+    {
+      (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_targets[m_next++].target.arg);
+    }
+    /// A target and its position in the targets given to MakeBatchEvent
+    struct Target
+    {
+      BatchTarget<T2> target;  //!< the target
+      uint32_t index;          //!< its position
+      /**
+       * \param o another target
+       * \returns true if this one expires first
+       */
+      bool operator < (const Target &o) const
+      {
+        return target.delay < o.target.delay
+               || (target.delay == o.target.delay && index < o.index);
+      }
+    };
+    OBJ m_obj;
+    MEM m_function;
+    typename TypeTraits<T1>::ReferencedType m_a1;
+    std::vector<Target> m_targets;
+    uint32_t m_next;
+  } *ev = new BatchEventMemberImpl (obj, mem_ptr, a1, targets);
+  return ev;
+}
+
+} // namespace ns3
+
+#endif /* BATCH_EVENT_H */
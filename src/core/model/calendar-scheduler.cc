@@ -121,6 +121,14 @@ void
 CalendarScheduler::Insert (const Event &ev)
 {
   NS_LOG_FUNCTION (this << &ev);
+  if (ev.key.m_ts < m_lastPrio)
+    {
+      // an event before the last one removed, as when the simulator
+      // rebuilds the event list: start the next search from it.
+      m_lastPrio = ev.key.m_ts;
+      m_lastBucket = Hash (ev.key.m_ts);
+      m_bucketTop = (ev.key.m_ts / m_width + 1) * m_width;
+    }
   DoInsert (ev);
   m_qSize++;
   ResizeUp ();
@@ -94,10 +94,36 @@ void
 MatchContainer::Set (std::string name, const AttributeValue &value)
 {
   NS_LOG_FUNCTION (this << name << &value);
+  // the objects matched by a wildcard are mostly of the same type: the
+  // attribute is looked up, and the value checked, once per run of them.
+  TypeId tid;
+  struct TypeId::AttributeInformation info;
+  Ptr<AttributeValue> v;
   for (Iterator tmp = Begin (); tmp != End (); ++tmp)
     {
       Ptr<Object> object = *tmp;
-      object->SetAttribute (name, value);
+      if (v == 0 || object->GetInstanceTypeId () != tid)
+        {
+          tid = object->GetInstanceTypeId ();
+          if (!tid.LookupAttributeByName (name, &info))
+            {
+              NS_FATAL_ERROR ("Attribute name="<<name<<" does not exist for this object: tid="<<tid.GetName ());
+            }
+          if (!(info.flags & TypeId::ATTR_SET) ||
+              !info.accessor->HasSetter ())
+            {
+              NS_FATAL_ERROR ("Attribute name="<<name<<" is not settable for this object: tid="<<tid.GetName ());
+            }
+          v = info.checker->CreateValidValue (value);
+          if (v == 0)
+            {
+              NS_FATAL_ERROR ("Attribute name="<<name<<" could not be set for this object: tid="<<tid.GetName ());
+            }
+        }
+      if (!info.accessor->Set (PeekPointer (object), *v))
+        {
+          NS_FATAL_ERROR ("Attribute name="<<name<<" could not be set for this object: tid="<<tid.GetName ());
+        }
     }
 }
 void 
@@ -239,92 +265,118 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
 }
 
 
-class Resolver
-{
-public:
-  Resolver (std::string path);
-  virtual ~Resolver ();
-
-  void Resolve (Ptr<Object> root);
-private:
-  void Canonicalize (void);
-  void DoResolve (std::string path, Ptr<Object> root);
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
-  void DoResolveOne (Ptr<Object> object);
-  std::string GetResolvedPath (void) const;
-  virtual void DoOne (Ptr<Object> object, std::string path) = 0;
-  std::vector<std::string> m_workStack;
-  std::string m_path;
-};
+namespace Config {
 
-Resolver::Resolver (std::string path)
+CompiledPath::CompiledPath (std::string path)
   : m_path (path)
 {
   NS_LOG_FUNCTION (this << path);
-  Canonicalize ();
-}
-Resolver::~Resolver ()
-{
-  NS_LOG_FUNCTION (this);
-}
-void
-Resolver::Canonicalize (void)
-{
-  NS_LOG_FUNCTION (this);
 
   // ensure that we start and end with a '/'
-  std::string::size_type tmp = m_path.find ("/");
-  if (tmp != 0)
+  if (path.find ("/") != 0)
     {
       // no slash at start
-      m_path = "/" + m_path;
+      path = "/" + path;
     }
-  tmp = m_path.find_last_of ("/");
-  if (tmp != (m_path.size () - 1))
+  if (path.find_last_of ("/") != (path.size () - 1))
     {
       // no slash at end
-      m_path = m_path + "/";
+      path = path + "/";
+    }
+  std::string::size_type start = 0;
+  std::string::size_type next;
+  while ((next = path.find ("/", start + 1)) != std::string::npos)
+    {
+      Item item;
+      item.name = path.substr (start + 1, next - (start + 1));
+      item.names = item.name.compare (0, 5, "Names") == 0;
+      item.getObject = item.name.find ("$") == 0;
+      item.tidFound = item.getObject && TypeId::LookupByNameFailSafe (item.name.substr (1), &item.tid);
+      m_items.push_back (item);
+      start = next;
     }
+  m_links.resize (m_items.size ());
 }
 
-void 
-Resolver::Resolve (Ptr<Object> root)
+std::string
+CompiledPath::GetPath (void) const
 {
-  NS_LOG_FUNCTION (this << root);
-
-  DoResolve (m_path, root);
+  NS_LOG_FUNCTION (this);
+  return m_path;
 }
 
-std::string
-Resolver::GetResolvedPath (void) const
+MatchContainer
+CompiledPath::LookupMatches (void) const
 {
   NS_LOG_FUNCTION (this);
-
-  std::string fullPath = "/";
-  for (std::vector<std::string>::const_iterator i = m_workStack.begin (); i != m_workStack.end (); i++)
+  std::vector<Ptr<Object> > objects;
+  std::vector<std::string> contexts;
+  std::string context = "/";
+  for (uint32_t i = 0; i < GetRootNamespaceObjectN (); i++)
     {
-      fullPath += *i + "/";
+      DoResolve (0, GetRootNamespaceObject (i), context, objects, contexts);
     }
-  return fullPath;
+
+  //
+  // See if we can do something with the object name service.  Starting with
+  // the root pointer zeroed indicates to the resolver that it should start
+  // looking at the root of the "/Names" namespace during this go.
+  //
+  DoResolve (0, 0, context, objects, contexts);
+
+  return MatchContainer (objects, contexts, m_path);
 }
 
-void 
-Resolver::DoResolveOne (Ptr<Object> object)
+const std::vector<CompiledPath::Link> &
+CompiledPath::GetLinks (uint32_t i, TypeId tid) const
 {
-  NS_LOG_FUNCTION (this << object);
-
-  NS_LOG_DEBUG ("resolved="<<GetResolvedPath ());
-  DoOne (object, GetResolvedPath ());
+  Links::const_iterator found = m_links[i].find (tid);
+  if (found != m_links[i].end ())
+    {
+      return found->second;
+    }
+  std::vector<Link> &links = m_links[i][tid];
+  const std::string &item = m_items[i].name;
+  TypeId nextTid = tid;
+  do
+    {
+      tid = nextTid;
+      for (uint32_t j = 0; j < tid.GetAttributeN (); j++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (j);
+          if (info.name != item && item != "*")
+            {
+              continue;
+            }
+          Link link;
+          link.name = info.name;
+          link.accessor = info.accessor;
+          link.gettable = (info.flags & TypeId::ATTR_GET) && info.accessor->HasGetter ();
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              link.container = false;
+              links.push_back (link);
+            }
+          else if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              link.container = true;
+              links.push_back (link);
+            }
+          // this could be anything else and we don't know what to do with it.
+          // So, we just ignore it.
+        }
+      nextTid = tid.GetParent ();
+    } while (nextTid != tid);
+  return links;
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+CompiledPath::DoResolve (uint32_t i, Ptr<Object> root, std::string &context,
+                         std::vector<Ptr<Object> > &objects,
+                         std::vector<std::string> &contexts) const
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION (this << i << root << context);
+  if (i == m_items.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name 
@@ -336,12 +388,14 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
       // 
       if (root)
         {
-          DoResolveOne (root);
+          NS_LOG_DEBUG ("resolved=" << context);
+          objects.push_back (root);
+          contexts.push_back (context);
         }
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const Item &item = m_items[i];
+  std::string::size_type length = context.size ();
 
   //
   // If root is zero, we're beginning to see if we can use the object name 
@@ -350,16 +404,12 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   // the root of the "/Names" namespace, so we just ignore it and move on to 
   // the next segment.
   //
-  if (root == 0)
+  if (root == 0 && item.names)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
-        {
-          m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
-          m_workStack.pop_back ();
-          return;
-        }
+      context += item.name + "/";
+      DoResolve (i + 1, root, context, objects, contexts);
+      context.resize (length);
+      return;
     }
 
   //
@@ -368,13 +418,13 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   // zero, this means to look in the root of the "/Names" name space, otherwise
   // it refers to a name space context (level).
   //
-  Ptr<Object> namedObject = Names::Find<Object> (root, item);
+  Ptr<Object> namedObject = Names::Find<Object> (root, item.name);
   if (namedObject)
     {
-      NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
-      m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
-      m_workStack.pop_back ();
+      NS_LOG_DEBUG ("Name system resolved item = " << item.name << " to " << namedObject);
+      context += item.name + "/";
+      DoResolve (i + 1, namedObject, context, objects, contexts);
+      context.resize (length);
       return;
     }
 
@@ -389,119 +439,101 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       return;
     }
-  std::string::size_type dollarPos = item.find ("$");
-  if (dollarPos == 0)
+  if (item.getObject)
     {
       // This is a call to GetObject
-      std::string tidString = item.substr (1, item.size () - 1);
-      NS_LOG_DEBUG ("GetObject="<<tidString<<" on path="<<GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
+      NS_LOG_DEBUG ("GetObject=" << item.name << " on path=" << context);
+      TypeId tid = item.tidFound ? item.tid : TypeId::LookupByName (item.name.substr (1));
       Ptr<Object> object = root->GetObject<Object> (tid);
       if (object == 0)
         {
-          NS_LOG_DEBUG ("GetObject ("<<tidString<<") failed on path="<<GetResolvedPath ());
+          NS_LOG_DEBUG ("GetObject (" << item.name << ") failed on path=" << context);
           return;
         }
-      m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
-      m_workStack.pop_back ();
+      context += item.name + "/";
+      DoResolve (i + 1, object, context, objects, contexts);
+      context.resize (length);
+      return;
     }
-  else 
-    {
-      // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
-      bool foundMatch = false;
-      
-      do
+
+  // this is a normal attribute.
+  const std::vector<Link> &links = GetLinks (i, root->GetInstanceTypeId ());
+  if (links.empty ())
+    {
+      NS_LOG_DEBUG ("Requested item=" << item.name << " does not exist on path=" << context);
+      return;
+    }
+  for (std::vector<Link>::const_iterator link = links.begin (); link != links.end (); link++)
+    {
+      if (!link->gettable)
+        {
+          NS_FATAL_ERROR ("Attribute name=" << link->name << " is not gettable for this object: tid=" <<
+                          root->GetInstanceTypeId ().GetName ());
+        }
+      if (!link->container)
         {
-          tid = nextTid;
-          
-          for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+          NS_LOG_DEBUG ("GetAttribute(ptr)=" << link->name << " on path=" << context);
+          PointerValue ptr;
+          if (!link->accessor->Get (PeekPointer (root), ptr))
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute(i);
-              if (info.name != item && item != "*")
-                {
-                  continue;
-                }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *ptr = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (ptr != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)="<<info.name<<" on path="<<GetResolvedPath ());
-                  PointerValue ptr;
-                  root->GetAttribute (info.name, ptr);
-                  Ptr<Object> object = ptr.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\""<<item<<
-                                    "\" exists on path=\""<<GetResolvedPath ()<<"\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
-                }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker = 
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
-                }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              NS_FATAL_ERROR ("Attribute name=" << link->name << " tid=" <<
+                              root->GetInstanceTypeId ().GetName () << ": could not get value");
             }
-
-          nextTid = tid.GetParent ();
-        } while (nextTid != tid);
-      
-      if (!foundMatch)
+          Ptr<Object> object = ptr.Get<Object> ();
+          if (object == 0)
+            {
+              NS_LOG_ERROR ("Requested object name=\"" << item.name <<
+                            "\" exists on path=\"" << context << "\""
+                            " but is null.");
+              continue;
+            }
+          context += link->name + "/";
+          DoResolve (i + 1, object, context, objects, contexts);
+          context.resize (length);
+        }
+      else
         {
-          NS_LOG_DEBUG ("Requested item="<<item<<" does not exist on path="<<GetResolvedPath ());
-          return;
+          NS_LOG_DEBUG ("GetAttribute(vector)=" << link->name << " on path=" << context);
+          ObjectPtrContainerValue vector;
+          if (!link->accessor->Get (PeekPointer (root), vector))
+            {
+              NS_FATAL_ERROR ("Attribute name=" << link->name << " tid=" <<
+                              root->GetInstanceTypeId ().GetName () << ": could not get value");
+            }
+          context += link->name + "/";
+          DoArrayResolve (i + 1, vector, context, objects, contexts);
+          context.resize (length);
         }
     }
 }
 
-void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+void
+CompiledPath::DoArrayResolve (uint32_t i, const ObjectPtrContainerValue &container, std::string &context,
+                              std::vector<Ptr<Object> > &objects,
+                              std::vector<std::string> &contexts) const
 {
-  NS_LOG_FUNCTION(this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION (this << i << &container << context);
+  if (i == m_items.size ())
     {
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
-
-  ArrayMatcher matcher = ArrayMatcher (item);
+  std::string::size_type length = context.size ();
+  ArrayMatcher matcher = ArrayMatcher (m_items[i].name);
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
       if (matcher.Matches ((*it).first))
         {
           std::ostringstream oss;
-          oss << (*it).first;
-          m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
-          m_workStack.pop_back ();
+          oss << (*it).first << "/";
+          context += oss.str ();
+          DoResolve (i + 1, (*it).second, context, objects, contexts);
+          context.resize (length);
         }
     }
 }
 
+} // namespace Config
 
 class ConfigImpl 
 {
@@ -523,6 +555,9 @@ private:
   void ParsePath (std::string path, std::string *root, std::string *leaf) const;
   typedef std::vector<Ptr<Object> > Roots;
   Roots m_roots;
+  typedef std::map<std::string, Config::CompiledPath> CompiledPaths;
+  /// the paths looked up, parsed, with the attributes they match by type
+  CompiledPaths m_paths;
 };
 
 void 
@@ -590,32 +625,17 @@ Config::MatchContainer
 ConfigImpl::LookupMatches (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
-  class LookupMatchesResolver : public Resolver 
-  {
-  public:
-    LookupMatchesResolver (std::string path)
-      : Resolver (path)
-    {}
-    virtual void DoOne (Ptr<Object> object, std::string path) {
-      m_objects.push_back (object);
-      m_contexts.push_back (path);
-    }
-    std::vector<Ptr<Object> > m_objects;
-    std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
-  for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
+  CompiledPaths::iterator i = m_paths.find (path);
+  if (i == m_paths.end ())
     {
-      resolver.Resolve (*i);
+      if (m_paths.size () >= 64)
+        {
+          // the paths of single objects are rarely used again
+          m_paths.clear ();
+        }
+      i = m_paths.insert (std::make_pair (path, Config::CompiledPath (path))).first;
     }
-
-  //
-  // See if we can do something with the object name service.  Starting with
-  // the root pointer zeroed indicates to the resolver that it should start
-  // looking at the root of the "/Names" namespace during this go.
-  //
-  resolver.Resolve (0);
-
-  return Config::MatchContainer (resolver.m_objects, resolver.m_contexts, path);
+  return i->second.LookupMatches ();
 }
 
 void 
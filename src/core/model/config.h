@@ -21,6 +21,8 @@
 #define CONFIG_H
 
 #include "ptr.h"
+#include "type-id.h"
+#include <map>
 #include <string>
 #include <vector>
 
@@ -35,6 +37,7 @@ namespace ns3 {
 class AttributeValue;
 class Object;
 class CallbackBase;
+class ObjectPtrContainerValue;
 
 /**
  * \ingroup core
@@ -246,6 +249,97 @@ private:
  */
 MatchContainer LookupMatches (std::string path);
 
+/**
+ * \ingroup config
+ * \brief a path parsed once, to look up the objects it matches many times.
+ *
+ * The objects matched by a path are found by walking its segments from
+ * the root namespace objects.  A CompiledPath splits the path once, and
+ * remembers for each concrete type met along the way which of its
+ * attributes match each segment: a wildcard over a large NodeList then
+ * does not look the attributes up by name for each node.
+ *
+ * Config::Set, the Config::Connect functions and Config::LookupMatches
+ * keep the CompiledPath of the paths they are given, for the next calls
+ * with the same path.
+ */
+class CompiledPath
+{
+public:
+  /**
+   * \param path the path of the objects, without the name of an
+   *        attribute or trace source
+   */
+  CompiledPath (std::string path);
+
+  /**
+   * \returns the path of the objects
+   */
+  std::string GetPath (void) const;
+  /**
+   * \returns a container of the objects which match the path now
+   */
+  MatchContainer LookupMatches (void) const;
+
+private:
+  /// A segment of the path
+  struct Item
+  {
+    std::string name;  //!< the segment
+    bool names;        //!< the segment is in the "/Names" namespace
+    bool getObject;    //!< the segment is "$" followed by a TypeId name
+    TypeId tid;        //!< that TypeId, if registered when the path was parsed
+    bool tidFound;     //!< tid is valid
+  };
+  /// An attribute which leads from an object to the next ones
+  struct Link
+  {
+    std::string name;                       //!< the name of the attribute
+    Ptr<const AttributeAccessor> accessor;  //!< its accessor
+    bool gettable;                          //!< the attribute can be read
+    bool container;                         //!< it holds several objects, else a pointer
+  };
+  /// The links of each concrete type which match a segment
+  typedef std::map<TypeId, std::vector<Link> > Links;
+
+  /**
+   * Look up the objects matched by the segments from the i-th on.
+   *
+   * \param i the index of the segment
+   * \param root the object the segment applies to, 0 for the root of
+   *        the "/Names" namespace
+   * \param context the path matched so far
+   * \param objects the objects matched
+   * \param contexts the path matched by each object
+   */
+  void DoResolve (uint32_t i, Ptr<Object> root, std::string &context,
+                  std::vector<Ptr<Object> > &objects,
+                  std::vector<std::string> &contexts) const;
+  /**
+   * Look up the objects matched by the segments from the i-th on, the
+   * i-th segment selecting the elements of a container.
+   *
+   * \param i the index of the segment
+   * \param container the container
+   * \param context the path matched so far
+   * \param objects the objects matched
+   * \param contexts the path matched by each object
+   */
+  void DoArrayResolve (uint32_t i, const ObjectPtrContainerValue &container, std::string &context,
+                       std::vector<Ptr<Object> > &objects,
+                       std::vector<std::string> &contexts) const;
+  /**
+   * \param i the index of a segment
+   * \param tid the concrete type of an object
+   * \returns the attributes of that type which match the segment
+   */
+  const std::vector<Link> &GetLinks (uint32_t i, TypeId tid) const;
+
+  std::string m_path;           //!< the path
+  std::vector<Item> m_items;    //!< its segments
+  mutable std::vector<Links> m_links;  //!< the links of each segment, by type
+};
+
 /**
  * \ingroup config
  * \param obj a new root object
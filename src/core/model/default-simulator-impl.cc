@@ -20,11 +20,14 @@
 
 #include "simulator.h"
 #include "default-simulator-impl.h"
+#include "batch-event.h"
 #include "scheduler.h"
 #include "event-impl.h"
 
 #include "ptr.h"
 #include "pointer.h"
+#include "double.h"
+#include "uinteger.h"
 #include "assert.h"
 #include "log.h"
 
@@ -53,6 +56,20 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("MaxCancelledRatio",
+                   "The ratio of cancelled to other events in the event list "
+                   "above which the list is rebuilt without the cancelled ones, "
+                   "0 to never rebuild it.  Not used with the schedulers which "
+                   "remove a cancelled event right away, e.g. ns3::MapScheduler.",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&DefaultSimulatorImpl::m_maxCancelledRatio),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("MinCancelledEvents",
+                   "The number of cancelled events in the event list below "
+                   "which the list is never rebuilt.",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&DefaultSimulatorImpl::m_minCancelledEvents),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -71,6 +88,8 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentTs = 0;
   m_currentContext = 0xffffffff;
   m_unscheduledEvents = 0;
+  m_cancelledEvents = 0;
+  m_removeCancelled = false;
   m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self();
 }
@@ -123,6 +142,7 @@ DefaultSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
         }
     }
   m_events = scheduler;
+  m_removeCancelled = scheduler->IsRemoveCheap ();
 }
 
 // System ID for non-distributed simulation is always zero
@@ -144,6 +164,10 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
+  if (next.impl->IsCancelled () && m_cancelledEvents > 0)
+    {
+      m_cancelledEvents--;
+    }
   next.impl->Invoke ();
   next.impl->Unref ();
 
@@ -274,6 +298,35 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, E
     }
 }
 
+void
+DefaultSimulatorImpl::ScheduleWithContexts (BatchEventImpl *event)
+{
+  NS_LOG_FUNCTION (this << event);
+
+  uint32_t n = event->GetN ();
+  if (!SystemThread::Equals (m_main) || n == 0)
+    {
+      SimulatorImpl::ScheduleWithContexts (event);
+      return;
+    }
+  m_batch.resize (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (i + 1 < n)
+        {
+          event->Ref ();
+        }
+      Scheduler::Event &ev = m_batch[i];
+      ev.impl = event;
+      ev.key.m_ts = (uint64_t) (event->GetDelay (i) + TimeStep (m_currentTs)).GetTimeStep ();
+      ev.key.m_context = event->GetContext (i);
+      ev.key.m_uid = m_uid;
+      m_uid++;
+    }
+  m_unscheduledEvents += n;
+  m_events->InsertBatch (m_batch);
+}
+
 EventId
 DefaultSimulatorImpl::ScheduleNow (EventImpl *event)
 {
@@ -359,8 +412,42 @@ DefaultSimulatorImpl::Cancel (const EventId &id)
 {
   if (!IsExpired (id))
     {
+      if (id.GetUid () == 2)
+        {
+          // destroy events are not in the event list
+          id.PeekEventImpl ()->Cancel ();
+          return;
+        }
+      if (m_removeCancelled)
+        {
+          // costs about what RemoveNext would pay for it later, and the
+          // list never holds the cancelled events
+          Remove (id);
+          return;
+        }
       id.PeekEventImpl ()->Cancel ();
+      m_cancelledEvents++;
+      if (m_maxCancelledRatio > 0
+          && m_cancelledEvents >= static_cast<int> (m_minCancelledEvents)
+          && m_cancelledEvents > m_maxCancelledRatio * (m_unscheduledEvents - m_cancelledEvents))
+        {
+          Compact ();
+        }
+    }
+}
+
+void
+DefaultSimulatorImpl::Compact (void)
+{
+  NS_LOG_FUNCTION (this << m_cancelledEvents << m_unscheduledEvents);
+  m_batch.clear ();
+  m_events->RemoveCancelled (m_batch);
+  for (std::vector<Scheduler::Event>::const_iterator i = m_batch.begin (); i != m_batch.end (); i++)
+    {
+      i->impl->Unref ();
     }
+  m_unscheduledEvents -= m_batch.size ();
+  m_cancelledEvents = 0;
 }
 
 bool
@@ -30,6 +30,7 @@
 #include "ptr.h"
 
 #include <list>
+#include <vector>
 
 /**
  * \file
@@ -43,6 +44,12 @@ namespace ns3 {
  * \ingroup simulator
  *
  * The default single process simulator implementation.
+ *
+ * Cancelled events stay in the event list until they reach its head.
+ * When the timers of the models cancel many more events than they run,
+ * the list would mostly hold dead events: once the cancelled events
+ * outnumber the others by the MaxCancelledRatio attribute, the list is
+ * rebuilt without them.
  */
 class DefaultSimulatorImpl : public SimulatorImpl
 {
@@ -58,6 +65,7 @@ public:
   virtual void Stop (Time const &time);
   virtual EventId Schedule (Time const &time, EventImpl *event);
   virtual void ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event);
+  virtual void ScheduleWithContexts (BatchEventImpl *event);
   virtual EventId ScheduleNow (EventImpl *event);
   virtual EventId ScheduleDestroy (EventImpl *event);
   virtual void Remove (const EventId &id);
@@ -75,6 +83,11 @@ private:
   virtual void DoDispose (void);
   void ProcessOneEvent (void);
   void ProcessEventsWithContext (void);
+  /**
+   * Rebuild the event list without the cancelled events, once there
+   * are too many of them.
+   */
+  void Compact (void);
  
   struct EventWithContext {
     uint32_t context;
@@ -90,6 +103,8 @@ private:
   DestroyEvents m_destroyEvents;
   bool m_stop;
   Ptr<Scheduler> m_events;
+  /// events of the last ScheduleWithContexts, kept to reuse the memory
+  std::vector<Scheduler::Event> m_batch;
 
   uint32_t m_uid;
   uint32_t m_currentUid;
@@ -98,6 +113,14 @@ private:
   // number of events that have been inserted but not yet scheduled,
   // not counting the "destroy" events; this is used for validation
   int m_unscheduledEvents;
+  // number of those events that have been cancelled
+  int m_cancelledEvents;
+  /// ratio of cancelled to other events above which the list is compacted
+  double m_maxCancelledRatio;
+  /// number of cancelled events below which the list is never compacted
+  uint32_t m_minCancelledEvents;
+  /// whether the cancelled events are removed from the list right away
+  bool m_removeCancelled;
 
   SystemThread::ThreadId m_main;
 };
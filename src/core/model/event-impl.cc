@@ -20,6 +20,12 @@
 
 #include "event-impl.h"
 #include "log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "system-mutex.h"
+#endif
+#include <atomic>
+#include <new>
 
 /**
  * \file
@@ -31,6 +37,219 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+/// Size of the size classes of the events (bytes)
+static const std::size_t EVENT_GRANULE = 16;
+/// Number of size classes, larger events are given back to the system
+static const std::size_t EVENT_CLASSES = 16;
+/// Number of deleted events of a size class kept by a thread
+static const uint32_t EVENT_CACHE_SIZE = 16384;
+
+/// A deleted event, in the list of its size class
+struct FreeEvent
+{
+  FreeEvent *next; //!< next deleted event of the same class
+};
+
+/**
+ * The deleted events kept by a thread, and its counters.
+ *
+ * The counters are only written by the thread of the cache, but are read
+ * by any thread: they are atomic, written without a locked instruction.
+ */
+struct EventCache
+{
+  FreeEvent *free[EVENT_CLASSES];  //!< deleted events of each class
+  uint32_t count[EVENT_CLASSES];   //!< number of deleted events of each class
+  std::atomic<uint64_t> allocations;       //!< number of events allocated by the thread
+  std::atomic<uint64_t> systemAllocations; //!< number of those allocated from the system
+  EventCache *next;                //!< cache of another thread
+};
+
+/**
+ * Increment a counter of the cache of the calling thread.
+ *
+ * \param counter the counter
+ */
+static inline void
+Increment (std::atomic<uint64_t> &counter)
+{
+  counter.store (counter.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+/// The caches of the running threads
+static EventCache *g_eventCaches = 0;
+/// The events allocated by the threads that exited
+static std::atomic<uint64_t> g_retiredAllocations (0);
+/// The events of those allocated from the system
+static std::atomic<uint64_t> g_retiredSystemAllocations (0);
+/// The cache of the calling thread
+static thread_local EventCache *t_eventCache = 0;
+/// Whether the calling thread is exiting and gave its cache back
+static thread_local bool t_eventCacheRetired = false;
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * \return the mutex of the list of the caches
+ */
+static SystemMutex &
+GetEventCachesMutex (void)
+{
+  static SystemMutex mutex;
+  return mutex;
+}
+#endif
+
+/**
+ * Gives the cache of a thread back when the thread exits: the deleted
+ * events go back to the system and the counters to the retired totals.
+ *
+ * The simulators that run on threads start new threads for every run,
+ * the caches of the threads that exited would be lost otherwise.
+ */
+struct EventCacheRetirement
+{
+  EventCache *cache; //!< the cache of the thread, 0 until it has one
+
+  /// Destructor, run when the thread exits
+  ~EventCacheRetirement ()
+  {
+    if (cache == 0)
+      {
+        return;
+      }
+    {
+#ifdef HAVE_PTHREAD_H
+      CriticalSection cs (GetEventCachesMutex ());
+#endif
+      EventCache **i = &g_eventCaches;
+      while (*i != cache)
+        {
+          i = &(*i)->next;
+        }
+      *i = cache->next;
+      g_retiredAllocations.fetch_add (cache->allocations.load (std::memory_order_relaxed),
+                                      std::memory_order_relaxed);
+      g_retiredSystemAllocations.fetch_add (cache->systemAllocations.load (std::memory_order_relaxed),
+                                            std::memory_order_relaxed);
+    }
+    for (std::size_t sizeClass = 0; sizeClass < EVENT_CLASSES; sizeClass++)
+      {
+        while (cache->free[sizeClass] != 0)
+          {
+            FreeEvent *event = cache->free[sizeClass];
+            cache->free[sizeClass] = event->next;
+            ::operator delete (event);
+          }
+      }
+    delete cache;
+    // the events deleted later by this thread, e.g. by the destructors
+    // of static objects, go to the system
+    t_eventCache = 0;
+    t_eventCacheRetired = true;
+  }
+};
+
+/// Gives the cache of the calling thread back when it exits
+static thread_local EventCacheRetirement t_eventCacheRetirement;
+
+/**
+ * \return the cache of the calling thread, added if needed, or 0 if the
+ * thread is exiting
+ */
+static EventCache *
+GetEventCache (void)
+{
+  if (t_eventCache == 0 && !t_eventCacheRetired)
+    {
+      t_eventCache = new EventCache ();
+      {
+#ifdef HAVE_PTHREAD_H
+        CriticalSection cs (GetEventCachesMutex ());
+#endif
+        t_eventCache->next = g_eventCaches;
+        g_eventCaches = t_eventCache;
+      }
+      // constructed on first use, which registers its destructor
+      t_eventCacheRetirement.cache = t_eventCache;
+    }
+  return t_eventCache;
+}
+
+void *
+EventImpl::operator new (std::size_t size)
+{
+  EventCache *cache = GetEventCache ();
+  std::size_t sizeClass = (size - 1) / EVENT_GRANULE;
+  if (cache == 0)
+    {
+      g_retiredAllocations.fetch_add (1, std::memory_order_relaxed);
+      g_retiredSystemAllocations.fetch_add (1, std::memory_order_relaxed);
+      return ::operator new (size);
+    }
+  Increment (cache->allocations);
+  if (sizeClass < EVENT_CLASSES && cache->free[sizeClass] != 0)
+    {
+      FreeEvent *event = cache->free[sizeClass];
+      cache->free[sizeClass] = event->next;
+      cache->count[sizeClass]--;
+      return event;
+    }
+  Increment (cache->systemAllocations);
+  // the whole class, so that the memory fits any event of the class
+  return ::operator new (sizeClass < EVENT_CLASSES ? (sizeClass + 1) * EVENT_GRANULE : size);
+}
+
+void
+EventImpl::operator delete (void *p, std::size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  EventCache *cache = GetEventCache ();
+  std::size_t sizeClass = (size - 1) / EVENT_GRANULE;
+  // the events scheduled by another thread of the realtime simulator are
+  // deleted by the simulation thread: the number of events kept is
+  // bounded so that its cache does not grow without limit.
+  if (cache != 0 && sizeClass < EVENT_CLASSES && cache->count[sizeClass] < EVENT_CACHE_SIZE)
+    {
+      FreeEvent *event = static_cast<FreeEvent *> (p);
+      event->next = cache->free[sizeClass];
+      cache->free[sizeClass] = event;
+      cache->count[sizeClass]++;
+      return;
+    }
+  ::operator delete (p);
+}
+
+uint64_t
+EventImpl::GetAllocations (void)
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection cs (GetEventCachesMutex ());
+#endif
+  uint64_t allocations = g_retiredAllocations.load (std::memory_order_relaxed);
+  for (EventCache *cache = g_eventCaches; cache != 0; cache = cache->next)
+    {
+      allocations += cache->allocations.load (std::memory_order_relaxed);
+    }
+  return allocations;
+}
+
+uint64_t
+EventImpl::GetSystemAllocations (void)
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection cs (GetEventCachesMutex ());
+#endif
+  uint64_t allocations = g_retiredSystemAllocations.load (std::memory_order_relaxed);
+  for (EventCache *cache = g_eventCaches; cache != 0; cache = cache->next)
+    {
+      allocations += cache->systemAllocations.load (std::memory_order_relaxed);
+    }
+  return allocations;
+}
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -40,6 +41,14 @@ namespace ns3 {
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * Events are small and short-lived, so their memory is not given back
+ * to the system when they are deleted: each thread keeps the memory of
+ * the events it deleted, by size classes of 16 bytes, for the next
+ * events of the same class it allocates. These are free lists of single
+ * events, not a slab or arena allocator: an event is first allocated
+ * from the system on its own, and the events kept by a thread go back
+ * to the system when the thread exits.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -66,6 +75,35 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * Allocate the memory of an event, from the events deleted by the
+   * calling thread if possible.
+   *
+   * \param size the size of the event
+   * \return the memory of the event
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Keep the memory of an event for the next events of its size class
+   * allocated by the calling thread.
+   *
+   * \param p the memory of the event
+   * \param size the size of the event
+   */
+  static void operator delete (void *p, std::size_t size);
+  /**
+   * \returns the number of events allocated so far by all the threads,
+   * including the threads that exited.
+   *
+   * The threads still running may be counting their next events.
+   */
+  static uint64_t GetAllocations (void);
+  /**
+   * \returns the number of those events whose memory was allocated
+   * from the system rather than reused.
+   */
+  static uint64_t GetSystemAllocations (void);
+
 protected:
   /**
    * Implementation for Invoke().
@@ -150,10 +150,10 @@ HeapScheduler::IsEmpty (void) const
 }
 
 void
-HeapScheduler::BottomUp (void)
+HeapScheduler::BottomUp (uint32_t start)
 {
-  NS_LOG_FUNCTION (this);
-  uint32_t index = Last ();
+  NS_LOG_FUNCTION (this << start);
+  uint32_t index = start;
   while (!IsRoot (index)
          && IsLessStrictly (index, Parent (index)))
     {
@@ -203,7 +203,28 @@ HeapScheduler::Insert (const Event &ev)
 {
   NS_LOG_FUNCTION (this << &ev);
   m_heap.push_back (ev);
-  BottomUp ();
+  BottomUp (Last ());
+}
+
+void
+HeapScheduler::InsertBatch (const std::vector<Event> &events)
+{
+  NS_LOG_FUNCTION (this << events.size ());
+  if (events.size () < Last ())
+    {
+      for (std::vector<Event>::const_iterator i = events.begin (); i != events.end (); i++)
+        {
+          Insert (*i);
+        }
+      return;
+    }
+  // at least as many new events as old ones: rebuilding the heap
+  // takes fewer comparisons than sifting up each new event.
+  m_heap.insert (m_heap.end (), events.begin (), events.end ());
+  for (uint32_t i = Parent (Last ()); i >= Root (); i--)
+    {
+      TopDown (i);
+    }
 }
 
 Scheduler::Event
@@ -236,12 +257,43 @@ HeapScheduler::Remove (const Event &ev)
           NS_ASSERT (m_heap[i].impl == ev.impl);
           Exch (i, Last ());
           m_heap.pop_back ();
-          TopDown (i);
+          // the last event may belong above the removed one
+          if (!IsBottom (i) && !IsRoot (i) && IsLessStrictly (i, Parent (i)))
+            {
+              BottomUp (i);
+            }
+          else
+            {
+              TopDown (i);
+            }
           return;
         }
     }
   NS_ASSERT (false);
 }
 
-} // namespace ns3
+void
+HeapScheduler::RemoveCancelled (std::vector<Event> &cancelled)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t last = Root ();
+  for (uint32_t i = Root (); i < m_heap.size (); i++)
+    {
+      if (m_heap[i].impl->IsCancelled ())
+        {
+          cancelled.push_back (m_heap[i]);
+        }
+      else
+        {
+          m_heap[last] = m_heap[i];
+          last++;
+        }
+    }
+  m_heap.resize (last);
+  for (uint32_t i = Parent (Last ()); i >= Root (); i--)
+    {
+      TopDown (i);
+    }
+}
 
+} // namespace ns3
@@ -59,10 +59,12 @@ public:
   virtual ~HeapScheduler ();
 
   virtual void Insert (const Event &ev);
+  virtual void InsertBatch (const std::vector<Event> &events);
   virtual bool IsEmpty (void) const;
   virtual Event PeekNext (void) const;
   virtual Event RemoveNext (void);
   virtual void Remove (const Event &ev);
+  virtual void RemoveCancelled (std::vector<Event> &cancelled);
 
 private:
   typedef std::vector<Event> BinaryHeap;
@@ -80,7 +82,7 @@ private:
   inline uint32_t Smallest (uint32_t a, uint32_t b) const;
 
   inline void Exch (uint32_t a, uint32_t b);
-  void BottomUp (void);
+  void BottomUp (uint32_t start);
   void TopDown (uint32_t start);
 
   BinaryHeap m_heap;
@@ -70,6 +70,22 @@ ListScheduler::Insert (const Event &ev)
     }
   m_events.push_back (ev);
 }
+void
+ListScheduler::InsertBatch (const std::vector<Event> &events)
+{
+  NS_LOG_FUNCTION (this << events.size ());
+  // merge the sorted events in a single pass over the list
+  EventsI i = m_events.begin ();
+  for (std::vector<Event>::const_iterator ev = events.begin (); ev != events.end (); ev++)
+    {
+      while (i != m_events.end () && !(ev->key < i->key))
+        {
+          i++;
+        }
+      m_events.insert (i, *ev);
+    }
+}
+
 bool
 ListScheduler::IsEmpty (void) const
 {
@@ -108,4 +124,23 @@ ListScheduler::Remove (const Event &ev)
   NS_ASSERT (false);
 }
 
+void
+ListScheduler::RemoveCancelled (std::vector<Event> &cancelled)
+{
+  NS_LOG_FUNCTION (this);
+  EventsI i = m_events.begin ();
+  while (i != m_events.end ())
+    {
+      if (i->impl->IsCancelled ())
+        {
+          cancelled.push_back (*i);
+          i = m_events.erase (i);
+        }
+      else
+        {
+          i++;
+        }
+    }
+}
+
 } // namespace ns3
@@ -52,10 +52,12 @@ public:
   virtual ~ListScheduler ();
 
   virtual void Insert (const Event &ev);
+  virtual void InsertBatch (const std::vector<Event> &events);
   virtual bool IsEmpty (void) const;
   virtual Event PeekNext (void) const;
   virtual Event RemoveNext (void);
   virtual void Remove (const Event &ev);
+  virtual void RemoveCancelled (std::vector<Event> &cancelled);
 
 private:
   typedef std::list<Event> Events;
@@ -66,6 +66,21 @@ MapScheduler::Insert (const Event &ev)
   NS_ASSERT (result.second);
 }
 
+void
+MapScheduler::InsertBatch (const std::vector<Event> &events)
+{
+  NS_LOG_FUNCTION (this << events.size ());
+  // each event is likely to go right after the previous one
+  EventMap::size_type size = m_list.size ();
+  EventMapI hint = m_list.end ();
+  for (std::vector<Event>::const_iterator i = events.begin (); i != events.end (); i++)
+    {
+      hint = m_list.insert (hint, std::make_pair (i->key, i->impl));
+      hint++;
+    }
+  NS_ASSERT (m_list.size () == size + events.size ());
+}
+
 bool
 MapScheduler::IsEmpty (void) const
 {
@@ -109,4 +124,33 @@ MapScheduler::Remove (const Event &ev)
   m_list.erase (i);
 }
 
+bool
+MapScheduler::IsRemoveCheap (void) const
+{
+  // a map erases by key in logarithmic time, as it inserts
+  return true;
+}
+
+void
+MapScheduler::RemoveCancelled (std::vector<Event> &cancelled)
+{
+  NS_LOG_FUNCTION (this);
+  EventMapI i = m_list.begin ();
+  while (i != m_list.end ())
+    {
+      if (i->second->IsCancelled ())
+        {
+          Event ev;
+          ev.impl = i->second;
+          ev.key = i->first;
+          cancelled.push_back (ev);
+          m_list.erase (i++);
+        }
+      else
+        {
+          i++;
+        }
+    }
+}
+
 } // namespace ns3
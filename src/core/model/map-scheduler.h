@@ -50,10 +50,13 @@ public:
   virtual ~MapScheduler ();
 
   virtual void Insert (const Event &ev);
+  virtual void InsertBatch (const std::vector<Event> &events);
   virtual bool IsEmpty (void) const;
   virtual Event PeekNext (void) const;
   virtual Event RemoveNext (void);
   virtual void Remove (const Event &ev);
+  virtual void RemoveCancelled (std::vector<Event> &cancelled);
+  virtual bool IsRemoveCheap (void) const;
 private:
   typedef std::map<Scheduler::EventKey, EventImpl*> EventMap;
   typedef std::map<Scheduler::EventKey, EventImpl*>::iterator EventMapI;
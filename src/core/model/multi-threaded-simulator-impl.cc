@@ -0,0 +1,744 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulator.h"
+#include "multi-threaded-simulator-impl.h"
+#include "batch-event.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "system-thread.h"
+
+#include "ptr.h"
+#include "uinteger.h"
+#include "callback.h"
+#include "fatal-error.h"
+#include "abort.h"
+#include "assert.h"
+#include "log.h"
+
+#include <algorithm>
+#include <pthread.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Implementation of class ns3::MultiThreadedSimulatorImpl.
+ */
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("MultiThreadedSimulatorImpl");
+
+/**
+ * \ingroup simulator
+ * The point where the threads of MultiThreadedSimulatorImpl::Run wait
+ * for each other between the steps of a window.
+ */
+class SimulatorBarrier
+{
+public:
+  SimulatorBarrier ();
+  ~SimulatorBarrier ();
+  /**
+   * Wait until all the threads have called Wait.
+   *
+   * \param threads the number of threads
+   * \param last called by the last thread to arrive, before the others
+   * are released
+   */
+  void Wait (uint32_t threads, const Callback<void> &last);
+
+private:
+  pthread_mutex_t m_mutex;  //!< protects the counters
+  pthread_cond_t m_cond;    //!< signalled when the last thread arrives
+  uint32_t m_arrived;       //!< number of threads waiting
+  uint64_t m_generation;    //!< number of times all the threads arrived
+};
+
+SimulatorBarrier::SimulatorBarrier ()
+  : m_arrived (0),
+    m_generation (0)
+{
+  pthread_mutex_init (&m_mutex, 0);
+  pthread_cond_init (&m_cond, 0);
+}
+
+SimulatorBarrier::~SimulatorBarrier ()
+{
+  pthread_mutex_destroy (&m_mutex);
+  pthread_cond_destroy (&m_cond);
+}
+
+void
+SimulatorBarrier::Wait (uint32_t threads, const Callback<void> &last)
+{
+  pthread_mutex_lock (&m_mutex);
+  uint64_t generation = m_generation;
+  m_arrived++;
+  if (m_arrived == threads)
+    {
+      if (!last.IsNull ())
+        {
+          last ();
+        }
+      m_arrived = 0;
+      m_generation++;
+      pthread_cond_broadcast (&m_cond);
+    }
+  else
+    {
+      while (generation == m_generation)
+        {
+          pthread_cond_wait (&m_cond, &m_mutex);
+        }
+    }
+  pthread_mutex_unlock (&m_mutex);
+}
+
+NS_OBJECT_ENSURE_REGISTERED (MultiThreadedSimulatorImpl);
+
+thread_local MultiThreadedSimulatorImpl::Partition *MultiThreadedSimulatorImpl::m_current = 0;
+
+TypeId
+MultiThreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultiThreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<MultiThreadedSimulatorImpl> ()
+    .AddAttribute ("Threads",
+                   "The number of partitions of the contexts, each run by its own thread.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&MultiThreadedSimulatorImpl::SetThreads,
+                                         &MultiThreadedSimulatorImpl::GetThreads),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Lookahead",
+                   "The minimum delay of the events scheduled on another partition, "
+                   "e.g. the smallest propagation delay between the nodes.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&MultiThreadedSimulatorImpl::m_lookahead),
+                   MakeTimeChecker (Seconds (0)))
+  ;
+  return tid;
+}
+
+MultiThreadedSimulatorImpl::MultiThreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  m_stop = false;
+  m_running = false;
+  m_windowEnd = 0;
+  m_done = false;
+  m_barrier = new SimulatorBarrier ();
+}
+
+MultiThreadedSimulatorImpl::~MultiThreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      delete m_partitions[i];
+    }
+  m_partitions.clear ();
+  delete m_barrier;
+  m_barrier = 0;
+}
+
+void
+MultiThreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      Partition *p = m_partitions[i];
+      while (p->events != 0 && !p->events->IsEmpty ())
+        {
+          Scheduler::Event next = p->events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      p->events = 0;
+    }
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultiThreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultiThreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  m_schedulerFactory = schedulerFactory;
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      Partition *p = m_partitions[i];
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      if (p->events != 0)
+        {
+          while (!p->events->IsEmpty ())
+            {
+              Scheduler::Event next = p->events->RemoveNext ();
+              scheduler->Insert (next);
+            }
+        }
+      p->events = scheduler;
+    }
+}
+
+void
+MultiThreadedSimulatorImpl::SetThreads (uint32_t threads)
+{
+  NS_LOG_FUNCTION (this << threads);
+  NS_ABORT_MSG_IF (m_running, "Cannot change the number of threads while running");
+  NS_ASSERT (threads > 0);
+  if (threads == m_partitions.size ())
+    {
+      return;
+    }
+  // take the events out of the old partitions
+  std::vector<Scheduler::Event> events;
+  uint32_t firstFreeUid = 0;
+  uint64_t currentTs = m_partitions.empty () ? 0 : m_partitions[0]->currentTs;
+  bool hasEvents = false;
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      Partition *p = m_partitions[i];
+      if (p->events != 0)
+        {
+          hasEvents = true;
+          while (!p->events->IsEmpty ())
+            {
+              events.push_back (p->events->RemoveNext ());
+            }
+        }
+      firstFreeUid = std::max<uint32_t> (firstFreeUid, p->uid * m_partitions.size () + p->index);
+      // all the pending events are after the earliest time
+      currentTs = std::min (currentTs, p->currentTs);
+      delete p;
+    }
+  m_partitions.clear ();
+
+  for (uint32_t i = 0; i < threads; i++)
+    {
+      Partition *p = new Partition ();
+      p->index = i;
+      if (hasEvents)
+        {
+          p->events = m_schedulerFactory.Create<Scheduler> ();
+        }
+      // uids are allocated from 4.
+      // uid 0 is "invalid" events
+      // uid 1 is "now" events
+      // uid 2 is "destroy" events
+      p->uid = std::max<uint32_t> (4, firstFreeUid / threads + 1);
+      p->currentTs = currentTs;
+      p->currentUid = 0;
+      p->currentContext = 0xffffffff;
+      p->unscheduledEvents = 0;
+      p->stop = false;
+      p->next = 0;
+      m_partitions.push_back (p);
+    }
+  for (std::vector<Scheduler::Event>::const_iterator i = events.begin (); i != events.end (); i++)
+    {
+      Partition *p = GetPartition (i->key.m_context);
+      p->unscheduledEvents++;
+      p->events->Insert (*i);
+    }
+}
+
+uint32_t
+MultiThreadedSimulatorImpl::GetThreads (void) const
+{
+  return m_partitions.size ();
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultiThreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+MultiThreadedSimulatorImpl::Partition *
+MultiThreadedSimulatorImpl::GetPartition (uint32_t context) const
+{
+  if (context == 0xffffffff)
+    {
+      return m_partitions[0];
+    }
+  return m_partitions[context % m_partitions.size ()];
+}
+
+uint32_t
+MultiThreadedSimulatorImpl::GetContextPartition (uint32_t context) const
+{
+  return GetPartition (context)->index;
+}
+
+MultiThreadedSimulatorImpl::Partition *
+MultiThreadedSimulatorImpl::GetCurrent (void) const
+{
+  return m_current != 0 ? m_current : m_partitions[0];
+}
+
+uint32_t
+MultiThreadedSimulatorImpl::AllocateUid (Partition *p)
+{
+  return p->uid++ * m_partitions.size () + p->index;
+}
+
+void
+MultiThreadedSimulatorImpl::Send (Partition *from, const Scheduler::Event &ev)
+{
+  Partition *to = GetPartition (ev.key.m_context);
+  if (to == from || !m_running)
+    {
+      to->unscheduledEvents++;
+      to->events->Insert (ev);
+      return;
+    }
+  if (ev.key.m_ts < m_windowEnd)
+    {
+      NS_FATAL_ERROR ("Event for context " << ev.key.m_context << " at " << TimeStep (ev.key.m_ts) <<
+                      " scheduled from context " << from->currentContext << " at " <<
+                      TimeStep (from->currentTs) << ", less than the Lookahead " << m_lookahead <<
+                      " in the future");
+    }
+  CriticalSection cs (to->inboxMutex);
+  to->inbox.push_back (ev);
+}
+
+void
+MultiThreadedSimulatorImpl::ProcessOneEvent (Partition *p)
+{
+  Scheduler::Event next = p->events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= p->currentTs);
+  p->unscheduledEvents--;
+
+  NS_LOG_LOGIC ("handle " << next.key.m_ts);
+  p->currentTs = next.key.m_ts;
+  p->currentContext = next.key.m_context;
+  p->currentUid = next.key.m_uid;
+  // the events scheduled from now on must come after this one, which
+  // may come from another partition
+  uint32_t uid = next.key.m_uid / m_partitions.size () + 1;
+  if (uid > p->uid)
+    {
+      p->uid = uid;
+    }
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+void
+MultiThreadedSimulatorImpl::PlanWindow (void)
+{
+  uint64_t start = 0xffffffffffffffffULL;
+  bool stop = false;
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      start = std::min (start, m_partitions[i]->next);
+      stop = stop || m_partitions[i]->stop;
+    }
+  m_done = stop || start == 0xffffffffffffffffULL;
+  if (stop)
+    {
+      m_stop = true;
+    }
+
+  uint64_t end = 0xffffffffffffffffULL;
+  if (m_partitions.size () > 1)
+    {
+      uint64_t lookahead = m_lookahead.GetTimeStep ();
+      end = start < end - lookahead ? start + lookahead : end;
+    }
+  {
+    CriticalSection cs (m_stopMutex);
+    if (!m_stopTimes.empty () && *m_stopTimes.begin () < end)
+      {
+        // the other partitions run the events of the stop time too
+        end = *m_stopTimes.begin () + 1;
+      }
+  }
+  m_windowEnd = end;
+}
+
+void
+MultiThreadedSimulatorImpl::RunPartition (Partition *p)
+{
+  m_current = p;
+  uint32_t threads = m_partitions.size ();
+  Callback<void> plan = MakeCallback (&MultiThreadedSimulatorImpl::PlanWindow, this);
+  Callback<void> none;
+  while (true)
+    {
+      {
+        CriticalSection cs (p->inboxMutex);
+        p->incoming.swap (p->inbox);
+      }
+      if (!p->incoming.empty ())
+        {
+          p->unscheduledEvents += p->incoming.size ();
+          p->events->InsertBatch (p->incoming);
+          p->incoming.clear ();
+        }
+      p->next = p->events->IsEmpty () ? 0xffffffffffffffffULL : p->events->PeekNext ().key.m_ts;
+      m_barrier->Wait (threads, plan);
+      if (m_done)
+        {
+          break;
+        }
+      while (!p->stop && !p->events->IsEmpty () && p->events->PeekNext ().key.m_ts < m_windowEnd)
+        {
+          ProcessOneEvent (p);
+        }
+      // all the events sent during the window are in the inboxes
+      m_barrier->Wait (threads, none);
+    }
+  m_current = 0;
+}
+
+void
+MultiThreadedSimulatorImpl::RunThread (std::pair<MultiThreadedSimulatorImpl *, uint32_t> args)
+{
+  args.first->RunPartition (args.first->m_partitions[args.second]);
+}
+
+void
+MultiThreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (m_partitions.size () > 1 && !m_lookahead.IsStrictlyPositive (),
+                   "The Lookahead must be positive with more than one thread");
+  m_stop = false;
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      m_partitions[i]->stop = false;
+    }
+  m_running = true;
+
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 1; i < m_partitions.size (); i++)
+    {
+      Ptr<SystemThread> thread = Create<SystemThread> (MakeBoundCallback (&MultiThreadedSimulatorImpl::RunThread,
+                                                                          std::make_pair (this, i)));
+      thread->Start ();
+      threads.push_back (thread);
+    }
+  RunPartition (m_partitions[0]);
+  for (uint32_t i = 0; i < threads.size (); i++)
+    {
+      threads[i]->Join ();
+    }
+  m_running = false;
+
+  // If a partition stopped naturally by lack of events, make a
+  // consistency test to check that we didn't lose any events along the way.
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      NS_ASSERT (!m_partitions[i]->events->IsEmpty () || m_partitions[i]->unscheduledEvents == 0);
+    }
+}
+
+bool
+MultiThreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stop)
+    {
+      return true;
+    }
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      if (!m_partitions[i]->events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultiThreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  GetCurrent ()->stop = true;
+}
+
+void
+MultiThreadedSimulatorImpl::Stop (Time const &time)
+{
+  NS_LOG_FUNCTION (this << time.GetTimeStep ());
+  uint64_t ts = (time + TimeStep (GetCurrent ()->currentTs)).GetTimeStep ();
+  {
+    CriticalSection cs (m_stopMutex);
+    m_stopTimes.insert (ts);
+  }
+  Simulator::Schedule (time, &MultiThreadedSimulatorImpl::StopAt, this, ts);
+}
+
+void
+MultiThreadedSimulatorImpl::StopAt (uint64_t ts)
+{
+  NS_LOG_FUNCTION (this << ts);
+  {
+    CriticalSection cs (m_stopMutex);
+    m_stopTimes.erase (m_stopTimes.find (ts));
+  }
+  Stop ();
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultiThreadedSimulatorImpl::Schedule (Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << time.GetTimeStep () << event);
+  Partition *p = GetCurrent ();
+
+  Time tAbsolute = time + TimeStep (p->currentTs);
+
+  NS_ASSERT (tAbsolute.IsPositive ());
+  NS_ASSERT (tAbsolute >= TimeStep (p->currentTs));
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+  ev.key.m_context = p->currentContext;
+  ev.key.m_uid = AllocateUid (p);
+  p->unscheduledEvents++;
+  p->events->Insert (ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultiThreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << time.GetTimeStep () << event);
+  Partition *p = GetCurrent ();
+
+  Time tAbsolute = time + TimeStep (p->currentTs);
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+  ev.key.m_context = context;
+  ev.key.m_uid = AllocateUid (p);
+  Send (p, ev);
+}
+
+void
+MultiThreadedSimulatorImpl::ScheduleWithContexts (BatchEventImpl *event)
+{
+  NS_LOG_FUNCTION (this << event);
+
+  uint32_t n = event->GetN ();
+  if (n == 0)
+    {
+      SimulatorImpl::ScheduleWithContexts (event);
+      return;
+    }
+  Partition *p = GetCurrent ();
+  Partition *to = GetPartition (event->GetContext (0));
+  for (uint32_t i = 1; i < n; i++)
+    {
+      // the targets share the event, and run it one after the other
+      NS_ABORT_MSG_IF (GetPartition (event->GetContext (i)) != to,
+                       "The targets of a batch event are in several partitions");
+    }
+  std::vector<Scheduler::Event> &batch = p->incoming;
+  batch.resize (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (i + 1 < n)
+        {
+          event->Ref ();
+        }
+      Scheduler::Event &ev = batch[i];
+      ev.impl = event;
+      ev.key.m_ts = (uint64_t) (event->GetDelay (i) + TimeStep (p->currentTs)).GetTimeStep ();
+      ev.key.m_context = event->GetContext (i);
+      ev.key.m_uid = AllocateUid (p);
+    }
+  if (to == p || !m_running)
+    {
+      to->unscheduledEvents += n;
+      to->events->InsertBatch (batch);
+    }
+  else
+    {
+      for (uint32_t i = 0; i < n; i++)
+        {
+          Send (p, batch[i]);
+        }
+    }
+  batch.clear ();
+}
+
+EventId
+MultiThreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  Partition *p = GetCurrent ();
+
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = p->currentTs;
+  ev.key.m_context = p->currentContext;
+  ev.key.m_uid = AllocateUid (p);
+  p->unscheduledEvents++;
+  p->events->Insert (ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+EventId
+MultiThreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  NS_ASSERT_MSG (!m_running, "Simulator::ScheduleDestroy Thread-unsafe invocation!");
+  Partition *p = GetCurrent ();
+
+  EventId id (Ptr<EventImpl> (event, false), p->currentTs, 0xffffffff, 2);
+  m_destroyEvents.push_back (id);
+  p->uid++;
+  return id;
+}
+
+Time
+MultiThreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  return TimeStep (GetCurrent ()->currentTs);
+}
+
+Time
+MultiThreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - GetCurrent ()->currentTs);
+    }
+}
+
+void
+MultiThreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Partition *p = GetCurrent ();
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  p->events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  p->unscheduledEvents--;
+}
+
+void
+MultiThreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultiThreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0 ||
+          id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  Partition *p = GetCurrent ();
+  if (id.PeekEventImpl () == 0 ||
+      id.GetTs () < p->currentTs ||
+      (id.GetTs () == p->currentTs &&
+       id.GetUid () <= p->currentUid) ||
+      id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultiThreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultiThreadedSimulatorImpl::GetContext (void) const
+{
+  return GetCurrent ()->currentContext;
+}
+
+} // namespace ns3
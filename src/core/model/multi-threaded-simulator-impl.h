@@ -0,0 +1,221 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTI_THREADED_SIMULATOR_IMPL_H
+#define MULTI_THREADED_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "object-factory.h"
+#include "system-mutex.h"
+#include "nstime.h"
+#include "ptr.h"
+
+#include <list>
+#include <set>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Declaration of class ns3::MultiThreadedSimulatorImpl.
+ */
+
+namespace ns3 {
+
+class SimulatorBarrier;
+
+/**
+ * \ingroup simulator
+ *
+ * A simulator implementation which runs the events of a single process
+ * on several threads, without MPI.
+ *
+ * The events are split between as many partitions as the Threads
+ * attribute by their context: the events of context \c c go to the
+ * partition <tt>c % Threads</tt>, the events without a context to the
+ * first one.  Each partition has its own event list and its own time,
+ * and is run by its own thread.
+ *
+ * The partitions are synchronized by conservative time windows: all of
+ * them run their events below the time of the earliest pending event
+ * plus the Lookahead attribute, then wait for each other.  An event
+ * scheduled on another partition must thus be at least Lookahead in the
+ * future; for wireless nodes, this is the smallest propagation delay
+ * between them, as given by YansWifiChannel::GetMinimumDelay:
+ * \code
+ *   Config::SetGlobal ("SimulatorImplementationType",
+ *                      StringValue ("ns3::MultiThreadedSimulatorImpl"));
+ *   ...
+ *   Ptr<SimulatorImpl> impl = Simulator::GetImplementation ();
+ *   impl->SetAttribute ("Threads", UintegerValue (4));
+ *   impl->SetAttribute ("Lookahead", TimeValue (channel->GetMinimumDelay ()));
+ *   Simulator::Run ();
+ * \endcode
+ *
+ * The events of a partition run in the same order whatever the threads
+ * do, and with a single thread in the same order as with
+ * DefaultSimulatorImpl.  The events must however only touch the objects
+ * of their own partition: ns-3 objects are not thread-safe, so models
+ * which share objects between nodes must give each partition, as
+ * returned by Simulator::GetContextPartition, its own copy, as
+ * YansWifiChannel does with the frames it delivers.  Batches of
+ * Simulator::ScheduleWithContexts cannot span several partitions.
+ *
+ * Simulator::Stop () stops the partition which calls it at once, and
+ * the others at the end of the current window.  Simulator::Stop (Time)
+ * stops the partition which calls it at the stop time as
+ * DefaultSimulatorImpl does, before the events scheduled after the
+ * call, and the others after all the events of the stop time; with a
+ * single thread, the same events run as with DefaultSimulatorImpl.
+ */
+class MultiThreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  static TypeId GetTypeId (void);
+
+  MultiThreadedSimulatorImpl ();
+  ~MultiThreadedSimulatorImpl ();
+
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (Time const &time);
+  virtual EventId Schedule (Time const &time, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event);
+  virtual void ScheduleWithContexts (BatchEventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual uint32_t GetContextPartition (uint32_t context) const;
+
+  /**
+   * \param threads the number of partitions, each run by its own thread
+   */
+  void SetThreads (uint32_t threads);
+  /**
+   * \return the number of partitions
+   */
+  uint32_t GetThreads (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /// The events of a group of contexts, run by one thread
+  struct Partition
+  {
+    uint32_t index;           //!< position in m_partitions
+    Ptr<Scheduler> events;    //!< the pending events
+    uint32_t uid;             //!< the uid of its next event is uid * partitions + index
+    uint64_t currentTs;       //!< time of the event being run
+    uint32_t currentUid;      //!< uid of the event being run
+    uint32_t currentContext;  //!< context of the event being run
+    int unscheduledEvents;    //!< number of events in the list, for validation
+    bool stop;                //!< Stop was called by one of its events
+    uint64_t next;            //!< time of its next event, at the start of a window
+    SystemMutex inboxMutex;   //!< protects inbox
+    /// events scheduled by the other partitions during the current window
+    std::vector<Scheduler::Event> inbox;
+    /// events of the inbox being inserted in the list
+    std::vector<Scheduler::Event> incoming;
+  };
+
+  /**
+   * \param context a context
+   * \return the partition of the events of that context
+   */
+  Partition *GetPartition (uint32_t context) const;
+  /**
+   * \return the partition run by the calling thread, the first one
+   * outside of Run
+   */
+  Partition *GetCurrent (void) const;
+  /**
+   * \param p a partition
+   * \return a new uid for an event scheduled by that partition
+   */
+  uint32_t AllocateUid (Partition *p);
+  /**
+   * Put an event in the list of its partition, or in its inbox while
+   * the other threads run.
+   *
+   * \param from the partition scheduling the event
+   * \param ev the event
+   */
+  void Send (Partition *from, const Scheduler::Event &ev);
+  /**
+   * Run the windows of a partition until the simulation stops.
+   *
+   * \param p the partition
+   */
+  void RunPartition (Partition *p);
+  /**
+   * The body of the threads of the partitions but the first one.
+   *
+   * \param args the simulator and the index of the partition
+   */
+  static void RunThread (std::pair<MultiThreadedSimulatorImpl *, uint32_t> args);
+  /**
+   * Compute the next window from the next event of each partition,
+   * once all of them have published it.
+   */
+  void PlanWindow (void);
+  /**
+   * Run the next event of a partition.
+   *
+   * \param p the partition
+   */
+  void ProcessOneEvent (Partition *p);
+  /**
+   * The event of Stop (Time): stop the partition, and forget the stop
+   * time.
+   *
+   * \param ts the stop time
+   */
+  void StopAt (uint64_t ts);
+
+  typedef std::list<EventId> DestroyEvents;
+  DestroyEvents m_destroyEvents;
+  bool m_stop;
+
+  ObjectFactory m_schedulerFactory;   //!< factory of the event lists
+  std::vector<Partition *> m_partitions;
+  Time m_lookahead;                   //!< minimum delay of the events between partitions
+
+  bool m_running;                     //!< the threads of Run are running
+  uint64_t m_windowEnd;               //!< the events before it run in the current window
+  bool m_done;                        //!< the current window is the last one
+  SimulatorBarrier *m_barrier;        //!< where the threads wait for each other
+  SystemMutex m_stopMutex;            //!< protects m_stopTimes
+  std::multiset<uint64_t> m_stopTimes; //!< times of the pending Stop (Time)
+
+  static thread_local Partition *m_current; //!< the partition run by this thread
+};
+
+} // namespace ns3
+
+#endif /* MULTI_THREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,248 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "quad-heap-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::QuadHeapScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("QuadHeapScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (QuadHeapScheduler);
+
+TypeId
+QuadHeapScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::QuadHeapScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<QuadHeapScheduler> ()
+  ;
+  return tid;
+}
+
+QuadHeapScheduler::QuadHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+QuadHeapScheduler::~QuadHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+QuadHeapScheduler::SiftUp (uint32_t index)
+{
+  EventKey key = m_keys[index];
+  EventImpl *impl = m_impls[index];
+  while (index > 0)
+    {
+      uint32_t parent = (index - 1) / 4;
+      if (!(key < m_keys[parent]))
+        {
+          break;
+        }
+      m_keys[index] = m_keys[parent];
+      m_impls[index] = m_impls[parent];
+      index = parent;
+    }
+  m_keys[index] = key;
+  m_impls[index] = impl;
+}
+
+void
+QuadHeapScheduler::SiftDown (uint32_t index)
+{
+  uint32_t size = m_keys.size ();
+  EventKey key = m_keys[index];
+  EventImpl *impl = m_impls[index];
+  while (true)
+    {
+      uint32_t first = 4 * index + 1;
+      if (first >= size)
+        {
+          break;
+        }
+      uint32_t end = std::min (first + 4, size);
+      uint32_t smallest = first;
+      for (uint32_t child = first + 1; child < end; child++)
+        {
+          if (m_keys[child] < m_keys[smallest])
+            {
+              smallest = child;
+            }
+        }
+      if (!(m_keys[smallest] < key))
+        {
+          break;
+        }
+      m_keys[index] = m_keys[smallest];
+      m_impls[index] = m_impls[smallest];
+      index = smallest;
+    }
+  m_keys[index] = key;
+  m_impls[index] = impl;
+}
+
+void
+QuadHeapScheduler::Heapify (void)
+{
+  // from the parent of the last event up to the root
+  for (uint32_t i = (m_keys.size () + 2) / 4; i > 0; i--)
+    {
+      SiftDown (i - 1);
+    }
+}
+
+void
+QuadHeapScheduler::Drop (uint32_t index)
+{
+  uint32_t last = m_keys.size () - 1;
+  if (index == last)
+    {
+      m_keys.pop_back ();
+      m_impls.pop_back ();
+      return;
+    }
+  m_keys[index] = m_keys[last];
+  m_impls[index] = m_impls[last];
+  m_keys.pop_back ();
+  m_impls.pop_back ();
+  if (index > 0 && m_keys[index] < m_keys[(index - 1) / 4])
+    {
+      SiftUp (index);
+    }
+  else
+    {
+      SiftDown (index);
+    }
+}
+
+void
+QuadHeapScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  m_keys.push_back (ev.key);
+  m_impls.push_back (ev.impl);
+  SiftUp (m_keys.size () - 1);
+}
+
+void
+QuadHeapScheduler::InsertBatch (const std::vector<Event> &events)
+{
+  NS_LOG_FUNCTION (this << events.size ());
+  if (events.size () < m_keys.size ())
+    {
+      for (std::vector<Event>::const_iterator i = events.begin (); i != events.end (); i++)
+        {
+          Insert (*i);
+        }
+      return;
+    }
+  // at least as many new events as old ones: rebuilding the heap
+  // takes fewer comparisons than sifting up each new event.
+  for (std::vector<Event>::const_iterator i = events.begin (); i != events.end (); i++)
+    {
+      m_keys.push_back (i->key);
+      m_impls.push_back (i->impl);
+    }
+  Heapify ();
+}
+
+bool
+QuadHeapScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_keys.empty ();
+}
+
+Scheduler::Event
+QuadHeapScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Event next;
+  next.impl = m_impls[0];
+  next.key = m_keys[0];
+  return next;
+}
+
+Scheduler::Event
+QuadHeapScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Event next;
+  next.impl = m_impls[0];
+  next.key = m_keys[0];
+  Drop (0);
+  return next;
+}
+
+void
+QuadHeapScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint32_t uid = ev.key.m_uid;
+  for (uint32_t i = 0; i < m_keys.size (); i++)
+    {
+      if (uid == m_keys[i].m_uid)
+        {
+          NS_ASSERT (m_impls[i] == ev.impl);
+          Drop (i);
+          return;
+        }
+    }
+  NS_ASSERT (false);
+}
+
+void
+QuadHeapScheduler::RemoveCancelled (std::vector<Event> &cancelled)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t last = 0;
+  for (uint32_t i = 0; i < m_keys.size (); i++)
+    {
+      if (m_impls[i]->IsCancelled ())
+        {
+          Event ev;
+          ev.impl = m_impls[i];
+          ev.key = m_keys[i];
+          cancelled.push_back (ev);
+        }
+      else
+        {
+          m_keys[last] = m_keys[i];
+          m_impls[last] = m_impls[i];
+          last++;
+        }
+    }
+  m_keys.resize (last);
+  m_impls.resize (last);
+  Heapify ();
+}
+
+} // namespace ns3
@@ -0,0 +1,94 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QUAD_HEAP_SCHEDULER_H
+#define QUAD_HEAP_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Declaration of ns3::QuadHeapScheduler class.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a 4-ary heap event scheduler
+ *
+ * An implicit heap where each node has four children: the heap is half
+ * as deep as a binary one, and the four keys compared to sift an event
+ * down are next to each other in memory.
+ *
+ * The keys are kept in their own array, apart from the EventImpl
+ * pointers, so that the comparisons only touch the keys: four of them
+ * fit in a 64-byte cache line.  Events are moved into a hole rather than
+ * swapped.
+ *
+ * The root is at index 0, the children of i are 4i+1 to 4i+4.
+ */
+class QuadHeapScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  QuadHeapScheduler ();
+  virtual ~QuadHeapScheduler ();
+
+  virtual void Insert (const Event &ev);
+  virtual void InsertBatch (const std::vector<Event> &events);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+  virtual void RemoveCancelled (std::vector<Event> &cancelled);
+
+private:
+  /**
+   * Move the event at a position up to its place.
+   *
+   * \param index the position of the event
+   */
+  void SiftUp (uint32_t index);
+  /**
+   * Move the event at a position down to its place.
+   *
+   * \param index the position of the event
+   */
+  void SiftDown (uint32_t index);
+  /**
+   * Move all the events to their place.
+   */
+  void Heapify (void);
+  /**
+   * Replace the event at a position by the last one, and move that one
+   * to its place.
+   *
+   * \param index the position of the event to drop
+   */
+  void Drop (uint32_t index);
+
+  std::vector<EventKey> m_keys;     //!< the keys of the events, in heap order
+  std::vector<EventImpl *> m_impls; //!< the implementation of the events, same order
+};
+
+} // namespace ns3
+
+#endif /* QUAD_HEAP_SCHEDULER_H */
@@ -35,6 +35,7 @@
 #include "rng-seed-manager.h"
 #include <cmath>
 #include <iostream>
+#include <set>
 
 /**
  * \file
@@ -71,17 +72,53 @@ RandomVariableStream::GetTypeId (void)
   return tid;
 }
 
+/**
+ * \ingroup randomvariable
+ * \returns The RandomVariableStream objects alive.
+ *
+ * Never deleted, so that streams held by static objects can still
+ * unregister themselves at program exit.
+ */
+static std::set<RandomVariableStream *> &
+GetAllStreams (void)
+{
+  static std::set<RandomVariableStream *> *streams = new std::set<RandomVariableStream *> ();
+  return *streams;
+}
+
 RandomVariableStream::RandomVariableStream()
-  : m_rng (0)
+  : m_rng (0),
+    m_rngStream (0)
 {
   NS_LOG_FUNCTION (this);
+  GetAllStreams ().insert (this);
 }
 RandomVariableStream::~RandomVariableStream()
 {
   NS_LOG_FUNCTION (this);
+  GetAllStreams ().erase (this);
   delete m_rng;
 }
 
+void
+RandomVariableStream::ReseedAll (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  std::set<RandomVariableStream *> &streams = GetAllStreams ();
+  for (std::set<RandomVariableStream *>::iterator i = streams.begin (); i != streams.end (); ++i)
+    {
+      RandomVariableStream *stream = *i;
+      if (stream->m_rng == 0)
+        {
+          continue;
+        }
+      delete stream->m_rng;
+      stream->m_rng = new RngStream (RngSeedManager::GetSeed (),
+                                     stream->m_rngStream,
+                                     RngSeedManager::GetRun ());
+    }
+}
+
 void
 RandomVariableStream::SetAntithetic(bool isAntithetic)
 {
@@ -107,6 +144,7 @@ RandomVariableStream::SetStream (int64_t stream)
       // number assignment.
       uint64_t nextStream = RngSeedManager::GetNextStreamIndex ();
       NS_ASSERT(nextStream <= ((1ULL)<<63));
+      m_rngStream = nextStream;
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              nextStream,
                              RngSeedManager::GetRun ());
@@ -117,6 +155,7 @@ RandomVariableStream::SetStream (int64_t stream)
       // number assignment.
       uint64_t base = ((1ULL)<<63);
       uint64_t target = base + stream;
+      m_rngStream = target;
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              target,
                              RngSeedManager::GetRun ());
@@ -133,6 +133,17 @@ public:
    */
   virtual uint32_t GetInteger (void) = 0;
 
+  /**
+   * \brief Re-create the underlying RNG stream of every existing
+   * RandomVariableStream from the current global seed and run number.
+   *
+   * Each object keeps its stream number, so this gives the same
+   * values as if all objects had been created with the new run
+   * number.  Used to start independent replications from a copy of
+   * an already built scenario, e.g. in a child process after fork().
+   */
+  static void ReseedAll (void);
+
 protected:
   /**
    * \brief Returns a pointer to the underlying RNG stream.
@@ -154,6 +165,9 @@ private:
 
   /// The stream number for this RNG stream.
   int64_t m_stream;
+
+  /// The index of the underlying RngStream, automatic or deterministic.
+  uint64_t m_rngStream;
 };
 
 /**
@@ -0,0 +1,203 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "recording-scheduler.h"
+#include "map-scheduler.h"
+#include "object-factory.h"
+#include "string.h"
+#include "fatal-error.h"
+#include "assert.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::RecordingScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("RecordingScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (RecordingScheduler);
+
+TypeId
+RecordingScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::RecordingScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<RecordingScheduler> ()
+    .AddAttribute ("Scheduler", "The type of the scheduler to record the operations of.",
+                   TypeIdValue (MapScheduler::GetTypeId ()),
+                   MakeTypeIdAccessor (&RecordingScheduler::SetScheduler,
+                                       &RecordingScheduler::GetScheduler),
+                   MakeTypeIdChecker ())
+    .AddAttribute ("FileName", "The file to write the operations to, none if empty.",
+                   StringValue (""),
+                   MakeStringAccessor (&RecordingScheduler::SetFileName,
+                                       &RecordingScheduler::GetFileName),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+RecordingScheduler::RecordingScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+RecordingScheduler::~RecordingScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+RecordingScheduler::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_scheduler = 0;
+  if (m_file.is_open ())
+    {
+      m_file.close ();
+    }
+  Scheduler::DoDispose ();
+}
+
+void
+RecordingScheduler::SetScheduler (TypeId type)
+{
+  NS_LOG_FUNCTION (this << type);
+  NS_ASSERT_MSG (m_scheduler == 0 || m_scheduler->IsEmpty (),
+                 "Cannot change the recorded scheduler of pending events");
+  ObjectFactory factory;
+  factory.SetTypeId (type);
+  m_scheduler = factory.Create<Scheduler> ();
+}
+
+TypeId
+RecordingScheduler::GetScheduler (void) const
+{
+  return m_scheduler->GetInstanceTypeId ();
+}
+
+void
+RecordingScheduler::SetFileName (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  if (m_file.is_open ())
+    {
+      m_file.close ();
+    }
+  m_fileName = filename;
+  if (!filename.empty ())
+    {
+      m_file.open (filename.c_str ());
+      if (!m_file.is_open ())
+        {
+          NS_FATAL_ERROR ("Could not open " << filename);
+        }
+    }
+}
+
+std::string
+RecordingScheduler::GetFileName (void) const
+{
+  return m_fileName;
+}
+
+void
+RecordingScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  if (m_file.is_open ())
+    {
+      m_file << "i " << ev.key.m_ts << " " << ev.key.m_uid << " " << ev.key.m_context << "\n";
+    }
+  m_scheduler->Insert (ev);
+}
+
+void
+RecordingScheduler::InsertBatch (const std::vector<Event> &events)
+{
+  NS_LOG_FUNCTION (this << events.size ());
+  if (m_file.is_open ())
+    {
+      m_file << "b " << events.size () << "\n";
+      for (std::vector<Event>::const_iterator i = events.begin (); i != events.end (); i++)
+        {
+          m_file << "i " << i->key.m_ts << " " << i->key.m_uid << " " << i->key.m_context << "\n";
+        }
+    }
+  m_scheduler->InsertBatch (events);
+}
+
+bool
+RecordingScheduler::IsEmpty (void) const
+{
+  return m_scheduler->IsEmpty ();
+}
+
+Scheduler::Event
+RecordingScheduler::PeekNext (void) const
+{
+  return m_scheduler->PeekNext ();
+}
+
+Scheduler::Event
+RecordingScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file.is_open ())
+    {
+      m_file << "n\n";
+    }
+  return m_scheduler->RemoveNext ();
+}
+
+void
+RecordingScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  if (m_file.is_open ())
+    {
+      m_file << "r " << ev.key.m_ts << " " << ev.key.m_uid << "\n";
+    }
+  m_scheduler->Remove (ev);
+}
+
+void
+RecordingScheduler::RemoveCancelled (std::vector<Event> &cancelled)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t first = cancelled.size ();
+  m_scheduler->RemoveCancelled (cancelled);
+  if (m_file.is_open ())
+    {
+      for (uint32_t i = first; i < cancelled.size (); i++)
+        {
+          m_file << "r " << cancelled[i].key.m_ts << " " << cancelled[i].key.m_uid << "\n";
+        }
+    }
+}
+
+bool
+RecordingScheduler::IsRemoveCheap (void) const
+{
+  return m_scheduler->IsRemoveCheap ();
+}
+
+} // namespace ns3
@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RECORDING_SCHEDULER_H
+#define RECORDING_SCHEDULER_H
+
+#include "scheduler.h"
+#include "ptr.h"
+#include "type-id.h"
+#include <fstream>
+#include <string>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Declaration of ns3::RecordingScheduler class.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief write the operations on another scheduler to a file
+ *
+ * This scheduler hands every operation to the scheduler given by the
+ * Scheduler attribute, and writes the ones which change the event list
+ * to the file given by the FileName attribute, one per line:
+ *
+ *   - "i <ts> <uid> <context>" for Insert,
+ *   - "b <n>" for InsertBatch, followed by the "i" lines of its n events,
+ *   - "n" for RemoveNext,
+ *   - "r <ts> <uid>" for Remove, and for each event of RemoveCancelled.
+ *
+ * The traces of a real simulation, recorded with
+ * \code
+ *   --SchedulerType=ns3::RecordingScheduler --ns3::RecordingScheduler::FileName=events.txt
+ * \endcode
+ * can be replayed on each scheduler by utils/bench-scheduler.
+ */
+class RecordingScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  RecordingScheduler ();
+  virtual ~RecordingScheduler ();
+
+  /**
+   * \param type the type of the scheduler to record the operations of
+   */
+  void SetScheduler (TypeId type);
+  /**
+   * \return the type of the recorded scheduler
+   */
+  TypeId GetScheduler (void) const;
+  /**
+   * \param filename the file to write the operations to, none if empty
+   */
+  void SetFileName (std::string filename);
+  /**
+   * \return the file the operations are written to
+   */
+  std::string GetFileName (void) const;
+
+  virtual void Insert (const Event &ev);
+  virtual void InsertBatch (const std::vector<Event> &events);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+  virtual void RemoveCancelled (std::vector<Event> &cancelled);
+  virtual bool IsRemoveCheap (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  Ptr<Scheduler> m_scheduler; //!< the recorded scheduler
+  std::string m_fileName;     //!< the file the operations are written to
+  std::ofstream m_file;       //!< the stream of that file
+};
+
+} // namespace ns3
+
+#endif /* RECORDING_SCHEDULER_H */
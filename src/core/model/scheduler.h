@@ -22,6 +22,7 @@
 #define SCHEDULER_H
 
 #include <stdint.h>
+#include <vector>
 #include "object.h"
 
 /**
@@ -97,6 +98,13 @@ public:
    * \param ev event to store in the event list
    */
   virtual void Insert (const Event &ev) = 0;
+  /**
+   * Store a group of events, sorted by key, in the event list.  The
+   * default implementation calls Insert for each of them.
+   *
+   * \param events the events to store
+   */
+  virtual void InsertBatch (const std::vector<Event> &events);
   /**
    * \returns true if the event list is empty and false otherwise.
    */
@@ -119,6 +127,21 @@ public:
    * This methods cannot be invoked if the list is empty.
    */
   virtual void Remove (const Event &ev) = 0;
+  /**
+   * Remove the events which were cancelled from the event list.  The
+   * default implementation removes all the events and inserts the
+   * others again as a batch, which gives Insert events before the last
+   * one removed.
+   *
+   * \param cancelled the vector to append the removed events to
+   */
+  virtual void RemoveCancelled (std::vector<Event> &cancelled);
+  /**
+   * \returns true if Remove costs about as much as Insert, so that a
+   * cancelled event is better removed right away than left in the
+   * event list.  False by default.
+   */
+  virtual bool IsRemoveCheap (void) const;
 };
 
 /* Note the invariants which this function must provide:
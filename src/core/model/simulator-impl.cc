@@ -18,6 +18,7 @@
  */
 
 #include "simulator-impl.h"
+#include "batch-event.h"
 #include "log.h"
 
 /**
@@ -42,4 +43,31 @@ SimulatorImpl::GetTypeId (void)
   return tid;
 }
 
+void
+SimulatorImpl::ScheduleWithContexts (BatchEventImpl *event)
+{
+  NS_LOG_FUNCTION (this << event);
+  uint32_t n = event->GetN ();
+  if (n == 0)
+    {
+      event->Unref ();
+      return;
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      // the caller holds one reference, for the last target
+      if (i + 1 < n)
+        {
+          event->Ref ();
+        }
+      ScheduleWithContext (event->GetContext (i), event->GetDelay (i), event);
+    }
+}
+
+uint32_t
+SimulatorImpl::GetContextPartition (uint32_t context) const
+{
+  return 0;
+}
+
 } // namespace ns3
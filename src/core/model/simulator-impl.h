@@ -37,6 +37,7 @@
 namespace ns3 {
 
 class Scheduler;
+class BatchEventImpl;
 
 /**
  * \ingroup simulator
@@ -111,6 +112,16 @@ public:
    * \returns A unique identifier for the newly-scheduled event.
    */
   virtual void ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event) = 0;
+  /**
+   * Schedule one future event per target of a BatchEventImpl, with the
+   * context and the delay of the target, all pointing to the event.
+   * The event is referenced once per target.
+   *
+   * The default implementation calls ScheduleWithContext for each target.
+   *
+   * \param event The events to schedule.
+   */
+  virtual void ScheduleWithContexts (BatchEventImpl *event);
   /**
    * Schedule an event to run at the current virtual time.
    *
@@ -227,6 +238,17 @@ public:
    * \return The current simulation context
    */
   virtual uint32_t GetContext (void) const = 0;
+  /**
+   * Get the partition of the events of a context.
+   *
+   * The events of two contexts of different partitions may run at the
+   * same time on different threads, so they must not share objects.
+   * The default implementation runs all the events on a single thread.
+   *
+   * \param context A context.
+   * \return The partition of the events of that context.
+   */
+  virtual uint32_t GetContextPartition (uint32_t context) const;
 };
 
 } // namespace ns3
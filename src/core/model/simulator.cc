@@ -251,6 +251,11 @@ Simulator::ScheduleWithContext (uint32_t context, const Time &time, EventImpl *i
 {
   return GetImpl ()->ScheduleWithContext (context, time, impl);
 }
+void
+Simulator::ScheduleWithContexts (BatchEventImpl *impl)
+{
+  return GetImpl ()->ScheduleWithContexts (impl);
+}
 EventId
 Simulator::ScheduleDestroy (const Ptr<EventImpl> &ev)
 {
@@ -345,6 +350,12 @@ Simulator::GetContext (void)
   return GetImpl ()->GetContext ();
 }
 
+uint32_t
+Simulator::GetContextPartition (uint32_t context)
+{
+  return GetImpl ()->GetContextPartition (context);
+}
+
 uint32_t
 Simulator::GetSystemId (void)
 {
@@ -360,6 +371,18 @@ Simulator::GetSystemId (void)
     }
 }
 
+uint64_t
+Simulator::GetEventAllocations (void)
+{
+  return EventImpl::GetAllocations ();
+}
+
+uint64_t
+Simulator::GetEventSystemAllocations (void)
+{
+  return EventImpl::GetSystemAllocations ();
+}
+
 void
 Simulator::SetImplementation (Ptr<SimulatorImpl> impl)
 {
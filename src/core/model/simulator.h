@@ -24,6 +24,7 @@
 #include "event-id.h"
 #include "event-impl.h"
 #include "make-event.h"
+#include "batch-event.h"
 #include "nstime.h"
 
 #include "object-factory.h"
@@ -445,6 +446,26 @@ public:
             typename T1, typename T2, typename T3, typename T4, typename T5>
   static void ScheduleWithContext (uint32_t context, Time const &time, void (*f)(U1,U2,U3,U4,U5), T1 a1, T2 a2, T3 a3, T4 a4, T5 a5);
 
+  /**
+   * Schedule one call of a member method per target, each with the
+   * context of the target and expiring after its delay.  All the
+   * events share a single EventImpl, and the simulator inserts them
+   * in a single operation, e.g. the receptions of a broadcast frame.
+   * The events cannot be cancelled.
+   *
+   * Events with the same expiration time run in the order of the
+   * targets, as if each had been scheduled with ScheduleWithContext.
+   * This method is thread-safe: it can be called from any thread.
+   *
+   * @param targets the context, delay and argument of each event
+   * @param mem_ptr member method pointer to invoke
+   * @param obj the object on which to invoke the member method
+   * @param a1 the first argument to pass to the invoked method, the
+   *        second one being the argument of the target
+   */
+  template <typename MEM, typename OBJ, typename T1, typename T2>
+  static void ScheduleWithContexts (const std::vector<BatchTarget<T2> > &targets, MEM mem_ptr, OBJ obj, T1 a1);
+
   /** @} */
   
   /**
@@ -747,6 +768,9 @@ public:
   /** \copydoc SimulatorImpl::GetContext */
   static uint32_t GetContext (void);
 
+  /** \copydoc SimulatorImpl::GetContextPartition */
+  static uint32_t GetContextPartition (uint32_t context);
+
   /** \copydoc SimulatorImpl::Schedule */
   static EventId Schedule (Time const &time, const Ptr<EventImpl> &event);
 
@@ -755,6 +779,11 @@ public:
    */
   static void ScheduleWithContext (uint32_t context, const Time &time, EventImpl *event);
 
+  /** \copydoc SimulatorImpl::ScheduleWithContexts
+   * This method is thread-safe: it can be called from any thread.
+   */
+  static void ScheduleWithContexts (BatchEventImpl *event);
+
   /** \copydoc SimulatorImpl::ScheduleDestroy */
   static EventId ScheduleDestroy (const Ptr<EventImpl> &event);
 
@@ -763,6 +792,12 @@ public:
 
   /** \copydoc SimulatorImpl::GetSystemId */
   static uint32_t GetSystemId (void);
+
+  /** \copydoc EventImpl::GetAllocations */
+  static uint64_t GetEventAllocations (void);
+
+  /** \copydoc EventImpl::GetSystemAllocations */
+  static uint64_t GetEventSystemAllocations (void);
   
 private:
   /** Default constructor. */
@@ -972,6 +1007,13 @@ void Simulator::ScheduleWithContext (uint32_t context, Time const &time, void (*
   return ScheduleWithContext (context, time, MakeEvent (f, a1, a2, a3, a4, a5));
 }
 
+template <typename MEM, typename OBJ,
+          typename T1, typename T2>
+void Simulator::ScheduleWithContexts (const std::vector<BatchTarget<T2> > &targets, MEM mem_ptr, OBJ obj, T1 a1)
+{
+  ScheduleWithContexts (MakeBatchEvent (mem_ptr, obj, a1, targets));
+}
+
 
 
 
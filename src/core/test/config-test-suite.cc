@@ -721,6 +721,159 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+// An object whose TypeId is only registered by its first instance, not
+// when the library is loaded.
+class LateConfigTestObject : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+  LateConfigTestObject (void) : m_x (0) {}
+  virtual ~LateConfigTestObject (void) {}
+  int8_t GetX (void) const { return m_x; }
+private:
+  int8_t m_x;
+};
+
+TypeId
+LateConfigTestObject::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("LateConfigTestObject")
+    .SetParent<Object> ()
+    .AddAttribute ("X", "",
+                   IntegerValue (0),
+                   MakeIntegerAccessor (&LateConfigTestObject::m_x),
+                   MakeIntegerChecker<int8_t> ())
+    ;
+  return tid;
+}
+
+// ===========================================================================
+// Test that the paths kept compiled between the calls find the objects
+// which changed since they were compiled.
+// ===========================================================================
+class CompiledPathConfigTestCase : public TestCase
+{
+public:
+  CompiledPathConfigTestCase ();
+  virtual ~CompiledPathConfigTestCase () {}
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param object an object
+   * \return its attribute A
+   */
+  static int64_t GetA (Ptr<ConfigTestObject> object);
+};
+
+CompiledPathConfigTestCase::CompiledPathConfigTestCase ()
+  : TestCase ("Check that the compiled paths find the objects added, named and typed after their first use")
+{
+}
+
+int64_t
+CompiledPathConfigTestCase::GetA (Ptr<ConfigTestObject> object)
+{
+  IntegerValue iv;
+  object->GetAttribute ("A", iv);
+  return iv.Get ();
+}
+
+void
+CompiledPathConfigTestCase::DoRun (void)
+{
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Names::Add ("CompiledPathRoot", root);
+
+  //
+  // Objects added to the vectors after the path was first used, like
+  // nodes and devices created late.
+  //
+  Ptr<ConfigTestObject> a0 = CreateObject<ConfigTestObject> ();
+  root->AddNodeA (a0);
+  Config::Set ("/Names/CompiledPathRoot/NodesA/*/NodesB/*/A", IntegerValue (1));
+  Config::Set ("/Names/CompiledPathRoot/NodesA/*/A", IntegerValue (1));
+  NS_TEST_ASSERT_MSG_EQ (GetA (a0), 1, "Object Attribute \"A\" not set through the wildcard");
+
+  Ptr<ConfigTestObject> a1 = CreateObject<ConfigTestObject> ();
+  root->AddNodeA (a1);
+  Ptr<ConfigTestObject> b0 = CreateObject<ConfigTestObject> ();
+  a0->AddNodeB (b0);
+  Ptr<ConfigTestObject> b1 = CreateObject<ConfigTestObject> ();
+  a1->AddNodeB (b1);
+  Config::Set ("/Names/CompiledPathRoot/NodesA/*/A", IntegerValue (2));
+  Config::Set ("/Names/CompiledPathRoot/NodesA/*/NodesB/*/A", IntegerValue (3));
+  NS_TEST_ASSERT_MSG_EQ (GetA (a0), 2, "Object Attribute \"A\" not set again");
+  NS_TEST_ASSERT_MSG_EQ (GetA (a1), 2, "Object added after the first use of the path not found");
+  NS_TEST_ASSERT_MSG_EQ (GetA (b0), 3, "Object added under an object after the first use of the path not found");
+  NS_TEST_ASSERT_MSG_EQ (GetA (b1), 3, "Object added under an object added after the first use of the path not found");
+  NS_TEST_ASSERT_MSG_EQ (Config::LookupMatches ("/Names/CompiledPathRoot/NodesA/*/NodesB/*").GetN (), 2,
+                         "Wrong number of objects matched");
+
+  //
+  // A name given, and then changed, after the path was first used
+  //
+  Config::Set ("/Names/CompiledPathObject/A", IntegerValue (4));
+  Names::Add ("CompiledPathObject", a1);
+  Config::Set ("/Names/CompiledPathObject/A", IntegerValue (5));
+  NS_TEST_ASSERT_MSG_EQ (GetA (a1), 5, "Object named after the first use of the path not found");
+  Config::Set ("/Names/RenamedPathObject/A", IntegerValue (6));
+  Names::Rename ("CompiledPathObject", "RenamedPathObject");
+  Config::Set ("/Names/CompiledPathObject/A", IntegerValue (7));
+  NS_TEST_ASSERT_MSG_EQ (GetA (a1), 5, "Object found under its old name");
+  Config::Set ("/Names/RenamedPathObject/A", IntegerValue (8));
+  NS_TEST_ASSERT_MSG_EQ (GetA (a1), 8, "Object not found under its new name");
+
+  //
+  // A type unknown when the path was first used: no object to get it
+  // from then, and no TypeId registered yet.
+  //
+  Config::Set ("/Names/CompiledPathRoot/NodesB/*/$LateConfigTestObject/X", IntegerValue (9));
+  Ptr<ConfigTestObject> c = CreateObject<ConfigTestObject> ();
+  root->AddNodeB (c);
+  Ptr<LateConfigTestObject> late = CreateObject<LateConfigTestObject> ();
+  c->AggregateObject (late);
+  Config::Set ("/Names/CompiledPathRoot/NodesB/*/$LateConfigTestObject/X", IntegerValue (10));
+  NS_TEST_ASSERT_MSG_EQ (late->GetX (), 10, "Type registered after the first use of the path not found");
+
+  //
+  // Objects of different types in one wildcard, set in bulk
+  //
+  Ptr<ConfigTestObject> d0 = CreateObject<DerivedConfigTestObject> ();
+  Ptr<ConfigTestObject> d1 = CreateObject<DerivedConfigTestObject> ();
+  a1->AddNodeB (d0);
+  a1->AddNodeB (c);
+  a1->AddNodeB (d1);
+  Config::MatchContainer matches = Config::LookupMatches ("/Names/CompiledPathRoot/NodesA/1/NodesB/*");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 4, "Wrong number of objects matched");
+  matches.Set ("A", IntegerValue (11));
+  NS_TEST_ASSERT_MSG_EQ (GetA (b1), 11, "Object Attribute \"A\" not set on the first type");
+  NS_TEST_ASSERT_MSG_EQ (GetA (d0), 11, "Object Attribute \"A\" not set on the second type");
+  NS_TEST_ASSERT_MSG_EQ (GetA (c), 11, "Object Attribute \"A\" not set on the first type again");
+  NS_TEST_ASSERT_MSG_EQ (GetA (d1), 11, "Object Attribute \"A\" not set on the second type again");
+  NS_TEST_ASSERT_MSG_EQ (GetA (b0), 3, "Object Attribute \"A\" set out of the path");
+
+  //
+  // A path used again after more paths than are kept
+  //
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      std::ostringstream oss;
+      oss << "/Names/CompiledPathRoot/NodesA/" << i % 2 << "/NodesB/" << i << "/B";
+      Config::Set (oss.str (), IntegerValue (12));
+    }
+  Ptr<ConfigTestObject> a2 = CreateObject<ConfigTestObject> ();
+  root->AddNodeA (a2);
+  Config::Set ("/Names/CompiledPathRoot/NodesA/*/A", IntegerValue (13));
+  NS_TEST_ASSERT_MSG_EQ (GetA (a0), 13, "Object Attribute \"A\" not set after the path was forgotten");
+  NS_TEST_ASSERT_MSG_EQ (GetA (a2), 13, "Object Attribute \"A\" not set on an object added meanwhile");
+  IntegerValue iv;
+  d1->GetAttribute ("B", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 12, "Object Attribute \"B\" not set through one of the paths");
+
+  Names::Clear ();
+}
+
 // ===========================================================================
 // The Test Suite that glues all of the Test Cases together.
 // ===========================================================================
@@ -737,6 +890,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase, TestCase::QUICK);
   AddTestCase (new ObjectVectorConfigTestCase, TestCase::QUICK);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase, TestCase::QUICK);
+  AddTestCase (new CompiledPathConfigTestCase, TestCase::QUICK);
 }
 
 static ConfigTestSuite configTestSuite;
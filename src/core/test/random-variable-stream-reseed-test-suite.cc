@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// Test case for re-seeding existing random variable streams
+// ===========================================================================
+class RandomVariableStreamReseedTestCase : public TestCase
+{
+public:
+  RandomVariableStreamReseedTestCase ();
+  virtual ~RandomVariableStreamReseedTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+RandomVariableStreamReseedTestCase::RandomVariableStreamReseedTestCase ()
+  : TestCase ("Reseed existing Random Variable Streams")
+{
+}
+
+RandomVariableStreamReseedTestCase::~RandomVariableStreamReseedTestCase ()
+{
+}
+
+void
+RandomVariableStreamReseedTestCase::DoRun (void)
+{
+  uint64_t oldRun = SeedManager::GetRun ();
+  SeedManager::SetRun (1);
+
+  // streams created at any time, also before the scenario that forks
+  // the episodes exists, are all re-seeded
+  Ptr<UniformRandomVariable> w = CreateObject<UniformRandomVariable> ();
+  w->SetStream (5);
+  double run1Value = w->GetValue ();
+  Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable> ();
+  x->SetStream (5);
+  NS_TEST_ASSERT_MSG_EQ (x->GetValue (), run1Value, "Streams of the same number and run differ.");
+  // not drawn from before the re-seed
+  Ptr<UniformRandomVariable> z = CreateObject<UniformRandomVariable> ();
+  z->SetStream (5);
+
+  // w and x must continue as if they had been created with run number 2
+  SeedManager::SetRun (2);
+  RandomVariableStream::ReseedAll ();
+  Ptr<UniformRandomVariable> y = CreateObject<UniformRandomVariable> ();
+  y->SetStream (5);
+
+  double value = y->GetValue ();
+  NS_TEST_ASSERT_MSG_NE (value, run1Value, "Run 2 repeats run 1.");
+  NS_TEST_ASSERT_MSG_EQ (w->GetValue (), value, "Reseeded stream differs from a new stream of the same run.");
+  NS_TEST_ASSERT_MSG_EQ (x->GetValue (), value, "Reseeded stream differs from a new stream of the same run.");
+  NS_TEST_ASSERT_MSG_EQ (z->GetValue (), value, "Stream not drawn from before did not pick up the new run.");
+
+  SeedManager::SetRun (oldRun);
+}
+
+class RandomVariableStreamReseedTestSuite : public TestSuite
+{
+public:
+  RandomVariableStreamReseedTestSuite ();
+};
+
+RandomVariableStreamReseedTestSuite::RandomVariableStreamReseedTestSuite ()
+  : TestSuite ("random-variable-stream-reseed", UNIT)
+{
+  AddTestCase (new RandomVariableStreamReseedTestCase, TestCase::QUICK);
+}
+
+static RandomVariableStreamReseedTestSuite randomVariableStreamReseedTestSuite;
@@ -23,6 +23,12 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/quad-heap-scheduler.h"
+#include "ns3/recording-scheduler.h"
+#include "ns3/default-simulator-impl.h"
+#include "ns3/uinteger.h"
+#include <iterator>
+#include <map>
 
 using namespace ns3;
 
@@ -168,6 +174,279 @@ SimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_destroy, true, "Event should have run");
 }
 
+class SimulatorBatchTestCase : public TestCase
+{
+public:
+  SimulatorBatchTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  void Record (int shared, int arg);
+  std::vector<std::pair<int, uint32_t> > m_order;
+  std::vector<uint64_t> m_times;
+  ObjectFactory m_schedulerFactory;
+};
+
+SimulatorBatchTestCase::SimulatorBatchTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that batches of events run in order with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+SimulatorBatchTestCase::Record (int shared, int arg)
+{
+  m_order.push_back (std::make_pair (shared + arg, Simulator::GetContext ()));
+  m_times.push_back (Simulator::Now ().GetMicroSeconds ());
+}
+
+void
+SimulatorBatchTestCase::DoRun (void)
+{
+  Simulator::SetScheduler (m_schedulerFactory);
+
+  uint32_t delays[] = { 30, 10, 20, 10, 40, 20, 5, 30 };
+  uint32_t n = sizeof (delays) / sizeof (delays[0]);
+  std::vector<BatchTarget<int> > targets;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      // single events before the batch
+      Simulator::ScheduleWithContext (100 + i, MicroSeconds (delays[i]), &SimulatorBatchTestCase::Record, this, 0, 100 + i);
+      BatchTarget<int> target;
+      target.context = i;
+      target.delay = MicroSeconds (delays[i]);
+      target.arg = i;
+      targets.push_back (target);
+    }
+  Simulator::ScheduleWithContexts (targets, &SimulatorBatchTestCase::Record, this, 1000);
+  // single events after the batch
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Simulator::ScheduleWithContext (200 + i, MicroSeconds (delays[i]), &SimulatorBatchTestCase::Record, this, 0, 200 + i);
+    }
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_order.size (), 3 * n, "Not all the events ran");
+  uint32_t k = 0;
+  for (uint32_t delay = 0; delay <= 40; delay++)
+    {
+      for (int base = 100; base <= 300; base += 100)
+        {
+          for (uint32_t i = 0; i < n; i++)
+            {
+              if (delays[i] != delay)
+                {
+                  continue;
+                }
+              // the batch runs between the events scheduled before and after it
+              int arg = base == 100 ? 100 + i : base == 200 ? 1000 + i : 200 + i;
+              uint32_t context = base == 200 ? i : arg;
+              NS_TEST_EXPECT_MSG_EQ (m_times[k], delay, "Event " << k << " ran at the wrong time");
+              NS_TEST_EXPECT_MSG_EQ (m_order[k].first, arg, "Event " << k << " ran out of order");
+              NS_TEST_EXPECT_MSG_EQ (m_order[k].second, context, "Event " << k << " got the wrong context");
+              k++;
+            }
+        }
+    }
+
+  // pending events of a batch are released by Destroy
+  Simulator::ScheduleWithContexts (targets, &SimulatorBatchTestCase::Record, this, 0);
+  Simulator::ScheduleWithContexts (std::vector<BatchTarget<int> > (), &SimulatorBatchTestCase::Record, this, 0);
+  Simulator::Destroy ();
+}
+
+class SchedulerOrderTestCase : public TestCase
+{
+public:
+  SchedulerOrderTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  /**
+   * \return the next value of a linear congruential generator
+   */
+  uint32_t Next (void);
+  ObjectFactory m_schedulerFactory;
+  uint32_t m_seed;
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check the order of many events against a std::map with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory),
+    m_seed (1)
+{
+}
+
+uint32_t
+SchedulerOrderTestCase::Next (void)
+{
+  m_seed = m_seed * 1103515245 + 12345;
+  return m_seed >> 8;
+}
+
+void
+SchedulerOrderTestCase::DoRun (void)
+{
+  Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+  std::map<Scheduler::EventKey, EventImpl *> expected;
+  uint32_t uid = 0;
+  uint64_t now = 0;
+  for (uint32_t round = 0; round < 200; round++)
+    {
+      // single events, a batch, then remove some of them
+      uint32_t inserts = Next () % 50;
+      for (uint32_t i = 0; i < inserts; i++)
+        {
+          Scheduler::Event ev;
+          ev.impl = 0;
+          // few distinct times, to check the ties are broken by uid
+          ev.key.m_ts = now + Next () % 64;
+          ev.key.m_uid = uid++;
+          ev.key.m_context = 0;
+          scheduler->Insert (ev);
+          expected[ev.key] = ev.impl;
+        }
+      // large batches rebuild the heaps, small ones are inserted one by one
+      uint32_t size = (round % 4 == 0) ? expected.size () + Next () % 10 : Next () % 20;
+      std::vector<Scheduler::Event> batch (size);
+      for (uint32_t i = 0; i < batch.size (); i++)
+        {
+          batch[i].impl = 0;
+          batch[i].key.m_ts = now + 10;
+          batch[i].key.m_uid = uid++;
+          batch[i].key.m_context = i;
+          expected[batch[i].key] = batch[i].impl;
+        }
+      scheduler->InsertBatch (batch);
+      uint32_t removes = Next () % 8;
+      for (uint32_t i = 0; i < removes && !expected.empty (); i++)
+        {
+          std::map<Scheduler::EventKey, EventImpl *>::iterator it = expected.begin ();
+          std::advance (it, Next () % expected.size ());
+          Scheduler::Event ev;
+          ev.impl = it->second;
+          ev.key = it->first;
+          scheduler->Remove (ev);
+          expected.erase (it);
+        }
+      // keep a few hundred events pending
+      uint32_t nexts = Next () % 60 + (expected.size () > 200 ? expected.size () - 200 : 0);
+      for (uint32_t i = 0; i < nexts && !expected.empty (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), false, "Events are missing");
+          Scheduler::Event ev = scheduler->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (ev.key.m_uid, expected.begin ()->first.m_uid, "Event out of order");
+          NS_TEST_ASSERT_MSG_EQ (ev.key.m_context, expected.begin ()->first.m_context, "Wrong context");
+          now = ev.key.m_ts;
+          expected.erase (expected.begin ());
+        }
+    }
+  while (!expected.empty ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (scheduler->PeekNext ().key.m_uid, expected.begin ()->first.m_uid, "Event out of order");
+      NS_TEST_ASSERT_MSG_EQ (scheduler->RemoveNext ().key.m_uid, expected.begin ()->first.m_uid, "Event out of order");
+      expected.erase (expected.begin ());
+    }
+  NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), true, "Events are left");
+  scheduler->Dispose ();
+}
+
+class SimulatorEventAllocationTestCase : public TestCase
+{
+public:
+  SimulatorEventAllocationTestCase ();
+  virtual void DoRun (void);
+  void Chain (uint32_t left, double value);
+};
+
+SimulatorEventAllocationTestCase::SimulatorEventAllocationTestCase ()
+  : TestCase ("Check that the memory of the events is reused")
+{
+}
+
+void
+SimulatorEventAllocationTestCase::Chain (uint32_t left, double value)
+{
+  if (left > 0)
+    {
+      Simulator::Schedule (MicroSeconds (1), &SimulatorEventAllocationTestCase::Chain, this, left - 1, value);
+    }
+}
+
+void
+SimulatorEventAllocationTestCase::DoRun (void)
+{
+  // the first events of the chain may come from the system
+  Simulator::Schedule (MicroSeconds (1), &SimulatorEventAllocationTestCase::Chain, this, 10, 0.0);
+  Simulator::Run ();
+  uint64_t allocations = Simulator::GetEventAllocations ();
+  uint64_t systemAllocations = Simulator::GetEventSystemAllocations ();
+  Simulator::Schedule (MicroSeconds (1), &SimulatorEventAllocationTestCase::Chain, this, 1000, 0.0);
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetEventAllocations () - allocations, 1001, "Wrong number of events");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetEventSystemAllocations () - systemAllocations, 0, "Events not reused");
+  Simulator::Destroy ();
+}
+
+class SimulatorCancelTestCase : public TestCase
+{
+public:
+  SimulatorCancelTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  void Record (uint32_t i);
+  std::vector<uint32_t> m_ran;
+  ObjectFactory m_schedulerFactory;
+};
+
+SimulatorCancelTestCase::SimulatorCancelTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that the cancelled events are dropped from the event list with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+SimulatorCancelTestCase::Record (uint32_t i)
+{
+  m_ran.push_back (i);
+}
+
+void
+SimulatorCancelTestCase::DoRun (void)
+{
+  Ptr<DefaultSimulatorImpl> impl = CreateObject<DefaultSimulatorImpl> ();
+  impl->SetAttribute ("MinCancelledEvents", UintegerValue (10));
+  Simulator::SetImplementation (impl);
+  Simulator::SetScheduler (m_schedulerFactory);
+
+  // cancel three events out of four, which rebuilds the list many times
+  // unless the scheduler removes them right away
+  std::vector<EventId> ids;
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      ids.push_back (Simulator::Schedule (MicroSeconds (1000 - i), &SimulatorCancelTestCase::Record, this, 1000 - i));
+    }
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      if (i % 4 != 0)
+        {
+          Simulator::Cancel (ids[i]);
+          NS_TEST_EXPECT_MSG_EQ (ids[i].IsExpired (), true, "Cancelled event " << i << " should have expired");
+        }
+    }
+  // the events left can still be removed
+  Simulator::Remove (ids[0]);
+  NS_TEST_EXPECT_MSG_EQ (ids[0].IsExpired (), true, "Removed event should have expired");
+  NS_TEST_EXPECT_MSG_EQ (ids[4].IsRunning (), true, "Event should still be pending");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetDelayLeft (ids[4]), MicroSeconds (996), "Wrong delay left");
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_ran.size (), 249, "Wrong number of events run");
+  for (uint32_t k = 0; k < m_ran.size (); k++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_ran[k], 4 * (k + 1), "Event " << k << " ran out of order");
+    }
+  Simulator::Destroy ();
+}
+
 class SimulatorTemplateTestCase : public TestCase
 {
 public:
@@ -475,5 +754,42 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (QuadHeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (RecordingScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+
+    factory.SetTypeId (ListScheduler::GetTypeId ());
+    AddTestCase (new SimulatorBatchTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorBatchTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorBatchTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CalendarScheduler::GetTypeId ());
+    AddTestCase (new SimulatorBatchTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (QuadHeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorBatchTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (RecordingScheduler::GetTypeId ());
+    AddTestCase (new SimulatorBatchTestCase (factory), TestCase::QUICK);
+
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (QuadHeapScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CalendarScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+
+    factory.SetTypeId (ListScheduler::GetTypeId ());
+    AddTestCase (new SimulatorCancelTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorCancelTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorCancelTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CalendarScheduler::GetTypeId ());
+    AddTestCase (new SimulatorCancelTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (QuadHeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorCancelTestCase (factory), TestCase::QUICK);
+
+    AddTestCase (new SimulatorEventAllocationTestCase, TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -26,10 +26,16 @@
 #include "ns3/config.h"
 #include "ns3/string.h"
 #include "ns3/system-thread.h"
+#include "ns3/make-event.h"
+#include "ns3/default-simulator-impl.h"
+#include "ns3/multi-threaded-simulator-impl.h"
+#include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <ctime>
 #include <list>
 #include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -225,6 +231,210 @@ ThreadedSimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_a, m_d, "Bad scheduling");
 }
 
+/**
+ * Check that MultiThreadedSimulatorImpl runs the events of each context
+ * at the same times as DefaultSimulatorImpl, and with one thread in the
+ * same order.
+ */
+class MultiThreadedSimulatorTestCase : public TestCase
+{
+public:
+  MultiThreadedSimulatorTestCase (unsigned int threads);
+  /**
+   * Record the event, and send two more to other contexts.
+   * \param hops number of times the events are sent on
+   */
+  void Hop (uint32_t hops);
+  /**
+   * Record the event.
+   * \param id the identifier of the event
+   */
+  void Record (uint32_t id);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run the events of all the contexts.
+   * \param impl the simulator implementation
+   */
+  void RunEvents (Ptr<SimulatorImpl> impl);
+
+  /// The time and identifier of an event run
+  typedef std::pair<uint64_t, uint32_t> Run;
+  /**
+   * Check that the same events ran in the same order.
+   * \param runs the events run
+   * \param expectedRuns the events which should have run
+   * \param context the context of the events
+   */
+  void CheckRuns (const std::vector<Run> &runs, const std::vector<Run> &expectedRuns, uint32_t context);
+  /// The events run by each context, each one written by its own thread
+  std::vector<std::vector<Run> > m_runs;
+  unsigned int m_threads;
+  uint64_t m_stop; //!< the time given to Simulator::Stop
+};
+
+MultiThreadedSimulatorTestCase::MultiThreadedSimulatorTestCase (unsigned int threads)
+  : TestCase ("Check that the events of each context run at the same times in ns3::MultiThreadedSimulatorImpl"),
+    m_threads (threads)
+{
+}
+
+void
+MultiThreadedSimulatorTestCase::Record (uint32_t id)
+{
+  m_runs[Simulator::GetContext ()].push_back (Run (Simulator::Now ().GetTimeStep (), id));
+}
+
+void
+MultiThreadedSimulatorTestCase::Hop (uint32_t hops)
+{
+  uint32_t context = Simulator::GetContext ();
+  Record (hops);
+  if (hops == 0)
+    {
+      return;
+    }
+  Simulator::Schedule (NanoSeconds (3), &MultiThreadedSimulatorTestCase::Record, this, 100 + hops);
+  Simulator::ScheduleWithContext ((context + 1) % m_runs.size (), NanoSeconds (10 + context % 3),
+                                  &MultiThreadedSimulatorTestCase::Hop, this, hops - 1);
+  Simulator::ScheduleWithContext ((context + 3) % m_runs.size (), NanoSeconds (10),
+                                  &MultiThreadedSimulatorTestCase::Hop, this, hops - 1);
+}
+
+void
+MultiThreadedSimulatorTestCase::RunEvents (Ptr<SimulatorImpl> impl)
+{
+  Simulator::SetImplementation (impl);
+  m_runs.clear ();
+  m_runs.resize (8);
+  for (uint32_t context = 0; context < m_runs.size (); context++)
+    {
+      Simulator::ScheduleWithContext (context, NanoSeconds (context), &MultiThreadedSimulatorTestCase::Hop, this, 10);
+    }
+  Simulator::Stop (TimeStep (m_stop));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+MultiThreadedSimulatorTestCase::CheckRuns (const std::vector<Run> &runs, const std::vector<Run> &expectedRuns,
+                                           uint32_t context)
+{
+  NS_TEST_ASSERT_MSG_EQ (runs.size (), expectedRuns.size (), "Wrong number of events in context " << context);
+  for (uint32_t i = 0; i < runs.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (runs[i].first, expectedRuns[i].first, "Event " << i << " of context " << context << " at the wrong time");
+      NS_TEST_EXPECT_MSG_EQ (runs[i].second, expectedRuns[i].second, "Event " << i << " of context " << context << " is wrong");
+    }
+}
+
+void
+MultiThreadedSimulatorTestCase::DoRun (void)
+{
+  m_stop = NanoSeconds (80).GetTimeStep ();
+  RunEvents (CreateObject<DefaultSimulatorImpl> ());
+  std::vector<std::vector<Run> > expected = m_runs;
+
+  Ptr<MultiThreadedSimulatorImpl> impl = CreateObject<MultiThreadedSimulatorImpl> ();
+  impl->SetAttribute ("Threads", UintegerValue (m_threads));
+  impl->SetAttribute ("Lookahead", TimeValue (NanoSeconds (10)));
+  RunEvents (impl);
+  std::vector<std::vector<Run> > first = m_runs;
+
+  // the same events run again in the same order, the ones of the stop
+  // time included
+  impl = CreateObject<MultiThreadedSimulatorImpl> ();
+  impl->SetAttribute ("Threads", UintegerValue (m_threads));
+  impl->SetAttribute ("Lookahead", TimeValue (NanoSeconds (10)));
+  RunEvents (impl);
+
+  for (uint32_t context = 0; context < m_runs.size (); context++)
+    {
+      std::vector<Run> &runs = m_runs[context];
+      for (uint32_t i = 1; i < runs.size (); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ ((runs[i - 1].first <= runs[i].first), true,
+                                 "Event " << i << " of context " << context << " ran too early");
+        }
+      NS_TEST_EXPECT_MSG_EQ ((runs.empty () || runs.back ().first <= m_stop), true,
+                             "Event of context " << context << " ran after the stop time");
+      CheckRuns (runs, first[context], context);
+
+      std::vector<Run> &expectedRuns = expected[context];
+      if (m_threads == 1)
+        {
+          CheckRuns (runs, expectedRuns, context);
+          continue;
+        }
+      // the partitions which do not run the event of Stop (Time) also
+      // run the events of the stop time scheduled after it
+      while (!runs.empty () && runs.back ().first == m_stop)
+        {
+          NS_TEST_EXPECT_MSG_EQ ((context % m_threads != 0), true,
+                                 "Event of context " << context << " ran after Stop (Time)");
+          runs.pop_back ();
+        }
+      while (!expectedRuns.empty () && expectedRuns.back ().first == m_stop)
+        {
+          expectedRuns.pop_back ();
+        }
+      // the events of the same time may run in another order
+      std::sort (runs.begin (), runs.end ());
+      std::sort (expectedRuns.begin (), expectedRuns.end ());
+      CheckRuns (runs, expectedRuns, context);
+    }
+}
+
+/**
+ * Check that the events allocated by a thread are still counted once
+ * the thread exited and gave its event cache back.
+ */
+class EventCacheThreadExitTestCase : public TestCase
+{
+public:
+  EventCacheThreadExitTestCase ();
+  /**
+   * Allocate and delete events, in their own thread.
+   * \param events the number of events
+   */
+  static void AllocateEvents (uint32_t events);
+
+private:
+  virtual void DoRun (void);
+};
+
+EventCacheThreadExitTestCase::EventCacheThreadExitTestCase ()
+  : TestCase ("Check that the event counters of the threads that exited are kept")
+{
+}
+
+void
+EventCacheThreadExitTestCase::AllocateEvents (uint32_t events)
+{
+  for (uint32_t i = 0; i < events; i++)
+    {
+      EventImpl *event = MakeEvent (&EventCacheThreadExitTestCase::AllocateEvents, 0);
+      event->Unref ();
+    }
+}
+
+void
+EventCacheThreadExitTestCase::DoRun (void)
+{
+  uint64_t allocations = Simulator::GetEventAllocations ();
+  uint64_t systemAllocations = Simulator::GetEventSystemAllocations ();
+  // each new thread starts with an empty cache
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<SystemThread> thread = Create<SystemThread> (MakeBoundCallback (&EventCacheThreadExitTestCase::AllocateEvents, 100u));
+      thread->Start ();
+      thread->Join ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetEventAllocations () - allocations, 300, "Events of the threads not counted");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetEventSystemAllocations () - systemAllocations, 3, "Events not reused within a thread");
+}
+
 class ThreadedSimulatorTestSuite : public TestSuite
 {
 public:
@@ -262,5 +472,9 @@ public:
               }
           }
       }
+    AddTestCase (new MultiThreadedSimulatorTestCase (1), TestCase::QUICK);
+    AddTestCase (new MultiThreadedSimulatorTestCase (2), TestCase::QUICK);
+    AddTestCase (new MultiThreadedSimulatorTestCase (4), TestCase::QUICK);
+    AddTestCase (new EventCacheThreadExitTestCase, TestCase::QUICK);
   }
 } g_threadedSimulatorTestSuite;
@@ -33,10 +33,10 @@ NS_LOG_COMPONENT_DEFINE ("PacketMetadata");
 
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
-bool PacketMetadata::m_metadataSkipped = false;
-uint32_t PacketMetadata::m_maxSize = 0;
+std::atomic<bool> PacketMetadata::m_metadataSkipped (false);
+thread_local uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
-PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+thread_local PacketMetadata::DataFreeList PacketMetadata::m_freeList;
 
 PacketMetadata::DataFreeList::~DataFreeList ()
 {
@@ -666,7 +666,7 @@ PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
   NS_LOG_FUNCTION (this << uid << size);
   if (!m_enable)
     {
-      m_metadataSkipped = true;
+      m_metadataSkipped.store (true, std::memory_order_relaxed);
       return;
     }
 
@@ -688,7 +688,7 @@ PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
     {
-      m_metadataSkipped = true;
+      m_metadataSkipped.store (true, std::memory_order_relaxed);
       return;
     }
   struct PacketMetadata::SmallItem item;
@@ -736,7 +736,7 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
   NS_ASSERT (IsStateOk ());
   if (!m_enable)
     {
-      m_metadataSkipped = true;
+      m_metadataSkipped.store (true, std::memory_order_relaxed);
       return;
     }
   struct PacketMetadata::SmallItem item;
@@ -758,7 +758,7 @@ PacketMetadata::RemoveTrailer (const Trailer &trailer, uint32_t size)
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
     {
-      m_metadataSkipped = true;
+      m_metadataSkipped.store (true, std::memory_order_relaxed);
       return;
     }
   struct PacketMetadata::SmallItem item;
@@ -805,7 +805,7 @@ PacketMetadata::AddAtEnd (PacketMetadata const&o)
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
     {
-      m_metadataSkipped = true;
+      m_metadataSkipped.store (true, std::memory_order_relaxed);
       return;
     }
   if (m_tail == 0xffff)
@@ -882,7 +882,7 @@ PacketMetadata::AddPaddingAtEnd (uint32_t end)
   NS_LOG_FUNCTION (this << end);
   if (!m_enable)
     {
-      m_metadataSkipped = true;
+      m_metadataSkipped.store (true, std::memory_order_relaxed);
       return;
     }
 }
@@ -893,7 +893,7 @@ PacketMetadata::RemoveAtStart (uint32_t start)
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
     {
-      m_metadataSkipped = true;
+      m_metadataSkipped.store (true, std::memory_order_relaxed);
       return;
     }
   NS_ASSERT (m_data != 0);
@@ -956,7 +956,7 @@ PacketMetadata::RemoveAtEnd (uint32_t end)
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
     {
-      m_metadataSkipped = true;
+      m_metadataSkipped.store (true, std::memory_order_relaxed);
       return;
     }
   NS_ASSERT (m_data != 0);
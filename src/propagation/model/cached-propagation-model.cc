@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "cached-propagation-model.h"
+#include "cost231-propagation-loss-model.h"
+#include "okumura-hata-propagation-loss-model.h"
+#include "itu-r-1411-los-propagation-loss-model.h"
+#include "itu-r-1411-nlos-over-rooftop-propagation-loss-model.h"
+#include "kun-2600-mhz-propagation-loss-model.h"
+#include "ns3/log.h"
+#include "ns3/pointer.h"
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CachedPropagationModel");
+
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<CachedPropagationLossModel> ()
+    .AddAttribute ("Model", "The deterministic loss model to cache.",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedPropagationLossModel::SetModel,
+                                        &CachedPropagationLossModel::GetModel),
+                   MakePointerChecker<PropagationLossModel> ())
+  ;
+  return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+  : m_cache (-std::numeric_limits<float>::infinity ())
+{
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel ()
+{
+}
+
+void
+CachedPropagationLossModel::DoDispose (void)
+{
+  m_cache.Clear ();
+  m_model = 0;
+  PropagationLossModel::DoDispose ();
+}
+
+bool
+CachedPropagationLossModel::IsCacheable (Ptr<PropagationLossModel> model)
+{
+  for (; model != 0; model = model->GetNext ())
+    {
+      if (DynamicCast<FriisPropagationLossModel> (model) == 0
+          && DynamicCast<TwoRayGroundPropagationLossModel> (model) == 0
+          && DynamicCast<LogDistancePropagationLossModel> (model) == 0
+          && DynamicCast<ThreeLogDistancePropagationLossModel> (model) == 0
+          && DynamicCast<Cost231PropagationLossModel> (model) == 0
+          && DynamicCast<OkumuraHataPropagationLossModel> (model) == 0
+          && DynamicCast<ItuR1411LosPropagationLossModel> (model) == 0
+          && DynamicCast<ItuR1411NlosOverRooftopPropagationLossModel> (model) == 0
+          && DynamicCast<Kun2600MhzPropagationLossModel> (model) == 0)
+        {
+          NS_LOG_LOGIC (model->GetInstanceTypeId ().GetName () << " cannot be cached");
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+CachedPropagationLossModel::SetModel (Ptr<PropagationLossModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  if (model != 0 && !IsCacheable (model))
+    {
+      NS_FATAL_ERROR ("Only deterministic loss models can be cached, not " << model->GetInstanceTypeId ().GetName ());
+    }
+  m_model = model;
+  m_cache.Clear ();
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetModel (void) const
+{
+  return m_model;
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+  NS_ASSERT_MSG (m_model != 0, "No model to cache");
+  float *loss = m_cache.Find (a, b);
+  if (loss == 0)
+    {
+      return m_model->CalcRxPower (txPowerDbm, a, b);
+    }
+  if (*loss == -std::numeric_limits<float>::infinity ())
+    {
+      *loss = txPowerDbm - m_model->CalcRxPower (txPowerDbm, a, b);
+    }
+  return txPowerDbm - *loss;
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+// ------------------------------------------------------------------------- //
+
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationDelayModel);
+
+TypeId
+CachedPropagationDelayModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationDelayModel")
+    .SetParent<PropagationDelayModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<CachedPropagationDelayModel> ()
+    .AddAttribute ("Model", "The deterministic delay model to cache.",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedPropagationDelayModel::SetModel,
+                                        &CachedPropagationDelayModel::GetModel),
+                   MakePointerChecker<PropagationDelayModel> ())
+  ;
+  return tid;
+}
+
+CachedPropagationDelayModel::CachedPropagationDelayModel ()
+  : m_cache (-1)
+{
+}
+
+CachedPropagationDelayModel::~CachedPropagationDelayModel ()
+{
+}
+
+void
+CachedPropagationDelayModel::DoDispose (void)
+{
+  m_cache.Clear ();
+  m_model = 0;
+  PropagationDelayModel::DoDispose ();
+}
+
+void
+CachedPropagationDelayModel::SetModel (Ptr<PropagationDelayModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  if (model != 0 && DynamicCast<ConstantSpeedPropagationDelayModel> (model) == 0)
+    {
+      NS_FATAL_ERROR ("Only deterministic delay models can be cached, not " << model->GetInstanceTypeId ().GetName ());
+    }
+  m_model = model;
+  m_cache.Clear ();
+}
+
+Ptr<PropagationDelayModel>
+CachedPropagationDelayModel::GetModel (void) const
+{
+  return m_model;
+}
+
+Time
+CachedPropagationDelayModel::GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  NS_ASSERT_MSG (m_model != 0, "No model to cache");
+  int32_t *delay = m_cache.Find (a, b);
+  if (delay == 0)
+    {
+      return m_model->GetDelay (a, b);
+    }
+  if (*delay < 0)
+    {
+      Time computed = m_model->GetDelay (a, b);
+      if (computed.GetTimeStep () > std::numeric_limits<int32_t>::max ())
+        {
+          return computed;
+        }
+      *delay = computed.GetTimeStep ();
+    }
+  return TimeStep (*delay);
+}
+
+int64_t
+CachedPropagationDelayModel::DoAssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+} // namespace ns3
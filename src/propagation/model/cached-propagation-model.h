@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef CACHED_PROPAGATION_MODEL_H
+#define CACHED_PROPAGATION_MODEL_H
+
+#include "propagation-loss-model.h"
+#include "propagation-delay-model.h"
+#include "propagation-matrix-cache.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Computes the loss of a deterministic model once per pair of nodes.
+ *
+ * The loss (tx power minus rx power) of the wrapped model and of the
+ * models chained to it is kept as a float for every (source,
+ * destination) pair, and computed again only after a course change of
+ * one of them.  Pairs with a node moving at a non-zero velocity are
+ * not cached.
+ *
+ * Only models whose rx power is the tx power minus a loss that depends
+ * on the positions alone can be wrapped: Friis, TwoRayGround,
+ * LogDistance, ThreeLogDistance, Cost231, OkumuraHata, ItuR1411Los,
+ * ItuR1411NlosOverRooftop and Kun2600Mhz.  Stochastic models such as
+ * Nakagami or Jakes are refused; they can be chained to this model
+ * with SetNext instead, and are then evaluated on every call.
+ *
+ * The cache holds N * N floats for N nodes.
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  CachedPropagationLossModel ();
+  virtual ~CachedPropagationLossModel ();
+
+  /**
+   * \param model the model to cache, aborts if it cannot be cached
+   */
+  void SetModel (Ptr<PropagationLossModel> model);
+  /**
+   * \return the cached model
+   */
+  Ptr<PropagationLossModel> GetModel (void) const;
+
+  /**
+   * \param model a loss model
+   * \return true if the model and the ones chained to it can be cached
+   */
+  static bool IsCacheable (Ptr<PropagationLossModel> model);
+
+private:
+  virtual void DoDispose (void);
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  Ptr<PropagationLossModel> m_model;              //!< cached model
+  mutable PropagationMatrixCache<float> m_cache;  //!< loss of each pair (dB)
+};
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Computes the delay of a deterministic model once per pair of nodes.
+ *
+ * The delay is kept in time steps for every (source, destination) pair,
+ * like the loss in CachedPropagationLossModel.  Only
+ * ConstantSpeedPropagationDelayModel can be wrapped.
+ */
+class CachedPropagationDelayModel : public PropagationDelayModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  CachedPropagationDelayModel ();
+  virtual ~CachedPropagationDelayModel ();
+
+  /**
+   * \param model the model to cache, aborts if it cannot be cached
+   */
+  void SetModel (Ptr<PropagationDelayModel> model);
+  /**
+   * \return the cached model
+   */
+  Ptr<PropagationDelayModel> GetModel (void) const;
+
+  virtual Time GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
+private:
+  virtual void DoDispose (void);
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  Ptr<PropagationDelayModel> m_model;               //!< cached model
+  mutable PropagationMatrixCache<int32_t> m_cache;  //!< delay of each pair (time steps)
+};
+
+} // namespace ns3
+
+#endif /* CACHED_PROPAGATION_MODEL_H */
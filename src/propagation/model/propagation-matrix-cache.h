@@ -0,0 +1,187 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PROPAGATION_MATRIX_CACHE_H
+#define PROPAGATION_MATRIX_CACHE_H
+
+#include "ns3/mobility-model.h"
+#include "ns3/callback.h"
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+/**
+ * \ingroup propagation
+ * \brief Dense matrix of one value per (source, destination) pair of MobilityModels.
+ *
+ * Each MobilityModel gets a row and a column the first time it is seen;
+ * the matrix doubles its size when it runs out of them.  The row and the
+ * column of a MobilityModel are reset to the unknown value when its
+ * CourseChange trace fires.  Pairs with a MobilityModel that moves at a
+ * non-zero velocity have no entry, since their position changes without
+ * a course change.
+ */
+template<class T>
+class PropagationMatrixCache
+{
+public:
+  /**
+   * \param unknown the value of entries not computed yet
+   */
+  PropagationMatrixCache (T unknown)
+    : m_unknown (unknown),
+      m_capacity (0),
+      m_lastSource (0),
+      m_lastSourceIndex (0)
+  {
+  }
+  ~PropagationMatrixCache ()
+  {
+    Clear ();
+  }
+
+  /**
+   * \param a the source
+   * \param b the destination
+   * \return the entry of the pair, equal to the unknown value if not
+   * computed yet, or 0 if one of them moves
+   */
+  T * Find (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b)
+  {
+    // a channel asks for all destinations of one source in a row
+    if (PeekPointer (a) != m_lastSource)
+      {
+        m_lastSourceIndex = GetIndex (a);
+        m_lastSource = PeekPointer (a);
+      }
+    uint32_t i = m_lastSourceIndex;
+    uint32_t j = GetIndex (b);
+    if (m_moving[i] || m_moving[j])
+      {
+        return 0;
+      }
+    return &m_matrix[static_cast<size_t> (i) * m_capacity + j];
+  }
+
+  /// Forget all entries and disconnect from the MobilityModels
+  void Clear (void)
+  {
+    for (typename std::vector<Ptr<const MobilityModel> >::const_iterator i = m_mobility.begin ();
+         i != m_mobility.end (); i++)
+      {
+        ConstCast<MobilityModel> (*i)->TraceDisconnectWithoutContext ("CourseChange",
+                                                                      MakeCallback (&PropagationMatrixCache<T>::CourseChanged, this));
+      }
+    m_mobility.clear ();
+    m_moving.clear ();
+    m_index.clear ();
+    m_matrix.clear ();
+    m_capacity = 0;
+    m_lastSource = 0;
+  }
+
+  /// \return the number of MobilityModels with a row and a column
+  uint32_t GetN (void) const
+  {
+    return m_mobility.size ();
+  }
+
+private:
+  /// Defined and unimplemented, the CourseChange traces are connected to this
+  PropagationMatrixCache (const PropagationMatrixCache &);
+  /// Defined and unimplemented, the CourseChange traces are connected to this
+  PropagationMatrixCache & operator = (const PropagationMatrixCache &);
+
+  /**
+   * \param mobility a MobilityModel
+   * \return its row and column, added if needed
+   */
+  uint32_t GetIndex (Ptr<const MobilityModel> mobility)
+  {
+    typename Index::const_iterator it = m_index.find (PeekPointer (mobility));
+    if (it != m_index.end ())
+      {
+        return it->second;
+      }
+    uint32_t index = m_mobility.size ();
+    m_index[PeekPointer (mobility)] = index;
+    m_mobility.push_back (mobility);
+    m_moving.push_back (IsMoving (mobility));
+    ConstCast<MobilityModel> (mobility)->TraceConnectWithoutContext ("CourseChange",
+                                                                     MakeCallback (&PropagationMatrixCache<T>::CourseChanged, this));
+    if (index >= m_capacity)
+      {
+        uint32_t capacity = std::max<uint32_t> (16, 2 * m_capacity);
+        std::vector<T> matrix (static_cast<size_t> (capacity) * capacity, m_unknown);
+        for (uint32_t row = 0; row < m_capacity; row++)
+          {
+            typename std::vector<T>::const_iterator first = m_matrix.begin () + static_cast<size_t> (row) * m_capacity;
+            std::copy (first, first + m_capacity, matrix.begin () + static_cast<size_t> (row) * capacity);
+          }
+        m_matrix.swap (matrix);
+        m_capacity = capacity;
+      }
+    return index;
+  }
+
+  /**
+   * \param mobility a MobilityModel
+   * \return true if it has a non-zero velocity
+   */
+  static bool IsMoving (Ptr<const MobilityModel> mobility)
+  {
+    Vector velocity = mobility->GetVelocity ();
+    return velocity.x != 0 || velocity.y != 0 || velocity.z != 0;
+  }
+
+  /**
+   * Reset the row and the column of a MobilityModel.
+   *
+   * \param mobility the MobilityModel
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility)
+  {
+    typename Index::const_iterator it = m_index.find (PeekPointer (mobility));
+    if (it == m_index.end ())
+      {
+        return;
+      }
+    uint32_t i = it->second;
+    m_moving[i] = IsMoving (mobility);
+    for (uint32_t k = 0; k < m_mobility.size (); k++)
+      {
+        m_matrix[static_cast<size_t> (i) * m_capacity + k] = m_unknown;
+        m_matrix[static_cast<size_t> (k) * m_capacity + i] = m_unknown;
+      }
+  }
+
+  /// Row and column of each MobilityModel
+  typedef std::unordered_map<const MobilityModel *, uint32_t> Index;
+
+  T m_unknown;                                   //!< value of the entries not computed yet
+  std::vector<T> m_matrix;                       //!< m_capacity rows of m_capacity entries
+  uint32_t m_capacity;                           //!< rows and columns allocated
+  std::vector<Ptr<const MobilityModel> > m_mobility; //!< MobilityModel of each row
+  std::vector<bool> m_moving;                    //!< whether the MobilityModel of each row moves
+  Index m_index;                                 //!< row of each MobilityModel
+  const MobilityModel *m_lastSource;             //!< source of the last Find
+  uint32_t m_lastSourceIndex;                    //!< its row
+};
+
+} // namespace ns3
+
+#endif /* PROPAGATION_MATRIX_CACHE_H */
@@ -22,6 +22,7 @@
 #include "ns3/config.h"
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/cached-propagation-model.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
 
@@ -436,6 +437,64 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class CachedPropagationLossModelTestCase : public TestCase
+{
+public:
+  CachedPropagationLossModelTestCase ();
+  virtual ~CachedPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase ()
+  : TestCase ("Test CachedPropagationLossModel and CachedPropagationDelayModel")
+{
+}
+
+CachedPropagationLossModelTestCase::~CachedPropagationLossModelTestCase ()
+{
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0,0,0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (100,0,0));
+
+  Ptr<LogDistancePropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<CachedPropagationLossModel> loss = CreateObject<CachedPropagationLossModel> ();
+  loss->SetModel (logDistance);
+  double tolerance = 1e-4;
+  for (int i = 0; i < 2; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (loss->CalcRxPower (10, a, b), logDistance->CalcRxPower (10, a, b), tolerance, "Got unexpected rcv power");
+      NS_TEST_EXPECT_MSG_EQ_TOL (loss->CalcRxPower (0, b, a), logDistance->CalcRxPower (0, b, a), tolerance, "Got unexpected rcv power");
+    }
+  // the loss is computed again after a course change
+  b->SetPosition (Vector (200,0,0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (loss->CalcRxPower (10, a, b), logDistance->CalcRxPower (10, a, b), tolerance, "Loss not updated");
+  NS_TEST_EXPECT_MSG_EQ_TOL (loss->CalcRxPower (10, b, a), logDistance->CalcRxPower (10, b, a), tolerance, "Loss not updated");
+
+  NS_TEST_EXPECT_MSG_EQ (CachedPropagationLossModel::IsCacheable (CreateObject<FriisPropagationLossModel> ()), true, "Friis not cacheable");
+  NS_TEST_EXPECT_MSG_EQ (CachedPropagationLossModel::IsCacheable (CreateObject<NakagamiPropagationLossModel> ()), false, "Nakagami cacheable");
+  logDistance->SetNext (CreateObject<NakagamiPropagationLossModel> ());
+  NS_TEST_EXPECT_MSG_EQ (CachedPropagationLossModel::IsCacheable (logDistance), false, "chain with Nakagami cacheable");
+
+  Ptr<ConstantSpeedPropagationDelayModel> speed = CreateObject<ConstantSpeedPropagationDelayModel> ();
+  Ptr<CachedPropagationDelayModel> delay = CreateObject<CachedPropagationDelayModel> ();
+  delay->SetModel (speed);
+  for (int i = 0; i < 2; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (delay->GetDelay (a, b), speed->GetDelay (a, b), "Got unexpected delay");
+    }
+  b->SetPosition (Vector (300,0,0));
+  NS_TEST_EXPECT_MSG_EQ (delay->GetDelay (a, b), speed->GetDelay (a, b), "Delay not updated");
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +509,7 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new CachedPropagationLossModelTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Replay the inputs of the centralized authentication control through
+// every AuthAdmissionController, without the PHY and MAC layers.
+//
+// A trace is recorded by writing every AuthAdmissionInput fired by the
+// AuthAdmission trace source of ApWifiMac, one per line:
+//
+//   static void
+//   RecordAdmission (std::ostream *os, const AuthAdmissionInput &input)
+//   {
+//     *os << input << std::endl;
+//   }
+//   Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::ApWifiMac/AuthAdmission",
+//                                  MakeBoundCallback (&RecordAdmission, &file));
+//
+// Without --Trace a random trace is generated.  The queue counters of a
+// recorded trace stay as they were, only the threshold comes from the
+// controller under test.  The event flags of ApWifiMac stay set until a
+// controller acts on them, so the replay keeps a flag set from the beacon
+// it first appears in until the controller under test clears it.
+//
+// ./waf --run "auth-admission-bench --Trace=admission.txt --Repeat=100"
+
+#include "ns3/core-module.h"
+#include "ns3/auth-admission-controller.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("AuthAdmissionBench");
+
+static std::vector<AuthAdmissionInput>
+ReadTrace (std::string filename)
+{
+  std::vector<AuthAdmissionInput> trace;
+  std::ifstream is (filename.c_str ());
+  if (!is)
+    {
+      NS_FATAL_ERROR ("Cannot open " << filename);
+    }
+  AuthAdmissionInput input;
+  while (is >> input)
+    {
+      trace.push_back (input);
+    }
+  return trace;
+}
+
+static std::vector<AuthAdmissionInput>
+MakeTrace (uint32_t nBeacons)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  std::vector<AuthAdmissionInput> trace (nBeacons);
+  uint32_t last = 0;
+  for (uint32_t b = 0; b < nBeacons; b++)
+    {
+      AuthAdmissionInput &in = trace[b];
+      // bursts of arrivals of varying height, with empty queues in between
+      uint32_t scale = 1 + (b / 200) % 150;
+      in.queueSize = rng->GetInteger (0, 2) == 0 ? 0 : rng->GetInteger (0, scale);
+      in.queueLast = last;
+      in.authRepQueued = rng->GetInteger (0, in.queueSize);
+      in.assocRepQueued = rng->GetInteger (0, in.queueSize - in.authRepQueued);
+      in.authReqReceived = rng->GetInteger (0, 40);
+      in.assocReqReceived = rng->GetInteger (0, 40);
+      in.authRepAcked = rng->GetInteger (0, 40);
+      in.assocRepAcked = rng->GetInteger (0, 40);
+      in.beaconInterval = MilliSeconds (500);
+      in.tau = MilliSeconds (rng->GetInteger (0, 2) == 0 ? 0 : rng->GetInteger (100, 500));
+      in.saturatedAssociated = b >= 20;
+      in.associatingStasAppear = b == 40;
+      in.secondWaveAppear = b == nBeacons / 2;
+      last = in.queueSize;
+    }
+  return trace;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string traceFile;
+  uint32_t nBeacons = 100000;
+  uint32_t repeat = 10;
+
+  CommandLine cmd;
+  cmd.AddValue ("Trace", "File with recorded AuthAdmissionInputs, one per line", traceFile);
+  cmd.AddValue ("Beacons", "Beacons of the random trace used without Trace", nBeacons);
+  cmd.AddValue ("Repeat", "Number of times the trace is replayed", repeat);
+  cmd.Parse (argc, argv);
+
+  std::vector<AuthAdmissionInput> trace = traceFile.empty () ? MakeTrace (nBeacons) : ReadTrace (traceFile);
+  if (trace.empty ())
+    {
+      NS_FATAL_ERROR ("Empty trace");
+    }
+
+  const char *types[] = {
+    "ns3::StepAuthAdmissionController",
+    "ns3::OpenAuthAdmissionController",
+    "ns3::CacAuthAdmissionController",
+    "ns3::Cac2AuthAdmissionController",
+    "ns3::BisectionAuthAdmissionController",
+    "ns3::RatioAuthAdmissionController",
+    "ns3::TauAuthAdmissionController",
+    "ns3::BandAuthAdmissionController",
+    "ns3::OracleAuthAdmissionController",
+    "ns3::WeightedOracleAuthAdmissionController"
+  };
+
+  std::cout << trace.size () << " beacons, replayed " << repeat << " times" << std::endl;
+  std::cout << std::left << std::setw (42) << "Controller"
+            << std::right << std::setw (14) << "beacons/s"
+            << std::setw (12) << "mean thr" << std::setw (10) << "last thr" << std::endl;
+  for (uint32_t t = 0; t < sizeof (types) / sizeof (types[0]); t++)
+    {
+      ObjectFactory factory;
+      factory.SetTypeId (types[t]);
+      double sum = 0;
+      uint16_t threshold = 0;
+      SystemWallClockMs clock;
+      clock.Start ();
+      for (uint32_t r = 0; r < repeat; r++)
+        {
+          // a fresh controller per replay, as in a new run of the simulation
+          Ptr<AuthAdmissionController> controller = factory.Create<AuthAdmissionController> ();
+          bool appear = false;
+          bool secondWave = false;
+          threshold = 0;
+          for (uint32_t b = 0; b < trace.size (); b++)
+            {
+              AuthAdmissionInput in = trace[b];
+              // set on the rising edge, cleared only by the controller under test
+              appear = appear || (in.associatingStasAppear && (b == 0 || !trace[b - 1].associatingStasAppear));
+              secondWave = secondWave || (in.secondWaveAppear && (b == 0 || !trace[b - 1].secondWaveAppear));
+              in.associatingStasAppear = appear;
+              in.secondWaveAppear = secondWave;
+              in.threshold = threshold;
+              controller->Update (in);
+              appear = in.associatingStasAppear;
+              secondWave = in.secondWaveAppear;
+              threshold = std::min<uint16_t> (in.threshold, 1023);
+              sum += threshold;
+            }
+        }
+      int64_t ms = clock.End ();
+      double beacons = static_cast<double> (trace.size ()) * repeat;
+      std::cout << std::left << std::setw (42) << types[t] << std::right << std::setw (14);
+      if (ms > 0)
+        {
+          std::cout << static_cast<uint64_t> (beacons * 1000 / ms);
+        }
+      else
+        {
+          std::cout << "-";
+        }
+      std::cout << std::setw (12) << std::fixed << std::setprecision (1) << sum / beacons
+                << std::setw (10) << threshold << std::endl;
+    }
+
+  return 0;
+}
@@ -44,6 +44,7 @@
 //*************************************
 //HaLow
 #include <fstream>
+#include <sstream>
 //*************************************
 
 namespace ns3 {
@@ -176,6 +177,16 @@ namespace ns3 {
 				MakeUintegerAccessor(&ApWifiMac::GetNAssociating,
 					&ApWifiMac::SetNAssociating),
 				MakeUintegerChecker<uint32_t>())
+			.AddAttribute("AuthThresholdPolicy", "Policy setting the authentication threshold in every beacon of "
+				"algorithms 100 and 101, evaluated in-process instead of by an agent attached to the beaconS1G trace",
+				PointerValue(),
+				MakePointerAccessor(&ApWifiMac::m_authPolicy),
+				MakePointerChecker<AuthThresholdPolicy>())
+			.AddAttribute("AuthAdmissionController", "Centralized authentication control; "
+				"if not set, the controller of the Algorithm attribute is created at the first S1G beacon",
+				PointerValue(),
+				MakePointerAccessor(&ApWifiMac::m_admission),
+				MakePointerChecker<AuthAdmissionController>())
 			//******************************************
 			//HaLow
 			.AddTraceSource ("beaconS1G", "Send beacon S1G.",
@@ -184,6 +195,9 @@ namespace ns3 {
 			.AddTraceSource ("AssAlg", "Set association algorithm.",
 			                 MakeTraceSourceAccessor (&ApWifiMac::m_setAlg),
 			                 "ns3::Mac48Address::TracedCallback")
+			.AddTraceSource ("AuthAdmission", "Input of the centralized authentication control, before its update.",
+			                 MakeTraceSourceAccessor (&ApWifiMac::m_admissionTrace),
+			                 "ns3::AuthAdmissionController::InputTracedCallback")
 			;
 
 		return tid;
@@ -210,11 +224,7 @@ namespace ns3 {
 		m_secondWaveAppear = false;
 
 		m_queueLast = 0;
-		m_delta = 1;
-		m_cac_state = WAIT;
-		m_cac_wait_counter = 5;
-		m_cac_improve_counter = 5;
-		T1 = 1023;
+		m_admissionFromAlgorithm = false;
 
 		m_authSlot = 8;
 
@@ -239,6 +249,8 @@ namespace ns3 {
 	{
 		NS_LOG_FUNCTION(this);
 		m_beaconDca = 0;
+		m_authPolicy = 0;
+		m_admission = 0;
 		m_enableBeaconGeneration = false;
 		m_beaconEvent.Cancel();
 		RegularWifiMac::DoDispose();
@@ -474,6 +486,11 @@ namespace ns3 {
 		ApWifiMac::SetAlgorithm(uint32_t alg)
 	{
 		NS_ASSERT((alg == 0) || (alg == 1) || (alg == 2) || (alg == 3) || (alg == 4) || (alg == 5) || (alg == 6) || (alg == 7) || (alg == 8) || (alg == 9) || (alg == 10) || (alg == 100) || (alg == 101));
+		if (m_admissionFromAlgorithm && alg != algorithm)
+		{
+			m_admission = 0;
+			m_admissionFromAlgorithm = false;
+		}
 		algorithm = alg;
 	}
 
@@ -530,6 +547,10 @@ namespace ns3 {
 		ApWifiMac::SetNAssociating(uint32_t num)
 	{
 		m_nAssociating = num;
+		if (m_admission != 0 && m_admissionFromAlgorithm)
+		{
+			m_admission->SetAttributeFailSafe("NAssociating", UintegerValue(num));
+		}
 	}
 
 	void
@@ -953,49 +974,38 @@ namespace ns3 {
 
 						m_setAlg (this); 
 
-						switch (algorithm)
+						if (algorithm == 100 || algorithm == 101)
+							{
+								m_beaconS1G (this);
+								ApplyAuthPolicy (z - y);
+							}
+						if (m_admission == 0 && algorithm != 100)
+							{
+								m_admission = CreateAuthAdmissionController (algorithm);
+								m_admissionFromAlgorithm = true;
+							}
+						if (m_admission != 0)
 							{
-								case 1:								
-									Algorithm_1 (MgtQueueSize);
-									break;
-								case 2:
-									Algorithm_2 (MgtQueueSize);
-									break;
-								case 3:
-									Algorithm_3 (MgtQueueSize);
-									break;
-								case 4:
-									AuthenThreshold = 1023;
-									break;
-								case 5:
-									Algorithm_5 (MgtQueueSize);
-									break;
-								case 6:
-									Algorithm_6 (MgtQueueSize);
-									break;
-								case 7:
-									Algorithm_7 (MgtQueueSize);
-									break;
-								case 8:									
-									Algorithm_8 (MgtQueueSize);
-									break;
-								case 9:									
-									Algorithm_9 (MgtQueueSize);
-									break;
-								case 10:
-									Algorithm_10 (MgtQueueSize);
-									break;
-								case 100:
-										m_beaconS1G (this);
-										break;
-								case 101:
-										m_beaconS1G (this);
-										Algorithm_10 (MgtQueueSize);
-										break;
-								case 0:
-								default:
-									Algorithm_0 (MgtQueueSize);
-									break;
+								AuthAdmissionInput input;
+								input.queueSize = MgtQueueSize;
+								input.queueLast = m_queueLast;
+								input.authRepQueued = q1;
+								input.assocRepQueued = q2;
+								input.authReqReceived = r1;
+								input.assocReqReceived = r2;
+								input.authRepAcked = a1;
+								input.assocRepAcked = a2;
+								input.tau = m_tau;
+								input.beaconInterval = m_beaconInterval;
+								input.saturatedAssociated = m_saturatedAssociated;
+								input.associatingStasAppear = m_associatingStasAppear;
+								input.secondWaveAppear = m_secondWaveAppear;
+								input.threshold = AuthenThreshold;
+								m_admissionTrace (input);
+								m_admission->Update (input);
+								AuthenThreshold = input.threshold;
+								m_associatingStasAppear = input.associatingStasAppear;
+								m_secondWaveAppear = input.secondWaveAppear;
 							}
 						AuthenThreshold >= 1023 ? AuthenThreshold = 1023 : AuthenThreshold <= 0 ? AuthenThreshold = 0 : AuthenThreshold = AuthenThreshold;
 						AuthenCtrl.SetThreshold(AuthenThreshold); //centralized
@@ -1027,13 +1037,13 @@ namespace ns3 {
 						          << "QAuth   "
 						          << "QAss    "
 						          << "Queue   "
-						          << "Delta   "   // it means NEXT DELTA during learning face
 						          << "Thrshld "
-						          << "State   "
-						          << "Improve "
-						          << "WaitCnt "
-						          << "ImprCnt "
-						          << "State   ");
+						          << "Controller");   // for the CAC algorithms: Delta (the NEXT delta during learning), State, Improve, WaitCnt, ImprCnt
+						std::ostringstream state;
+						if (m_admission != 0)
+							{
+								m_admission->PrintState (state);
+							}
 
 						NS_LOG_UNCOND( Simulator::Now ().GetSeconds () << "\t"
 						          << m-t << "\t"
@@ -1046,13 +1056,8 @@ namespace ns3 {
 						          << q1 << "\t"
 						          << q2 << "\t"
 						          << m_dca->GetQueue ()->GetSize () << "\t"
-						          << m_delta << "\t"
 						          << AuthenThreshold << "\t"
-						          << m_cac_state << "\t"
-						          << m_cac_improve << "\t"
-						          << m_cac_wait_counter << "\t"
-						          << m_cac_improve_counter << "\t"
-						          << m_cac_state << "\t");
+						          << state.str ());
 						          // m = m_low->GetAss();
 						          // z = m_low->GetAuth();
 						m_beaconS1G (this);
@@ -1425,1046 +1430,83 @@ namespace ns3 {
 	  return tmp;
 	}	
 
-	void 
-	ApWifiMac::Algorithm_0 (uint32_t &MgtQueueSize)
-	{
-		if (MgtQueueSize < 10)
-		{
-			AuthenThreshold += value;
-		}
-		else
-		{
-			if (AuthenThreshold > value)
-			{
-				AuthenThreshold -= value;
-			}
-		}
-	}
-	void 
-	ApWifiMac::Algorithm_1 (uint32_t &MgtQueueSize)
-	{
-		if (algorithm == 101)
-		{
-			m_beaconS1G (this);
-		}
-		if (m_cac_state == WAIT)
-		{
-			if (MgtQueueSize != 0)
-			{
-				AuthenThreshold = 0;
-				m_delta = 1;
-				m_cac_improve = false;
-				m_cac_state = LEARN;
-			}
-			else
-			{
-				AuthenThreshold = 1023;
-			}
-		}
-		else if (m_cac_state == LEARN)
-		{
-			if (MgtQueueSize == 0)
-			{
-				if (AuthenThreshold == 1023)
-				{
-					while (m_cac_history.empty() == false)
-					{
-						m_cac_history.pop();
-					}
-					m_cac_state = WAIT;
-				}
-				else
-				{
-					if (m_cac_history.empty() == true || m_cac_history.top().threshold > AuthenThreshold + m_delta)
-					{
-						AuthenThreshold += m_delta;
-						m_delta *= 2;
-						m_cac_improve = true;
-					}
-					else
-					{
-						Triplet top = m_cac_history.top();
-						m_cac_history.pop();
-						AuthenThreshold = top.threshold;
-						m_delta = std::max<int>(m_delta * top.delta / (m_delta + top.delta), 1);
-						m_cac_improve = true;
-					}
-				}
-			}
-			else if (m_cac_improve)
-			{
-				m_delta = std::max<int>(m_delta / 4, 1);
-				AuthenThreshold -= m_delta;
-				m_cac_state = WORK;
-				m_cac_wait_counter = 5;
-				m_cac_improve_counter = 5;
-			}
-		}
-		else // WORK state
-		{
-			if (AuthenThreshold == 1023)
-			{
-				if (m_cac_wait_counter > 0)
-				{
-					m_cac_wait_counter--;
-				}
-				else
-				{
-					while (m_cac_history.empty() == false)
-					{
-						m_cac_history.pop();
-					}
-					m_cac_state = WAIT;
-				}
-			}
-			else if (MgtQueueSize == 0)
-			{
-				if (m_cac_improve_counter > 0)
-				{
-					m_cac_improve_counter--;
-				}
-				else
-				{
-					m_cac_improve = true;
-				}
-				if (m_cac_improve)
-				{
-					m_delta++;
-				}
-				if (m_cac_history.empty() == true || m_cac_history.top().threshold > AuthenThreshold + m_delta)
-				{
-					AuthenThreshold += m_delta;
-				}
-				else
-				{
-					Triplet top = m_cac_history.top();
-					m_cac_history.pop();
-					AuthenThreshold = top.threshold;
-					m_delta = std::max<int>(m_delta * top.delta / (m_delta + top.delta), 1);
-					m_cac_improve = true;
-				}
-				if (AuthenThreshold >= 1023)
-				{
-					AuthenThreshold = 1023;
-					m_cac_improve = false;
-				}
-			}
-			else if (MgtQueueSize > m_newGroupThreshold)
-			{
-				m_cac_history.push(Triplet(AuthenThreshold, m_delta));
-				AuthenThreshold = 0;
-				m_delta = 1;
-				m_cac_improve = false;
-				m_cac_state = LEARN;
-			}
-			else
-			{
-				m_cac_improve_counter = 5;
-				if (m_queueLast == 0)
-				{
-					if (m_cac_improve)
-					{
-						m_delta = std::max<int>(m_delta - 1, 1);
-						m_cac_improve = false;
-					}
-				}
-			}
-		}
-	}
-	void 
-	ApWifiMac::Algorithm_2 (uint32_t &MgtQueueSize)
-	{
-		if (m_cac_state == WAIT)
-		{
-			if (MgtQueueSize != 0)
-			{
-				AuthenThreshold = 0;
-				m_delta = 1;
-				m_cac_improve = false;
-				m_cac_state = LEARN;
-			}
-			else
-			{
-				AuthenThreshold = 1023;
-			}
-		}
-		else if (m_cac_state == LEARN)
-		{
-			if (MgtQueueSize == 0)
-			{
-				if (AuthenThreshold == 1023)
-				{
-					while (m_cac_history.empty() == false)
-					{
-						m_cac_history.pop();
-					}
-					m_cac_state = WAIT;
-				}
-				else
-				{
-					if (m_cac_history.empty() == true || m_cac_history.top().threshold > AuthenThreshold + m_delta)
-					{
-						AuthenThreshold += m_delta;
-						m_delta *= 2;
-						m_cac_improve = true;
-					}
-					else
-					{
-						Triplet top = m_cac_history.top();
-						m_cac_history.pop();
-						AuthenThreshold = top.threshold;
-						m_delta = std::max<int>(m_delta * top.delta / (m_delta + top.delta), 1);
-						m_cac_improve = true;
-					}
-				}
-			}
-			else if (m_cac_improve)
-			{
-				m_delta = std::max<int>(m_delta / 4, 1);
-				AuthenThreshold -= m_delta;
-				m_cac_state = WORK;
-				m_cac_wait_counter = 5;
-				m_cac_improve_counter = 5;
-			}
-		}
-		else // WORK state
-		{
-			if (AuthenThreshold == 1023)
-			{
-				if (m_cac_wait_counter > 0)
-				{
-					m_cac_wait_counter--;
-				}
-				else
-				{
-					while (m_cac_history.empty() == false)
-					{
-						m_cac_history.pop();
-					}
-					m_cac_state = WAIT;
-				}
-			}
-			else if (MgtQueueSize == 0)
-			{
-				if (m_cac_improve_counter > 0)
-				{
-					m_cac_improve_counter--;
-				}
-				else
-				{
-					m_cac_improve = true;
-				}
-				// if (m_cac_improve)
-				//   {
-				m_delta++;
-				// }
-				if (m_cac_history.empty() == true || m_cac_history.top().threshold > AuthenThreshold + m_delta)
-				{
-					AuthenThreshold += m_delta;
-				}
-				else
-				{
-					Triplet top = m_cac_history.top();
-					m_cac_history.pop();
-					AuthenThreshold = top.threshold;
-					m_delta = std::max<int>(m_delta * top.delta / (m_delta + top.delta), 1);
-					m_cac_improve = true;
-				}
-				if (AuthenThreshold >= 1023)
-				{
-					AuthenThreshold = 1023;
-					m_cac_improve = false;
-				}
-			}
-			else if (MgtQueueSize > m_newGroupThreshold)
-			{
-				m_cac_history.push(Triplet(AuthenThreshold, m_delta));
-				AuthenThreshold = 0;
-				m_delta = 1;
-				m_cac_improve = false;
-				m_cac_state = LEARN;
-			}
-			else
-			{
-				m_cac_improve_counter = 5;
-				m_delta = std::max<int>(m_delta - 1, 1);
-				if (m_queueLast == 0)
-				{
-					if (m_cac_improve)
-					{
-						m_cac_improve = false;
-					}
-				}
-			}
-		}	
-	}
-	void 
-	ApWifiMac::Algorithm_3 (uint32_t &MgtQueueSize)
-	{
-		if (m_cac_state == WAIT)
-		{
-			if (MgtQueueSize != 0)
-			{
-				AuthenThreshold = 0;
-				m_delta = 1023;
-				m_cac_improve = false;
-				m_cac_wait_counter = 5;
-				m_cac_state = LEARN;
-			}
-			else
-			{
-				AuthenThreshold = 1023;
-			}
-		}
-		else if (m_cac_state == LEARN)
-		{
-			if (AuthenThreshold != 0)
-			{
-				if (MgtQueueSize != 0)
-				{
-					AuthenThreshold = 0;
-				}
-				else
-				{
-					m_delta /= 2;
-					m_cac_improve = true;
-					m_cac_state = WORK;
-				}
-			}
-			else if (MgtQueueSize == 0)
-			{
-				m_delta /= 2;
-				AuthenThreshold = m_delta;
-			}
-		}
-		else // WORK state
-		{
-			if (AuthenThreshold == 1023)
-			{
-				m_cac_wait_counter--;
-				if (m_cac_wait_counter <= 0)
-				{
-					m_cac_state = WAIT;
-				}
-			}
-			else if (MgtQueueSize == 0)
-			{
-				if (m_cac_improve)
-				{
-					m_delta++;
-				}
-				AuthenThreshold += m_delta;
-				if (AuthenThreshold >= 1023)
-				{
-					AuthenThreshold = 1023;
-					m_cac_improve = false;
-				}
-			}
-			else
-			{
-				if (m_queueLast == 0)
-				{
-					if (m_cac_improve)
-					{
-						m_delta = std::max<int>(m_delta - 1, 1);
-						m_cac_improve = false;
-					}
-				}
-			}
-		}	
-	}
-	void 
-	ApWifiMac::Algorithm_5 (uint32_t &MgtQueueSize) // ORACLE
-	{
-		if (!m_saturatedAssociated)
-		{
-			AuthenThreshold = 1023;
-		}
-		else if (m_associatingStasAppear)
-		{
-			AuthenThreshold = 1023 * value / m_nAssociating;
-			m_associatingStasAppear = 0;
-		}
-		else if (MgtQueueSize == 0)
-		{
-			AuthenThreshold += 1023 * value / m_nAssociating;
-		}
-	}
-	void 
-	ApWifiMac::Algorithm_6 (uint32_t &MgtQueueSize) // ORACLE WITH COEFFICIENT
-	{
-		if (!m_saturatedAssociated)
-		{
-			AuthenThreshold = 1023;
-		}
-		else if (m_associatingStasAppear)
-		{
-			m_delta = 1023 * value / m_nAssociating;
-			AuthenThreshold = m_delta;
-			m_associatingStasAppear = 0;
-			firstWave = m_nAssociating;
-		}
-		else if (m_secondWaveAppear)
-		{
-			T1 = AuthenThreshold;
-			AuthenThreshold = 0;
-			m_delta = 1023 * value / (m_nAssociating - firstWave);  // only second group taken into account
-			m_secondWaveAppear = 0;
-		}
-		else if (MgtQueueSize == 0)
-		{
-			if (AuthenThreshold + m_delta > T1)     // after threshold reaches previous value
-			{
-				m_delta = 1023 * value / m_nAssociating; // both groups taken into account
-			}
-			AuthenThreshold += m_delta;
-		}
-		else
-		{
-			if (AuthenThreshold + m_delta > T1)
-			{
-				m_delta = 1023 * value / m_nAssociating;
-			}
-			double decrease_ratio;
-			double L_r1 = 58;  //size of AuthReqs
-			double L_a1 = 56; //size of AuthRep
-			double L_r2 = 118; //size of AReqs
-			double L_a2 = 89; // size of AReps
-			m_delta = 1023 * value / m_nAssociating;
-
-			decrease_ratio = (r1 * L_r1 + (a1 - q1) * L_a1 + (r2 - q1) * L_r2 + (a2 - q1 - q2) * L_a2) / (r1 * L_r1 + a1 * L_a1 + r2 * L_r2 + a2 * L_a2);
-			std::cout << "Ratio " << decrease_ratio << '\n';
-
-			if (decrease_ratio > 0)
-			{
-				m_delta_temp = std::max<int>(1, floor(m_delta * decrease_ratio));
-				std::cout << "Temp Delta " << m_delta_temp << '\n';
-				AuthenThreshold += m_delta_temp;
-			}
-		}
-	}
-	void 
-	ApWifiMac::Algorithm_7 (uint32_t &MgtQueueSize)   // NEW PROPOSED ALGORITHM MODIFICATION A
-	{
-		if (m_cac_state == WAIT)
-		{
-
-			if (MgtQueueSize > m_learningThreshold)
-			{
-				AuthenThreshold = 0;
-				m_delta = 1;
-				m_cac_improve = false;
-				m_cac_state = LEARN;
-			}
-			else
-			{
-				AuthenThreshold = 1023;
-			}
-		}
-		else if (m_cac_state == LEARN)
-		{
-			if (MgtQueueSize == 0)
-			{
-				if (AuthenThreshold == 1023)
-				{
-					while (m_cac_history.empty() == false)
-					{
-						m_cac_history.pop();
-					}
-					m_cac_state = WAIT;
-				}
-				else
-				{
-					if (m_cac_history.empty() == true || m_cac_history.top().threshold > AuthenThreshold + m_delta)
-					{
-						AuthenThreshold += m_delta;
-						m_delta *= 2;
-						m_cac_improve = true;
-					}
-					else
-					{
-						Triplet top = m_cac_history.top();
-						m_cac_history.pop();
-						AuthenThreshold = top.threshold;
-						m_delta = std::max<int>(m_delta * top.delta / (m_delta + top.delta), 1);
-						m_cac_improve = true;
-					}
-				}
-			}
-			else if (m_cac_improve)
-			{
-				m_delta = std::max<int>(m_delta / 4, 1);
-				AuthenThreshold -= m_delta;
-				m_cac_state = WORK;
-				m_cac_wait_counter = 5;
-				m_cac_improve_counter = 5;
-			}
-		}
-		else // WORK state
-		{
-			if (AuthenThreshold == 1023)
-			{
-				if (m_cac_wait_counter > 0)
-				{
-					m_cac_wait_counter--;
-				}
-				else
-				{
-					while (m_cac_history.empty() == false)
-					{
-						m_cac_history.pop();
-					}
-					m_cac_state = WAIT;
-				}
-			}
-			else if (MgtQueueSize == 0)
-			{
-				if (m_cac_improve_counter > 0)
-				{
-					m_cac_improve_counter--;
-				}
-				else
-				{
-					m_cac_improve = true;
-				}
-				if (m_cac_improve)
-				{
-					m_delta++;
-				}
-				if (m_cac_history.empty() == true || m_cac_history.top().threshold > AuthenThreshold + m_delta)
-				{
-					AuthenThreshold += m_delta;
-				}
-				else
-				{
-					Triplet top = m_cac_history.top();
-					m_cac_history.pop();
-					AuthenThreshold = top.threshold;
-					m_delta = std::max<int>(m_delta * top.delta / (m_delta + top.delta), 1);
-					m_cac_improve = true;
-				}
-				if (AuthenThreshold >= 1023)
-				{
-					AuthenThreshold = 1023;
-					m_cac_improve = false;
-				}
-			}
-			else if (MgtQueueSize > m_newGroupThreshold)
-			{
-				m_cac_history.push(Triplet(AuthenThreshold, m_delta));
-				AuthenThreshold = 0;
-				m_delta = 1;
-				m_cac_improve = false;
-				m_cac_state = LEARN;
-			}
-			else
-			{
-				m_cac_improve_counter = 5;
-				if (m_queueLast == 0)
-				{
-					if (m_cac_improve)
-					{
-						m_delta = std::max<int>(m_delta - 1, 1);
-						m_cac_improve = false;
-					}
-				}
-				double decrease_ratio;
-				double L_r1 = 58;  //size of AuthReqs
-				double L_a1 = 56; //size of AuthRep
-				double L_r2 = 118; //size of AReqs
-				double L_a2 = 89; // size of AReps
-
-				decrease_ratio = (r1 * L_r1 + (a1 - q1) * L_a1 + (r2 - q1) * L_r2 + (a2 - q1 - q2) * L_a2) / (r1 * L_r1 + a1 * L_a1 + r2 * L_r2 + a2 * L_a2);
-				std::cout << "Ratio " << decrease_ratio << '\n';
-
-				if (decrease_ratio > 0)
-				{
-					m_delta_temp = std::max<int>(1, floor(m_delta * decrease_ratio));
-					std::cout << "Temp Delta " << m_delta_temp << '\n';
-					if (m_cac_history.empty() == true || m_cac_history.top().threshold > AuthenThreshold + m_delta_temp)
-					{
-						AuthenThreshold += m_delta_temp;
-					}
-					else
-					{
-						Triplet top = m_cac_history.top();
-						m_cac_history.pop();
-						AuthenThreshold = top.threshold;
-						m_delta = std::max<int>(m_delta * top.delta / (m_delta + top.delta), 1);
-						m_cac_improve = true;
-					}
-				}
-			}
-		}
-	}
-	void 
-	ApWifiMac::Algorithm_8 (uint32_t &MgtQueueSize)  ///// NEW PROPOSED ALGORITHM
+	void
+	ApWifiMac::ApplyAuthPolicy (uint32_t authRespAcked)
 	{
-		if (m_cac_state == WAIT)
-		{
-			if (MgtQueueSize != 0)
-			{
-				AuthenThreshold = 0;
-				m_delta = 1;
-				m_cac_improve = false;
-				m_cac_state = LEARN;
-			}
-			else
-			{
-				AuthenThreshold = 1023;
-			}
-		}
-		else if (m_cac_state == LEARN)
-		{
-			if (MgtQueueSize == 0)
-			{
-				if (AuthenThreshold == 1023)
-				{
-					while (m_cac_history.empty() == false)
-					{
-						m_cac_history.pop();
-					}
-					m_cac_state = WAIT;
-				}
-				else
-				{
-					if (m_cac_history.empty() == true || m_cac_history.top().threshold > AuthenThreshold + m_delta)
-					{
-						AuthenThreshold += m_delta;
-						m_delta *= 2;
-						m_cac_improve = true;
-					}
-					else
-					{
-						Triplet top = m_cac_history.top();
-						m_cac_history.pop();
-						AuthenThreshold = top.threshold;
-						m_delta = std::max<int>(m_delta * top.delta / (m_delta + top.delta), 1);
-						m_cac_improve = true;
-					}
-				}
-			}
-			else if (m_cac_improve)
-			{
-				m_delta = std::max<int>(m_delta / 4, 1);
-				AuthenThreshold -= m_delta;
-				m_cac_state = WORK;
-				m_cac_wait_counter = 5;
-				m_cac_improve_counter = 5;
-			}
-		}
-		else // WORK state
+		if (m_authPolicy == 0)
 		{
-			if (AuthenThreshold == 1023)
-			{
-				if (m_cac_wait_counter > 0)
-				{
-					m_cac_wait_counter--;
-				}
-				else
-				{
-					while (m_cac_history.empty() == false)
-					{
-						m_cac_history.pop();
-					}
-					m_cac_state = WAIT;
-				}
-			}
-			else if (MgtQueueSize == 0)
-			{
-				if (m_cac_improve)
-				{
-					//m_delta++;   // option 1                              
-					//m_delta = m_delta * T_BI/tau;  // OPTION 2
-					std::cout << "tau: " << m_tau.GetMilliSeconds() << '\n';
-					std::cout << "BI: " << m_beaconInterval.GetMilliSeconds() << '\n';
-					if (m_tau > 0)
-					{
-						double increase_ratio = m_beaconInterval.GetMilliSeconds() / m_tau.GetMilliSeconds();
-						std::cout << "increasing Delta " << increase_ratio << " times" << '\n';
-						m_delta = m_delta * increase_ratio;
-					}
-					// END OPTION 2
-				}
-
-				if (m_cac_history.empty() == true || m_cac_history.top().threshold > AuthenThreshold + m_delta)
-				{
-					AuthenThreshold += m_delta;
-					m_cac_improve = true;
-				}
-				else
-				{
-					Triplet top = m_cac_history.top();
-					m_cac_history.pop();
-					AuthenThreshold = top.threshold;
-					m_delta = std::max<int>(m_delta * top.delta / (m_delta + top.delta), 1);
-					m_cac_improve = true;
-				}
-				if (AuthenThreshold >= 1023)
-				{
-					AuthenThreshold = 1023;
-					m_cac_improve = false;
-				}
-			}
-			else if (MgtQueueSize > m_newGroupThreshold)
-			{
-				m_cac_history.push(Triplet(AuthenThreshold, m_delta));
-				AuthenThreshold = 0;
-				m_delta = 1;
-				m_cac_improve = false;
-				m_cac_state = LEARN;
-			}
-			else  ////// queue is not empty
-			{
-
-				// //// option 1
-				//double success_channel_ratio;
-				//  double D;
-				//  double T_r1 = 0.00016;  //time of AuthReqs
-				//  double T_a1 = 0.00188; //time of AuthRep
-				//  double T_r2 = 0.00016; //time of AReqs
-				//  double T_a2 = 0.00232; // time of AReps
-				//  D = r1 * T_r1 + a1 * T_a1 + r2 * T_r2 + a2 * T_a2;
-				//  success_channel_ratio = fabs((D - q1*(T_a1+T_r2)-T_a2*(q1+q2))/D);
-				//  std::cout << "D " << D << '\n';
-
-				//// option 2
-				double success_channel_ratio;
-				double L_r1 = 58;  //size of AuthReqs
-				double L_a1 = 56; //size of AuthRep
-				double L_r2 = 118; //size of AReqs
-				double L_a2 = 89; // size of AReps
-
-				success_channel_ratio = (r1 * L_r1 + (a1 - q1) * L_a1 + (r2 - q1) * L_r2 + (a2 - q1 - q2) * L_a2) / (r1 * L_r1 + a1 * L_a1 + r2 * L_r2 + a2 * L_a2);
-				std::cout << "Ratio " << success_channel_ratio << '\n';
-
-				if (success_channel_ratio > 0)
-				{
-					m_delta = std::max<int>(1, floor(m_delta * success_channel_ratio));
-					std::cout << "Floor " << m_delta << '\n';
-					AuthenThreshold += m_delta;
-				}
-			}
+			return;
 		}
+		float features[AuthThresholdPolicy::N_FEATURES];
+		features[0] = q1;
+		features[1] = q2;
+		features[2] = authRespAcked;
+		features[3] = AuthenThreshold;
+		AuthenThreshold = m_authPolicy->GetThreshold (features);
 	}
-	void 
-	ApWifiMac::Algorithm_9 (uint32_t &MgtQueueSize)
-	{
-		if (m_cac_state == WAIT)
-		{
-			if (MgtQueueSize != 0)
-			{
-				AuthenThreshold = 0;
-				m_delta = 1;
-				m_cac_improve = false;
-				m_cac_state = LEARN;
-			}
-			else
-			{
-				AuthenThreshold = 1023;
-			}
-		}
-		else if (m_cac_state == LEARN)
-		{
-			if (MgtQueueSize == 0)
-			{
-				if (AuthenThreshold == 1023)
-				{
-					while (m_cac_history.empty() == false)
-					{
-						m_cac_history.pop();
-					}
-					m_cac_state = WAIT;
-				}
-				else
-				{
-					if (m_cac_history.empty() == true || m_cac_history.top().threshold > AuthenThreshold + m_delta)
-					{
-						AuthenThreshold += m_delta;
-						m_delta *= 2;
-						m_cac_improve = true;
-					}
-					else
-					{
-						Triplet top = m_cac_history.top();
-						m_cac_history.pop();
-						AuthenThreshold = top.threshold;
-						m_delta = std::max<int>(m_delta * top.delta / (m_delta + top.delta), 1);
-						m_cac_improve = true;
-					}
-				}
-			}
-			else if (m_cac_improve)
-			{
-				m_delta = std::max<int>(m_delta / 4, 1);
-				AuthenThreshold -= m_delta;
-				m_cac_state = WORK;
-				m_cac_wait_counter = 5;
-				m_cac_improve_counter = 5;
-			}
-		}
-		else // WORK state
-		{
-			if (AuthenThreshold == 1023)
-			{
-				if (m_cac_wait_counter > 0)
-				{
-					m_cac_wait_counter--;
-				}
-				else
-				{
-					while (m_cac_history.empty() == false)
-					{
-						m_cac_history.pop();
-					}
-					m_cac_state = WAIT;
-				}
-			}
-			else if (MgtQueueSize == 0)
-			{
-				if (m_cac_improve)
-				{
-					m_delta++;
-				}
 
-				if (m_cac_history.empty() == true || m_cac_history.top().threshold > AuthenThreshold + m_delta)
-				{
-					AuthenThreshold += m_delta;
-					m_cac_improve = true;
-				}
-				else
-				{
-					Triplet top = m_cac_history.top();
-					m_cac_history.pop();
-					AuthenThreshold = top.threshold;
-					m_delta = std::max<int>(m_delta * top.delta / (m_delta + top.delta), 1);
-					m_cac_improve = true;
-				}
-				if (AuthenThreshold >= 1023)
-				{
-					AuthenThreshold = 1023;
-					m_cac_improve = false;
-				}
-			}
-			else if (MgtQueueSize <= 5)
-			{
-				AuthenThreshold += m_delta;
-				m_cac_improve = false;
-			}
-			// if higher than 5 but less than 11 - keep threshold as it is, keep delta as it is
-			else if (MgtQueueSize > 5 && MgtQueueSize <= 10)
-			{
-				m_cac_improve = false;
-			}
-			else if (MgtQueueSize > 10 && MgtQueueSize <= 20)
-			{
-				m_delta = std::max<int>(m_delta - 1, 1);
-				m_cac_improve = false;
-			}
-			else if (MgtQueueSize > 20 && MgtQueueSize <= 30)
-			{
-				m_delta = std::max<int>(m_delta - 2, 1);
-				m_cac_improve = false;
-			}
-			else if (MgtQueueSize > 30 && MgtQueueSize <= 40)
-			{
-				m_delta = std::max<int>(m_delta - 3, 1);
-				m_cac_improve = false;
-			}
-			else if (MgtQueueSize > 40 && MgtQueueSize <= 50)
-			{
-				m_delta = std::max<int>(m_delta - 4, 1);
-				m_cac_improve = false;
-			}
-			else if (MgtQueueSize > 50 && MgtQueueSize <= 60)
-			{
-				m_delta = std::max<int>(m_delta - 5, 1);
-				m_cac_improve = false;
-			}
-			else if (MgtQueueSize > 60 && MgtQueueSize <= 70)
-			{
-				m_delta = std::max<int>(m_delta - 6, 1);
-				m_cac_improve = false;
-			}
-			else if (MgtQueueSize > 70 && MgtQueueSize <= 80)
-			{
-				m_delta = std::max<int>(m_delta - 7, 1);
-				m_cac_improve = false;
-			}
-			else if (MgtQueueSize > 80 && MgtQueueSize <= 90)
-			{
-				m_delta = std::max<int>(m_delta - 8, 1);
-				m_cac_improve = false;
-			}
-			else if (MgtQueueSize > 90 && MgtQueueSize <= 100)
-			{
-				m_delta = std::max<int>(m_delta - 9, 1);
-				m_cac_improve = false;
-			}
-			else if (MgtQueueSize > 100)
-			{
-				m_cac_history.push(Triplet(AuthenThreshold, m_delta));
-				AuthenThreshold = 0;
-				m_delta = 1;
-				m_cac_improve = false;
-				m_cac_state = LEARN;
-			}
-		}
-	}
-	void 
-	ApWifiMac::Algorithm_10 (uint32_t &MgtQueueSize)  // NEW Algorithm with correct time slot values
+	Ptr<AuthAdmissionController>
+	ApWifiMac::CreateAuthAdmissionController (uint32_t alg) const
 	{
-		if (m_cac_state == WAIT)
+		ObjectFactory factory;
+		switch (alg)
 		{
-			//    if (MgtQueueSize != 0)
-			// do not start learning when there is small STA number
-			if (MgtQueueSize > m_learningThreshold)
-			{
-				AuthenThreshold = 0;
-				m_delta = 1;
-				m_cac_improve = false;
-				m_cac_state = LEARN;
-			}
-			else
-			{
-				AuthenThreshold = 1023;
-			}
+			case 1:
+				factory.SetTypeId ("ns3::CacAuthAdmissionController");
+				break;
+			case 2:
+				factory.SetTypeId ("ns3::Cac2AuthAdmissionController");
+				break;
+			case 3:
+				factory.SetTypeId ("ns3::BisectionAuthAdmissionController");
+				break;
+			case 4:
+				factory.SetTypeId ("ns3::OpenAuthAdmissionController");
+				break;
+			case 5:
+				factory.SetTypeId ("ns3::OracleAuthAdmissionController");
+				break;
+			case 6:
+				factory.SetTypeId ("ns3::WeightedOracleAuthAdmissionController");
+				break;
+			case 7:
+			case 8:
+				// frames weighted by their size in bytes
+				factory.SetTypeId (alg == 7 ? "ns3::RatioAuthAdmissionController" : "ns3::TauAuthAdmissionController");
+				factory.Set ("AuthReqCost", DoubleValue (58));
+				factory.Set ("AuthRepCost", DoubleValue (56));
+				factory.Set ("AssocReqCost", DoubleValue (118));
+				factory.Set ("AssocRepCost", DoubleValue (89));
+				break;
+			case 9:
+				factory.SetTypeId ("ns3::BandAuthAdmissionController");
+				break;
+			case 10:
+			case 101:
+				factory.SetTypeId ("ns3::RatioAuthAdmissionController");
+				break;
+			case 100:
+				return 0;
+			case 0:
+			default:
+				factory.SetTypeId ("ns3::StepAuthAdmissionController");
+				factory.Set ("Step", UintegerValue (value));
+				break;
 		}
-		else if (m_cac_state == LEARN)
+		if (alg == 5 || alg == 6)
 		{
-			if (MgtQueueSize == 0)
-			{
-				if (AuthenThreshold == 1023)
-				{
-					while (m_cac_history.empty() == false)
-					{
-						m_cac_history.pop();
-					}
-					m_cac_state = WAIT;
-				}
-				else
-				{
-					if (m_cac_history.empty() == true || m_cac_history.top().threshold > AuthenThreshold + m_delta)
-					{
-						AuthenThreshold += m_delta;
-						m_delta *= 2;
-						m_cac_improve = true;
-					}
-					else
-					{
-						Triplet top = m_cac_history.top();
-						m_cac_history.pop();
-						AuthenThreshold = top.threshold;
-						m_delta = std::max<int>(m_delta * top.delta / (m_delta + top.delta), 1);
-						m_cac_improve = true;
-					}
-				}
-			}
-			else if (m_cac_improve)
-			{
-				m_delta = std::max<int>(m_delta / 4, 1);
-				AuthenThreshold -= m_delta;
-				m_cac_state = WORK;
-				m_cac_wait_counter = 5;
-				m_cac_improve_counter = 5;
-			}
+			factory.Set ("Value", UintegerValue (value));
+			factory.Set ("NAssociating", UintegerValue (m_nAssociating));
 		}
-		else // WORK state
+		else if (alg != 0 && alg != 4)
 		{
-			if (AuthenThreshold == 1023)
-			{
-				if (m_cac_wait_counter > 0)
-				{
-					m_cac_wait_counter--;
-				}
-				else
-				{
-					while (m_cac_history.empty() == false)
-					{
-						m_cac_history.pop();
-					}
-					m_cac_state = WAIT;
-				}
-			}
-			else if (MgtQueueSize == 0)
-			{
-				if (m_cac_improve_counter > 0)
-				{
-					m_cac_improve_counter--;
-				}
-				else
-				{
-					m_cac_improve = true;
-				}
-				if (m_cac_improve)
-				{
-					m_delta++;
-				}
-				if (m_cac_history.empty() == true || m_cac_history.top().threshold > AuthenThreshold + m_delta)
-				{
-					AuthenThreshold += m_delta;
-				}
-				else
-				{
-					Triplet top = m_cac_history.top();
-					m_cac_history.pop();
-					AuthenThreshold = top.threshold;
-					m_delta = std::max<int>(m_delta * top.delta / (m_delta + top.delta), 1);
-					m_cac_improve = true;
-				}
-				if (AuthenThreshold >= 1023)
-				{
-					AuthenThreshold = 1023;
-					m_cac_improve = false;
-				}
-			}
-			else if (MgtQueueSize > m_newGroupThreshold)
-			{
-				m_cac_history.push(Triplet(AuthenThreshold, m_delta));
-				AuthenThreshold = 0;
-				m_delta = 1;
-				m_cac_improve = false;
-				m_cac_state = LEARN;
-			}
-			else
+			factory.Set ("NewGroupThreshold", UintegerValue (m_newGroupThreshold));
+			if (alg == 7 || alg == 10 || alg == 101)
 			{
-				m_cac_improve_counter = 5;
-				if (m_queueLast == 0)
-				{
-					if (m_cac_improve)
-					{
-						m_delta = std::max<int>(m_delta - 1, 1);
-						m_cac_improve = false;
-					}
-				}
-				double decrease_ratio;
-				double L_r1 = 720 + 160 + 1000; //time needed to transmit AuthReq + SIFS + Ack
-				double L_a1 = 720 + 160 + 1000; //time needed to transmit AuthRep + SIFS + Ack
-				double L_r2 = 1520 + 160 + 1000; //time needed to transmit AReq + SIFS + Ack
-				double L_a2 = 1160 + 160 + 1000; //time needed to transmit ARep + SIFS + Ack
-
-				decrease_ratio = (r1 * L_r1 + (a1 - q1) * L_a1 + (r2 - q1) * L_r2 + (a2 - q1 - q2) * L_a2) / (r1 * L_r1 + a1 * L_a1 + r2 * L_r2 + a2 * L_a2);
-
-				std::cout << "Ratio " << decrease_ratio << '\n';
-				if (decrease_ratio > 0)
-				{
-					m_delta_temp = std::max<int>(1, floor(m_delta * decrease_ratio));
-					std::cout << "Temp Delta " << m_delta_temp << '\n';
-					if (m_cac_history.empty() == true || m_cac_history.top().threshold > AuthenThreshold + m_delta_temp)
-					{
-						AuthenThreshold += m_delta_temp;
-					}
-					else
-					{
-						Triplet top = m_cac_history.top();
-						m_cac_history.pop();
-						AuthenThreshold = top.threshold;
-						m_delta = std::max<int>(m_delta * top.delta / (m_delta + top.delta), 1);
-						m_cac_improve = true;
-					}
-				}
+				factory.Set ("LearningThreshold", UintegerValue (m_learningThreshold));
 			}
 		}
+		return factory.Create<AuthAdmissionController> ();
 	}
 
 } //namespace ns3
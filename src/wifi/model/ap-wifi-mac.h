@@ -30,8 +30,9 @@
 #include "ns3/random-variable-stream.h"
 #include "rps.h"
 #include "s1g-raw-control.h"
+#include "auth-threshold-policy.h"
+#include "auth-admission-controller.h"
 #include "ns3/string.h"
-#include <stack>
 
 
 namespace ns3 {
@@ -120,16 +121,12 @@ public:
   //HaLow
   void SetAuthenThreshold (uint32_t AuthThr);
   void SetAlgorithm (uint32_t alg);
-  void Algorithm_0 (uint32_t &MgtQueueSize);
-  void Algorithm_1 (uint32_t &MgtQueueSize);
-  void Algorithm_2 (uint32_t &MgtQueueSize);
-  void Algorithm_3 (uint32_t &MgtQueueSize);
-  void Algorithm_5 (uint32_t &MgtQueueSize);
-  void Algorithm_6 (uint32_t &MgtQueueSize);
-  void Algorithm_7 (uint32_t &MgtQueueSize);
-  void Algorithm_8 (uint32_t &MgtQueueSize);
-  void Algorithm_9 (uint32_t &MgtQueueSize);
-  void Algorithm_10 (uint32_t &MgtQueueSize);
+  /**
+   * Set AuthenThreshold from m_authPolicy, if any (algorithms 100 and 101).
+   *
+   * \param authRespAcked the number of AuthReps acknowledged since the last beacon
+   */
+  void ApplyAuthPolicy (uint32_t authRespAcked);
   Ptr<WifiMacQueue> GetQueueInfo(void);
   Ptr<MacLow> GetMlowInfo(void);
   uint32_t GetAuthResp(void);
@@ -139,13 +136,15 @@ public:
 
 
 private:
-
-  enum CAC_STATES
-  {
-    WAIT,
-    LEARN,
-    WORK
-  } m_cac_state;
+  /**
+   * Create the AuthAdmissionController of a numbered algorithm, configured
+   * from the Value, NAssociating, LearningThreshold and NewGroupThreshold
+   * attributes.
+   *
+   * \param alg the algorithm number
+   * \return the controller, null for the agent-driven algorithm 100
+   */
+  Ptr<AuthAdmissionController> CreateAuthAdmissionController (uint32_t alg) const;
 
   virtual void Receive (Ptr<Packet> packet, const WifiMacHeader *hdr);
   /**
@@ -333,15 +332,9 @@ private:
   bool m_secondWaveAppear;
   uint32_t m_nAssociating;
 
-  int m_cac_wait_counter;                   //number of beacon intervals before move to waiting mode after working mode with threshold=1023
-  int m_cac_improve_counter;                //number of beacon intervals with empty queue before improving delta
-  int m_cac_learn_counter;                  //number of beacon intervals with non-empty queue before transit to study mode again
-  bool m_cac_improve;
-
   Time m_tau;
   Time m_lastBeacon;
 
-  int m_delta, m_delta_temp, m_delta_reduced;
   int m_queueLast;
 
 
@@ -360,10 +353,6 @@ private:
   int q1 = 0;                                   // the number of AuthReps remaining in the queue
   int q2 = 0;                                   // the number of AReps remaining in the queue
 
-  int T1 = 1023;                                 // threshold to memorize in algorithm oracle for twogroups scenario
-  uint32_t firstWave = 0;
-  uint32_t secondWave = 0;
-
   int sent_ass = 0;
   int sent_auth = 0;
 
@@ -373,17 +362,15 @@ private:
   uint32_t contAssocResp;
 
 
-  struct Triplet {
-    int delta;
-    int threshold;
-    Triplet(int t = 0, int d = 0) : threshold(t), delta(d) {}
-  };
-  std::stack<Triplet> m_cac_history;
   //********************************************
   //HaLow
   //TracedCallback<Mac48Address> m_beaconS1G;
   TracedCallback<Ptr<ApWifiMac>> m_beaconS1G;
   TracedCallback<Ptr<ApWifiMac>> m_setAlg;
+  Ptr<AuthThresholdPolicy> m_authPolicy;     //!< in-process policy replacing the external agent of algorithms 100/101
+  Ptr<AuthAdmissionController> m_admission;  //!< centralized authentication control
+  bool m_admissionFromAlgorithm;             //!< m_admission was created for the Algorithm attribute
+  TracedCallback<const AuthAdmissionInput &> m_admissionTrace;
 
 };
 
@@ -0,0 +1,771 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "auth-admission-controller.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AuthAdmissionController");
+
+NS_OBJECT_ENSURE_REGISTERED (AuthAdmissionController);
+NS_OBJECT_ENSURE_REGISTERED (StepAuthAdmissionController);
+NS_OBJECT_ENSURE_REGISTERED (OpenAuthAdmissionController);
+NS_OBJECT_ENSURE_REGISTERED (CacAuthAdmissionController);
+NS_OBJECT_ENSURE_REGISTERED (Cac2AuthAdmissionController);
+NS_OBJECT_ENSURE_REGISTERED (BisectionAuthAdmissionController);
+NS_OBJECT_ENSURE_REGISTERED (RatioAuthAdmissionController);
+NS_OBJECT_ENSURE_REGISTERED (TauAuthAdmissionController);
+NS_OBJECT_ENSURE_REGISTERED (BandAuthAdmissionController);
+NS_OBJECT_ENSURE_REGISTERED (OracleAuthAdmissionController);
+NS_OBJECT_ENSURE_REGISTERED (WeightedOracleAuthAdmissionController);
+
+/**
+ * Share of the channel used by frames of completed exchanges, each frame
+ * weighted by its cost.
+ */
+static double
+GetSuccessRatio (const AuthAdmissionInput &in,
+                 double authReqCost, double authRepCost, double assocReqCost, double assocRepCost)
+{
+  int r1 = in.authReqReceived;
+  int r2 = in.assocReqReceived;
+  int a1 = in.authRepAcked;
+  int a2 = in.assocRepAcked;
+  int q1 = in.authRepQueued;
+  int q2 = in.assocRepQueued;
+  return (r1 * authReqCost + (a1 - q1) * authRepCost + (r2 - q1) * assocReqCost + (a2 - q1 - q2) * assocRepCost)
+         / (r1 * authReqCost + a1 * authRepCost + r2 * assocReqCost + a2 * assocRepCost);
+}
+
+AuthAdmissionInput::AuthAdmissionInput ()
+  : queueSize (0),
+    queueLast (0),
+    authRepQueued (0),
+    assocRepQueued (0),
+    authReqReceived (0),
+    assocReqReceived (0),
+    authRepAcked (0),
+    assocRepAcked (0),
+    tau (0),
+    beaconInterval (0),
+    saturatedAssociated (false),
+    associatingStasAppear (false),
+    secondWaveAppear (false),
+    threshold (0)
+{
+}
+
+std::ostream &
+operator << (std::ostream &os, const AuthAdmissionInput &input)
+{
+  os << input.queueSize << " " << input.queueLast << " "
+     << input.authRepQueued << " " << input.assocRepQueued << " "
+     << input.authReqReceived << " " << input.assocReqReceived << " "
+     << input.authRepAcked << " " << input.assocRepAcked << " "
+     << input.tau.GetNanoSeconds () << " " << input.beaconInterval.GetNanoSeconds () << " "
+     << input.saturatedAssociated << " " << input.associatingStasAppear << " "
+     << input.secondWaveAppear << " " << input.threshold;
+  return os;
+}
+
+std::istream &
+operator >> (std::istream &is, AuthAdmissionInput &input)
+{
+  int64_t tau;
+  int64_t beaconInterval;
+  is >> input.queueSize >> input.queueLast
+  >> input.authRepQueued >> input.assocRepQueued
+  >> input.authReqReceived >> input.assocReqReceived
+  >> input.authRepAcked >> input.assocRepAcked
+  >> tau >> beaconInterval
+  >> input.saturatedAssociated >> input.associatingStasAppear
+  >> input.secondWaveAppear >> input.threshold;
+  input.tau = NanoSeconds (tau);
+  input.beaconInterval = NanoSeconds (beaconInterval);
+  return is;
+}
+
+TypeId
+AuthAdmissionController::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AuthAdmissionController")
+    .SetParent<Object> ()
+    .SetGroupName ("Wifi")
+  ;
+  return tid;
+}
+
+void
+AuthAdmissionController::PrintState (std::ostream &os) const
+{
+}
+
+TypeId
+StepAuthAdmissionController::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::StepAuthAdmissionController")
+    .SetParent<AuthAdmissionController> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<StepAuthAdmissionController> ()
+    .AddAttribute ("Step",
+                   "Threshold change per beacon.",
+                   UintegerValue (60),
+                   MakeUintegerAccessor (&StepAuthAdmissionController::m_step),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("QueueLimit",
+                   "Management queue size from which the threshold is lowered.",
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&StepAuthAdmissionController::m_queueLimit),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+void
+StepAuthAdmissionController::Update (AuthAdmissionInput &in)
+{
+  if (in.queueSize < m_queueLimit)
+    {
+      in.threshold += m_step;
+    }
+  else if (in.threshold > m_step)
+    {
+      in.threshold -= m_step;
+    }
+}
+
+TypeId
+OpenAuthAdmissionController::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::OpenAuthAdmissionController")
+    .SetParent<AuthAdmissionController> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<OpenAuthAdmissionController> ()
+  ;
+  return tid;
+}
+
+void
+OpenAuthAdmissionController::Update (AuthAdmissionInput &in)
+{
+  in.threshold = 1023;
+}
+
+TypeId
+CacAuthAdmissionController::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CacAuthAdmissionController")
+    .SetParent<AuthAdmissionController> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<CacAuthAdmissionController> ()
+    .AddAttribute ("LearningThreshold",
+                   "Management queue size above which the learning phase starts.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&CacAuthAdmissionController::m_learningThreshold),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("NewGroupThreshold",
+                   "Management queue size above which the working phase learns again.",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&CacAuthAdmissionController::m_newGroupThreshold),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+CacAuthAdmissionController::CacAuthAdmissionController ()
+  : m_state (WAIT),
+    m_delta (1),
+    m_improve (false),
+    m_waitCounter (5),
+    m_improveCounter (5)
+{
+}
+
+void
+CacAuthAdmissionController::Update (AuthAdmissionInput &in)
+{
+  if (m_state == WAIT)
+    {
+      DoWait (in);
+    }
+  else if (m_state == LEARN)
+    {
+      DoLearn (in);
+    }
+  else
+    {
+      DoWork (in);
+    }
+}
+
+void
+CacAuthAdmissionController::PrintState (std::ostream &os) const
+{
+  os << m_delta << "\t" << m_state << "\t" << m_improve << "\t"
+     << m_waitCounter << "\t" << m_improveCounter;
+}
+
+void
+CacAuthAdmissionController::DoWait (AuthAdmissionInput &in)
+{
+  if (in.queueSize > m_learningThreshold)
+    {
+      in.threshold = 0;
+      m_delta = 1;
+      m_improve = false;
+      m_state = LEARN;
+    }
+  else
+    {
+      in.threshold = 1023;
+    }
+}
+
+void
+CacAuthAdmissionController::DoLearn (AuthAdmissionInput &in)
+{
+  if (in.queueSize == 0)
+    {
+      if (in.threshold == 1023)
+        {
+          ClearHistory ();
+          m_state = WAIT;
+        }
+      else if (!Raise (in, m_delta))
+        {
+          m_delta *= 2;
+          m_improve = true;
+        }
+    }
+  else if (m_improve)
+    {
+      m_delta = std::max<int> (m_delta / 4, 1);
+      in.threshold -= m_delta;
+      m_state = WORK;
+      m_waitCounter = 5;
+      m_improveCounter = 5;
+    }
+}
+
+void
+CacAuthAdmissionController::DoWork (AuthAdmissionInput &in)
+{
+  if (in.threshold == 1023)
+    {
+      WaitAtMaximum ();
+    }
+  else if (in.queueSize == 0)
+    {
+      WorkEmptyQueue (in, false);
+    }
+  else if (in.queueSize > m_newGroupThreshold)
+    {
+      StartNewGroup (in);
+    }
+  else
+    {
+      m_improveCounter = 5;
+      if (in.queueLast == 0 && m_improve)
+        {
+          m_delta = std::max<int> (m_delta - 1, 1);
+          m_improve = false;
+        }
+    }
+}
+
+bool
+CacAuthAdmissionController::Raise (AuthAdmissionInput &in, int delta)
+{
+  if (m_history.empty () || m_history.top ().threshold > in.threshold + delta)
+    {
+      in.threshold += delta;
+      return false;
+    }
+  Triplet top = m_history.top ();
+  m_history.pop ();
+  in.threshold = top.threshold;
+  m_delta = std::max<int> (m_delta * top.delta / (m_delta + top.delta), 1);
+  m_improve = true;
+  return true;
+}
+
+void
+CacAuthAdmissionController::StartNewGroup (AuthAdmissionInput &in)
+{
+  m_history.push (Triplet (in.threshold, m_delta));
+  in.threshold = 0;
+  m_delta = 1;
+  m_improve = false;
+  m_state = LEARN;
+}
+
+void
+CacAuthAdmissionController::ClearHistory (void)
+{
+  while (!m_history.empty ())
+    {
+      m_history.pop ();
+    }
+}
+
+void
+CacAuthAdmissionController::WaitAtMaximum (void)
+{
+  if (m_waitCounter > 0)
+    {
+      m_waitCounter--;
+    }
+  else
+    {
+      ClearHistory ();
+      m_state = WAIT;
+    }
+}
+
+void
+CacAuthAdmissionController::WorkEmptyQueue (AuthAdmissionInput &in, bool alwaysIncrease)
+{
+  if (m_improveCounter > 0)
+    {
+      m_improveCounter--;
+    }
+  else
+    {
+      m_improve = true;
+    }
+  if (alwaysIncrease || m_improve)
+    {
+      m_delta++;
+    }
+  Raise (in, m_delta);
+  if (in.threshold >= 1023)
+    {
+      in.threshold = 1023;
+      m_improve = false;
+    }
+}
+
+TypeId
+Cac2AuthAdmissionController::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::Cac2AuthAdmissionController")
+    .SetParent<CacAuthAdmissionController> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<Cac2AuthAdmissionController> ()
+  ;
+  return tid;
+}
+
+void
+Cac2AuthAdmissionController::DoWork (AuthAdmissionInput &in)
+{
+  if (in.threshold == 1023)
+    {
+      WaitAtMaximum ();
+    }
+  else if (in.queueSize == 0)
+    {
+      WorkEmptyQueue (in, true);
+    }
+  else if (in.queueSize > m_newGroupThreshold)
+    {
+      StartNewGroup (in);
+    }
+  else
+    {
+      m_improveCounter = 5;
+      m_delta = std::max<int> (m_delta - 1, 1);
+      if (in.queueLast == 0)
+        {
+          m_improve = false;
+        }
+    }
+}
+
+TypeId
+BisectionAuthAdmissionController::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BisectionAuthAdmissionController")
+    .SetParent<CacAuthAdmissionController> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<BisectionAuthAdmissionController> ()
+  ;
+  return tid;
+}
+
+void
+BisectionAuthAdmissionController::DoWait (AuthAdmissionInput &in)
+{
+  if (in.queueSize > m_learningThreshold)
+    {
+      in.threshold = 0;
+      m_delta = 1023;
+      m_improve = false;
+      m_waitCounter = 5;
+      m_state = LEARN;
+    }
+  else
+    {
+      in.threshold = 1023;
+    }
+}
+
+void
+BisectionAuthAdmissionController::DoLearn (AuthAdmissionInput &in)
+{
+  if (in.threshold != 0)
+    {
+      if (in.queueSize != 0)
+        {
+          in.threshold = 0;
+        }
+      else
+        {
+          m_delta /= 2;
+          m_improve = true;
+          m_state = WORK;
+        }
+    }
+  else if (in.queueSize == 0)
+    {
+      m_delta /= 2;
+      in.threshold = m_delta;
+    }
+}
+
+void
+BisectionAuthAdmissionController::DoWork (AuthAdmissionInput &in)
+{
+  if (in.threshold == 1023)
+    {
+      m_waitCounter--;
+      if (m_waitCounter <= 0)
+        {
+          m_state = WAIT;
+        }
+    }
+  else if (in.queueSize == 0)
+    {
+      if (m_improve)
+        {
+          m_delta++;
+        }
+      in.threshold += m_delta;
+      if (in.threshold >= 1023)
+        {
+          in.threshold = 1023;
+          m_improve = false;
+        }
+    }
+  else if (in.queueLast == 0 && m_improve)
+    {
+      m_delta = std::max<int> (m_delta - 1, 1);
+      m_improve = false;
+    }
+}
+
+TypeId
+RatioAuthAdmissionController::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::RatioAuthAdmissionController")
+    .SetParent<CacAuthAdmissionController> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<RatioAuthAdmissionController> ()
+    .AddAttribute ("AuthReqCost",
+                   "Cost of an AuthReq (default: airtime in us with SIFS and Ack).",
+                   DoubleValue (720 + 160 + 1000),
+                   MakeDoubleAccessor (&RatioAuthAdmissionController::m_authReqCost),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("AuthRepCost",
+                   "Cost of an AuthRep (default: airtime in us with SIFS and Ack).",
+                   DoubleValue (720 + 160 + 1000),
+                   MakeDoubleAccessor (&RatioAuthAdmissionController::m_authRepCost),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("AssocReqCost",
+                   "Cost of an AssocReq (default: airtime in us with SIFS and Ack).",
+                   DoubleValue (1520 + 160 + 1000),
+                   MakeDoubleAccessor (&RatioAuthAdmissionController::m_assocReqCost),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("AssocRepCost",
+                   "Cost of an AssocRep (default: airtime in us with SIFS and Ack).",
+                   DoubleValue (1160 + 160 + 1000),
+                   MakeDoubleAccessor (&RatioAuthAdmissionController::m_assocRepCost),
+                   MakeDoubleChecker<double> ())
+  ;
+  return tid;
+}
+
+double
+RatioAuthAdmissionController::GetSuccessRatio (const AuthAdmissionInput &in) const
+{
+  return ns3::GetSuccessRatio (in, m_authReqCost, m_authRepCost, m_assocReqCost, m_assocRepCost);
+}
+
+void
+RatioAuthAdmissionController::DoWork (AuthAdmissionInput &in)
+{
+  if (in.threshold == 1023)
+    {
+      WaitAtMaximum ();
+    }
+  else if (in.queueSize == 0)
+    {
+      WorkEmptyQueue (in, false);
+    }
+  else if (in.queueSize > m_newGroupThreshold)
+    {
+      StartNewGroup (in);
+    }
+  else
+    {
+      m_improveCounter = 5;
+      if (in.queueLast == 0 && m_improve)
+        {
+          m_delta = std::max<int> (m_delta - 1, 1);
+          m_improve = false;
+        }
+      double ratio = GetSuccessRatio (in);
+      NS_LOG_DEBUG ("Ratio " << ratio);
+      if (ratio > 0)
+        {
+          int delta = std::max<int> (1, std::floor (m_delta * ratio));
+          NS_LOG_DEBUG ("Temp Delta " << delta);
+          Raise (in, delta);
+        }
+    }
+}
+
+TypeId
+TauAuthAdmissionController::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TauAuthAdmissionController")
+    .SetParent<RatioAuthAdmissionController> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<TauAuthAdmissionController> ()
+  ;
+  return tid;
+}
+
+void
+TauAuthAdmissionController::DoWork (AuthAdmissionInput &in)
+{
+  if (in.threshold == 1023)
+    {
+      WaitAtMaximum ();
+    }
+  else if (in.queueSize == 0)
+    {
+      if (m_improve && in.tau.GetMilliSeconds () > 0)
+        {
+          double increase = in.beaconInterval.GetMilliSeconds () / in.tau.GetMilliSeconds ();
+          NS_LOG_DEBUG ("tau " << in.tau.GetMilliSeconds () << " ms, increasing Delta " << increase << " times");
+          // tau beyond the beacon interval gives 0, which would stall the step at 0
+          m_delta = std::max<int> (1, m_delta * increase);
+        }
+      Raise (in, m_delta);
+      m_improve = true;
+      if (in.threshold >= 1023)
+        {
+          in.threshold = 1023;
+          m_improve = false;
+        }
+    }
+  else if (in.queueSize > m_newGroupThreshold)
+    {
+      StartNewGroup (in);
+    }
+  else
+    {
+      double ratio = GetSuccessRatio (in);
+      NS_LOG_DEBUG ("Ratio " << ratio);
+      if (ratio > 0)
+        {
+          m_delta = std::max<int> (1, std::floor (m_delta * ratio));
+          in.threshold += m_delta;
+        }
+    }
+}
+
+TypeId
+BandAuthAdmissionController::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BandAuthAdmissionController")
+    .SetParent<CacAuthAdmissionController> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<BandAuthAdmissionController> ()
+  ;
+  return tid;
+}
+
+void
+BandAuthAdmissionController::DoWork (AuthAdmissionInput &in)
+{
+  if (in.threshold == 1023)
+    {
+      WaitAtMaximum ();
+    }
+  else if (in.queueSize == 0)
+    {
+      if (m_improve)
+        {
+          m_delta++;
+        }
+      Raise (in, m_delta);
+      m_improve = true;
+      if (in.threshold >= 1023)
+        {
+          in.threshold = 1023;
+          m_improve = false;
+        }
+    }
+  else if (in.queueSize <= 5)
+    {
+      in.threshold += m_delta;
+      m_improve = false;
+    }
+  else if (in.queueSize <= 10)
+    {
+      m_improve = false;
+    }
+  else if (in.queueSize <= 100)
+    {
+      // 11..20 frames shrink the step by 1, ..., 91..100 frames by 9
+      m_delta = std::max<int> (m_delta - static_cast<int> ((in.queueSize - 1) / 10), 1);
+      m_improve = false;
+    }
+  else
+    {
+      StartNewGroup (in);
+    }
+}
+
+TypeId
+OracleAuthAdmissionController::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::OracleAuthAdmissionController")
+    .SetParent<AuthAdmissionController> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<OracleAuthAdmissionController> ()
+    .AddAttribute ("Value",
+                   "Stations to admit per beacon.",
+                   UintegerValue (60),
+                   MakeUintegerAccessor (&OracleAuthAdmissionController::m_value),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("NAssociating",
+                   "Number of associating stations.",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&OracleAuthAdmissionController::m_nAssociating),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+void
+OracleAuthAdmissionController::Update (AuthAdmissionInput &in)
+{
+  if (!in.saturatedAssociated)
+    {
+      in.threshold = 1023;
+    }
+  else if (in.associatingStasAppear)
+    {
+      in.threshold = 1023 * m_value / m_nAssociating;
+      in.associatingStasAppear = false;
+    }
+  else if (in.queueSize == 0)
+    {
+      in.threshold += 1023 * m_value / m_nAssociating;
+    }
+}
+
+TypeId
+WeightedOracleAuthAdmissionController::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::WeightedOracleAuthAdmissionController")
+    .SetParent<OracleAuthAdmissionController> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<WeightedOracleAuthAdmissionController> ()
+  ;
+  return tid;
+}
+
+WeightedOracleAuthAdmissionController::WeightedOracleAuthAdmissionController ()
+  : m_delta (1),
+    m_firstThreshold (1023),
+    m_firstWave (0)
+{
+}
+
+void
+WeightedOracleAuthAdmissionController::PrintState (std::ostream &os) const
+{
+  os << m_delta;
+}
+
+void
+WeightedOracleAuthAdmissionController::Update (AuthAdmissionInput &in)
+{
+  if (!in.saturatedAssociated)
+    {
+      in.threshold = 1023;
+    }
+  else if (in.associatingStasAppear)
+    {
+      m_delta = 1023 * m_value / m_nAssociating;
+      in.threshold = m_delta;
+      in.associatingStasAppear = false;
+      m_firstWave = m_nAssociating;
+    }
+  else if (in.secondWaveAppear)
+    {
+      // only the second group is taken into account
+      m_firstThreshold = in.threshold;
+      in.threshold = 0;
+      // NAssociating counts both groups; if it was not raised, take it as the size of the second one
+      uint32_t secondWave = m_nAssociating > m_firstWave ? m_nAssociating - m_firstWave : m_nAssociating;
+      m_delta = 1023 * m_value / secondWave;
+      in.secondWaveAppear = false;
+    }
+  else if (in.queueSize == 0)
+    {
+      if (in.threshold + m_delta > m_firstThreshold)
+        {
+          // the threshold of the first group is reached, both groups are taken into account
+          m_delta = 1023 * m_value / m_nAssociating;
+        }
+      in.threshold += m_delta;
+    }
+  else
+    {
+      m_delta = 1023 * m_value / m_nAssociating;
+      // frames weighted by their size in bytes
+      double ratio = ns3::GetSuccessRatio (in, 58, 56, 118, 89);
+      NS_LOG_DEBUG ("Ratio " << ratio);
+      if (ratio > 0)
+        {
+          int delta = std::max<int> (1, std::floor (m_delta * ratio));
+          NS_LOG_DEBUG ("Temp Delta " << delta);
+          in.threshold += delta;
+        }
+    }
+}
+
+} // namespace ns3
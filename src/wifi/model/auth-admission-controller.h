@@ -0,0 +1,340 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef AUTH_ADMISSION_CONTROLLER_H
+#define AUTH_ADMISSION_CONTROLLER_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include <ostream>
+#include <stack>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief What an AP observed for one S1G beacon, as seen by an AuthAdmissionController.
+ *
+ * The counters of received requests and acknowledged responses cover the
+ * beacon interval before the last one, the queue counters are sampled
+ * when the beacon is built.
+ */
+struct AuthAdmissionInput
+{
+  AuthAdmissionInput ();
+
+  uint32_t queueSize;          //!< frames in the management queue
+  uint32_t queueLast;          //!< frames in the management queue at the previous beacon
+  int authRepQueued;           //!< AuthReps in the management queue (q1)
+  int assocRepQueued;          //!< AssocReps in the management queue (q2)
+  int authReqReceived;         //!< AuthReqs received (r1)
+  int assocReqReceived;        //!< AssocReqs received (r2)
+  int authRepAcked;            //!< AuthReps acknowledged (a1)
+  int assocRepAcked;           //!< AssocReps acknowledged (a2)
+  Time tau;                    //!< time from the last beacon to the last successful association
+  Time beaconInterval;         //!< beacon interval of the AP
+  bool saturatedAssociated;    //!< all saturated stations are associated
+  bool associatingStasAppear;  //!< associating stations were created, cleared by a controller acting on it
+  bool secondWaveAppear;       //!< a second group of stations was created, cleared by a controller acting on it
+  uint16_t threshold;          //!< authentication threshold, updated by the controller
+};
+
+std::ostream & operator << (std::ostream &os, const AuthAdmissionInput &input);
+std::istream & operator >> (std::istream &is, AuthAdmissionInput &input);
+
+/**
+ * \ingroup wifi
+ * \brief Centralized authentication control of an S1G AP.
+ *
+ * Called by ApWifiMac once per S1G beacon to update the authentication
+ * threshold (0..1023, the AP clamps the result) announced in the
+ * beacon.  A controller only sees an AuthAdmissionInput, so recorded
+ * inputs can be replayed through it without the PHY and MAC layers.
+ */
+class AuthAdmissionController : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  /**
+   * TracedCallback signature for the input of a controller.
+   *
+   * \param input the beacon observation
+   */
+  typedef void (* InputTracedCallback)(const AuthAdmissionInput &input);
+
+  /**
+   * Update input.threshold for the next beacon.
+   *
+   * \param input the beacon observation, threshold and event flags are updated
+   */
+  virtual void Update (AuthAdmissionInput &input) = 0;
+  /**
+   * Print the controller state for the per-beacon log of ApWifiMac.
+   *
+   * \param os the output stream
+   */
+  virtual void PrintState (std::ostream &os) const;
+};
+
+/**
+ * \ingroup wifi
+ * \brief Raise the threshold by Step while the queue is short, lower it otherwise (Algorithm 0).
+ */
+class StepAuthAdmissionController : public AuthAdmissionController
+{
+public:
+  static TypeId GetTypeId (void);
+
+  virtual void Update (AuthAdmissionInput &input);
+
+private:
+  uint32_t m_step;        //!< threshold change per beacon
+  uint32_t m_queueLimit;  //!< queue size from which the threshold is lowered
+};
+
+/**
+ * \ingroup wifi
+ * \brief Admit all stations (Algorithm 4).
+ */
+class OpenAuthAdmissionController : public AuthAdmissionController
+{
+public:
+  static TypeId GetTypeId (void);
+
+  virtual void Update (AuthAdmissionInput &input);
+};
+
+/**
+ * \ingroup wifi
+ * \brief Learning centralized authentication control (Algorithm 1).
+ *
+ * Waits with all stations admitted until the queue fills, learns a
+ * threshold by doubling its step from 0 while the queue empties each
+ * beacon, then works around it, remembering the thresholds of earlier
+ * groups of stations.  Subclasses replace the working phase.
+ */
+class CacAuthAdmissionController : public AuthAdmissionController
+{
+public:
+  static TypeId GetTypeId (void);
+  CacAuthAdmissionController ();
+
+  virtual void Update (AuthAdmissionInput &input);
+  virtual void PrintState (std::ostream &os) const;
+
+protected:
+  /// Phases of the controller
+  enum State
+  {
+    WAIT,
+    LEARN,
+    WORK
+  };
+
+  /// Threshold and step to return to once a new group has been served
+  struct Triplet
+  {
+    int delta;      //!< step
+    int threshold;  //!< threshold
+    /**
+     * \param t threshold
+     * \param d step
+     */
+    Triplet (int t = 0, int d = 0) : delta (d), threshold (t) {}
+  };
+
+  /**
+   * Waiting phase.
+   *
+   * \param input the beacon observation
+   */
+  virtual void DoWait (AuthAdmissionInput &input);
+  /**
+   * Learning phase.
+   *
+   * \param input the beacon observation
+   */
+  virtual void DoLearn (AuthAdmissionInput &input);
+  /**
+   * Working phase.
+   *
+   * \param input the beacon observation
+   */
+  virtual void DoWork (AuthAdmissionInput &input);
+
+  /**
+   * Raise the threshold by delta, or go back to the remembered threshold
+   * of the previous group if that would pass it.
+   *
+   * \param input the beacon observation
+   * \param delta the step
+   * \return true if the remembered threshold was restored
+   */
+  bool Raise (AuthAdmissionInput &input, int delta);
+  /**
+   * Remember the threshold and start learning for a new group of stations.
+   *
+   * \param input the beacon observation
+   */
+  void StartNewGroup (AuthAdmissionInput &input);
+  /// Forget all remembered thresholds
+  void ClearHistory (void);
+  /**
+   * The threshold reached 1023 during the working phase: wait a few
+   * beacons, then go back to the waiting phase.
+   */
+  void WaitAtMaximum (void);
+  /**
+   * Working phase with an empty queue, common to most variants.
+   *
+   * \param input the beacon observation
+   * \param alwaysIncrease raise the step even when not improving
+   */
+  void WorkEmptyQueue (AuthAdmissionInput &input, bool alwaysIncrease);
+
+  State m_state;               //!< current phase
+  int m_delta;                 //!< threshold step
+  bool m_improve;              //!< the step may grow
+  int m_waitCounter;           //!< beacons at 1023 before waiting again
+  int m_improveCounter;        //!< beacons with an empty queue before the step may grow
+  std::stack<Triplet> m_history; //!< thresholds of earlier groups
+  uint32_t m_learningThreshold;  //!< queue size starting the learning phase
+  uint32_t m_newGroupThreshold;  //!< queue size restarting the learning phase
+};
+
+/**
+ * \ingroup wifi
+ * \brief CacAuthAdmissionController always growing the step on an empty queue (Algorithm 2).
+ */
+class Cac2AuthAdmissionController : public CacAuthAdmissionController
+{
+public:
+  static TypeId GetTypeId (void);
+
+protected:
+  virtual void DoWork (AuthAdmissionInput &input);
+};
+
+/**
+ * \ingroup wifi
+ * \brief CacAuthAdmissionController learning by bisection (Algorithm 3).
+ */
+class BisectionAuthAdmissionController : public CacAuthAdmissionController
+{
+public:
+  static TypeId GetTypeId (void);
+
+protected:
+  virtual void DoWait (AuthAdmissionInput &input);
+  virtual void DoLearn (AuthAdmissionInput &input);
+  virtual void DoWork (AuthAdmissionInput &input);
+};
+
+/**
+ * \ingroup wifi
+ * \brief CacAuthAdmissionController scaling the step by the share of the
+ * channel spent on frames that completed an exchange (Algorithms 7 and 10).
+ *
+ * The costs weigh the frames of an authentication and association
+ * exchange; Algorithm 7 uses their sizes in bytes, Algorithm 10 (the
+ * default) their airtime including SIFS and Ack.
+ */
+class RatioAuthAdmissionController : public CacAuthAdmissionController
+{
+public:
+  static TypeId GetTypeId (void);
+
+protected:
+  virtual void DoWork (AuthAdmissionInput &input);
+  /**
+   * \param input the beacon observation
+   * \return the share of the channel used by frames of completed exchanges
+   */
+  double GetSuccessRatio (const AuthAdmissionInput &input) const;
+
+  double m_authReqCost;   //!< cost of an AuthReq
+  double m_authRepCost;   //!< cost of an AuthRep
+  double m_assocReqCost;  //!< cost of an AssocReq
+  double m_assocRepCost;  //!< cost of an AssocRep
+};
+
+/**
+ * \ingroup wifi
+ * \brief RatioAuthAdmissionController growing the step by how early in
+ * the beacon interval the queue emptied (Algorithm 8).
+ */
+class TauAuthAdmissionController : public RatioAuthAdmissionController
+{
+public:
+  static TypeId GetTypeId (void);
+
+protected:
+  virtual void DoWork (AuthAdmissionInput &input);
+};
+
+/**
+ * \ingroup wifi
+ * \brief CacAuthAdmissionController shrinking the step by queue size bands (Algorithm 9).
+ */
+class BandAuthAdmissionController : public CacAuthAdmissionController
+{
+public:
+  static TypeId GetTypeId (void);
+
+protected:
+  virtual void DoWork (AuthAdmissionInput &input);
+};
+
+/**
+ * \ingroup wifi
+ * \brief Oracle knowing the number of associating stations (Algorithm 5).
+ */
+class OracleAuthAdmissionController : public AuthAdmissionController
+{
+public:
+  static TypeId GetTypeId (void);
+
+  virtual void Update (AuthAdmissionInput &input);
+
+protected:
+  uint32_t m_value;        //!< stations to admit per beacon
+  uint32_t m_nAssociating; //!< number of associating stations
+};
+
+/**
+ * \ingroup wifi
+ * \brief Oracle also weighing the step by the share of completed
+ * exchanges, with a second group of stations (Algorithm 6).
+ */
+class WeightedOracleAuthAdmissionController : public OracleAuthAdmissionController
+{
+public:
+  static TypeId GetTypeId (void);
+  WeightedOracleAuthAdmissionController ();
+
+  virtual void Update (AuthAdmissionInput &input);
+  virtual void PrintState (std::ostream &os) const;
+
+private:
+  int m_delta;          //!< threshold step
+  int m_firstThreshold; //!< threshold reached with the first group
+  uint32_t m_firstWave; //!< number of stations of the first group
+};
+
+} // namespace ns3
+
+#endif /* AUTH_ADMISSION_CONTROLLER_H */
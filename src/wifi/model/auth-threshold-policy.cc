@@ -0,0 +1,249 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "auth-threshold-policy.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/string.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AuthThresholdPolicy");
+
+NS_OBJECT_ENSURE_REGISTERED (AuthThresholdPolicy);
+NS_OBJECT_ENSURE_REGISTERED (MlpAuthThresholdPolicy);
+
+static const uint32_t MLP_MAGIC = 0x31504c4d;
+static const uint32_t MLP_MAX_LAYER_SIZE = 1 << 16;
+
+TypeId
+AuthThresholdPolicy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AuthThresholdPolicy")
+    .SetParent<Object> ()
+    .SetGroupName ("Wifi")
+  ;
+  return tid;
+}
+
+TypeId
+MlpAuthThresholdPolicy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MlpAuthThresholdPolicy")
+    .SetParent<AuthThresholdPolicy> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<MlpAuthThresholdPolicy> ()
+    .AddAttribute ("WeightsFile",
+                   "Binary file with the exported network (see MlpAuthThresholdPolicy).",
+                   StringValue (""),
+                   MakeStringAccessor (&MlpAuthThresholdPolicy::SetWeightsFile,
+                                       &MlpAuthThresholdPolicy::GetWeightsFile),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+MlpAuthThresholdPolicy::MlpAuthThresholdPolicy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MlpAuthThresholdPolicy::~MlpAuthThresholdPolicy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MlpAuthThresholdPolicy::SetWeightsFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  if (filename.empty ())
+    {
+      m_weightsFile = filename;
+      m_layers.clear ();
+      return;
+    }
+  if (!Load (filename))
+    {
+      NS_FATAL_ERROR ("Cannot load policy weights from " << filename);
+    }
+}
+
+std::string
+MlpAuthThresholdPolicy::GetWeightsFile (void) const
+{
+  return m_weightsFile;
+}
+
+bool
+MlpAuthThresholdPolicy::Load (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ifstream in (filename.c_str (), std::ios::binary);
+  if (!in)
+    {
+      NS_LOG_WARN ("Cannot open " << filename);
+      return false;
+    }
+
+  uint32_t magic = 0;
+  uint32_t nLayers = 0;
+  in.read (reinterpret_cast<char *> (&magic), sizeof (magic));
+  in.read (reinterpret_cast<char *> (&nLayers), sizeof (nLayers));
+  if (!in || magic != MLP_MAGIC || nLayers == 0)
+    {
+      NS_LOG_WARN (filename << " is not a policy weights file");
+      return false;
+    }
+
+  std::vector<Layer> layers (nLayers);
+  uint32_t maxSize = 0;
+  for (uint32_t i = 0; i < nLayers; i++)
+    {
+      Layer &layer = layers[i];
+      uint32_t activation = 0;
+      in.read (reinterpret_cast<char *> (&layer.nIn), sizeof (layer.nIn));
+      in.read (reinterpret_cast<char *> (&layer.nOut), sizeof (layer.nOut));
+      in.read (reinterpret_cast<char *> (&activation), sizeof (activation));
+      if (!in || layer.nIn == 0 || layer.nOut == 0
+          || layer.nIn > MLP_MAX_LAYER_SIZE || layer.nOut > MLP_MAX_LAYER_SIZE
+          || activation > TANH
+          || (i > 0 && layer.nIn != layers[i - 1].nOut))
+        {
+          NS_LOG_WARN (filename << ": bad header of layer " << i);
+          return false;
+        }
+      layer.activation = static_cast<Activation> (activation);
+      layer.weights.resize (layer.nIn * layer.nOut);
+      layer.bias.resize (layer.nOut);
+      in.read (reinterpret_cast<char *> (&layer.weights[0]), layer.weights.size () * sizeof (float));
+      in.read (reinterpret_cast<char *> (&layer.bias[0]), layer.bias.size () * sizeof (float));
+      if (!in)
+        {
+          NS_LOG_WARN (filename << ": truncated layer " << i);
+          return false;
+        }
+      maxSize = std::max (maxSize, layer.nOut);
+    }
+
+  m_layers.swap (layers);
+  m_buffer[0].assign (maxSize, 0);
+  m_buffer[1].assign (maxSize, 0);
+  m_output.assign (m_layers.back ().nOut, 0);
+  m_weightsFile = filename;
+  NS_LOG_DEBUG ("Loaded " << nLayers << " layers from " << filename);
+  return true;
+}
+
+uint32_t
+MlpAuthThresholdPolicy::GetInputSize (void) const
+{
+  return m_layers.empty () ? 0 : m_layers.front ().nIn;
+}
+
+uint32_t
+MlpAuthThresholdPolicy::GetOutputSize (void) const
+{
+  return m_layers.empty () ? 0 : m_layers.back ().nOut;
+}
+
+void
+MlpAuthThresholdPolicy::Evaluate (const float *input, float *output)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!m_layers.empty ());
+  const float *x = input;
+  for (uint32_t l = 0; l < m_layers.size (); l++)
+    {
+      const Layer &layer = m_layers[l];
+      float *y = (l + 1 == m_layers.size ()) ? output : &m_buffer[l % 2][0];
+      const float *w = &layer.weights[0];
+      for (uint32_t j = 0; j < layer.nOut; j++, w += layer.nIn)
+        {
+          // four independent sums, so the compiler can keep them in one vector register
+          float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+          uint32_t k = 0;
+          for (; k + 4 <= layer.nIn; k += 4)
+            {
+              s0 += w[k] * x[k];
+              s1 += w[k + 1] * x[k + 1];
+              s2 += w[k + 2] * x[k + 2];
+              s3 += w[k + 3] * x[k + 3];
+            }
+          for (; k < layer.nIn; k++)
+            {
+              s0 += w[k] * x[k];
+            }
+          float v = layer.bias[j] + (s0 + s1) + (s2 + s3);
+          if (layer.activation == RELU)
+            {
+              v = v > 0 ? v : 0;
+            }
+          else if (layer.activation == TANH)
+            {
+              v = std::tanh (v);
+            }
+          y[j] = v;
+        }
+      x = y;
+    }
+}
+
+uint16_t
+MlpAuthThresholdPolicy::GetThreshold (const float *features)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (GetInputSize () != N_FEATURES,
+                   "Policy " << m_weightsFile << " takes " << GetInputSize ()
+                             << " inputs instead of " << N_FEATURES);
+  uint32_t nOut = GetOutputSize ();
+  float *y = &m_output[0];
+  Evaluate (features, y);
+
+  double threshold;
+  if (nOut == 1)
+    {
+      threshold = std::floor (y[0] + 0.5);
+    }
+  else
+    {
+      uint32_t best = 0;
+      for (uint32_t j = 1; j < nOut; j++)
+        {
+          if (y[j] > y[best])
+            {
+              best = j;
+            }
+        }
+      threshold = std::floor (best * 1023.0 / (nOut - 1) + 0.5);
+    }
+  if (!(threshold > 0))
+    {
+      threshold = 0;
+    }
+  else if (threshold > 1023)
+    {
+      threshold = 1023;
+    }
+  NS_LOG_DEBUG ("features " << features[0] << " " << features[1] << " " << features[2]
+                            << " " << features[3] << " -> threshold " << threshold);
+  return static_cast<uint16_t> (threshold);
+}
+
+} // namespace ns3
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef AUTH_THRESHOLD_POLICY_H
+#define AUTH_THRESHOLD_POLICY_H
+
+#include "ns3/object.h"
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief Policy deciding the centralized authentication threshold of an AP.
+ *
+ * Evaluated by ApWifiMac in every S1G beacon of algorithms 100 and 101,
+ * at the point where the beaconS1G trace hands control to an external
+ * agent.  The features are, in this order:
+ *  -# AuthReps waiting in the management queue (WifiMacQueue::GetAuthRepNumber)
+ *  -# AssocReps waiting in the management queue (WifiMacQueue::GetAssocRepNumber)
+ *  -# AuthReps acknowledged since the last beacon (MacLow::GetAuthRespAck)
+ *  -# current authentication threshold
+ */
+class AuthThresholdPolicy : public Object
+{
+public:
+  /// number of features passed to GetThreshold
+  static const uint32_t N_FEATURES = 4;
+
+  static TypeId GetTypeId (void);
+
+  /**
+   * \param features the N_FEATURES features described above
+   * \return the new authentication threshold, 0..1023
+   */
+  virtual uint16_t GetThreshold (const float *features) = 0;
+};
+
+/**
+ * \ingroup wifi
+ * \brief AuthThresholdPolicy evaluating an exported multilayer perceptron.
+ *
+ * The weights file is a plain little-endian binary file:
+ * \verbatim
+   uint32 magic ("MLP1" = 0x31504c4d), uint32 number of layers
+   per layer: uint32 inputs, uint32 outputs, uint32 activation (0 none, 1 relu, 2 tanh)
+              float32 weights[outputs][inputs], float32 bias[outputs]
+   \endverbatim
+ * The first layer takes N_FEATURES inputs (fold any input scaling into
+ * it).  A single output is taken as the threshold itself; with several
+ * outputs (e.g. Q-values) the index of the largest one is mapped
+ * linearly onto 0..1023.
+ */
+class MlpAuthThresholdPolicy : public AuthThresholdPolicy
+{
+public:
+  static TypeId GetTypeId (void);
+  MlpAuthThresholdPolicy ();
+  virtual ~MlpAuthThresholdPolicy ();
+
+  /**
+   * \param filename the weights file
+   * \return true if the file was read and its layers fit together
+   */
+  bool Load (std::string filename);
+  std::string GetWeightsFile (void) const;
+
+  /**
+   * Run the network.
+   *
+   * \param input GetInputSize () values
+   * \param output receives GetOutputSize () values
+   */
+  void Evaluate (const float *input, float *output);
+  uint32_t GetInputSize (void) const;
+  uint32_t GetOutputSize (void) const;
+
+  virtual uint16_t GetThreshold (const float *features);
+
+private:
+  /// Activation functions of a layer, the numbers used in the weights file
+  enum Activation
+  {
+    NONE = 0,
+    RELU = 1,
+    TANH = 2
+  };
+
+  /// One fully connected layer
+  struct Layer
+  {
+    uint32_t nIn;               //!< inputs
+    uint32_t nOut;              //!< outputs
+    Activation activation;      //!< activation applied to the outputs
+    std::vector<float> weights; //!< nOut rows of nIn weights
+    std::vector<float> bias;    //!< nOut biases
+  };
+
+  void SetWeightsFile (std::string filename);
+
+  std::string m_weightsFile;
+  std::vector<Layer> m_layers;
+  std::vector<float> m_buffer[2]; //!< layer outputs, reused between calls
+  std::vector<float> m_output;    //!< network output of GetThreshold
+};
+
+} // namespace ns3
+
+#endif /* AUTH_THRESHOLD_POLICY_H */
@@ -497,19 +497,23 @@ private:
    * started for the given DcfState.
    *
    * \param state
+   * \param accessGrantStart the time returned by GetAccessGrantStart,
+   *        computed once for all the states
    *
    * \return the time when the backoff procedure started
    */
-  Time GetBackoffStartFor (DcfState *state);
+  Time GetBackoffStartFor (DcfState *state, Time accessGrantStart) const;
   /**
    * Return the time when the backoff procedure
    * ended (or will ended) for the given DcfState.
    *
    * \param state
+   * \param accessGrantStart the time returned by GetAccessGrantStart,
+   *        computed once for all the states
    *
    * \return the time when the backoff procedure ended (or will ended)
    */
-  Time GetBackoffEndFor (DcfState *state);
+  Time GetBackoffEndFor (DcfState *state, Time accessGrantStart) const;
 
   void DoRestartAccessTimeoutIfNeeded (void);
 
@@ -57,4 +57,14 @@ ErrorRateModel::CalculateSnr (WifiMode txMode, double ber) const
   return low;
 }
 
+void
+ErrorRateModel::GetChunkSuccessRates (WifiMode mode, uint32_t n, const double *snr,
+                                      const uint32_t *nbits, double *csr) const
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      csr[i] = GetChunkSuccessRate (mode, snr[i], nbits[i]);
+    }
+}
+
 } //namespace ns3
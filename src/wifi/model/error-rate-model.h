@@ -60,6 +60,18 @@ public:
    * \return probability of successfully receiving the chunk
    */
   virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const = 0;
+  /**
+   * Compute the success rates of several chunks sent with the same mode.
+   * The default implementation calls GetChunkSuccessRate for each chunk.
+   *
+   * \param mode the Wi-Fi mode the chunks are sent
+   * \param n the number of chunks
+   * \param snr the SNR of each chunk
+   * \param nbits the number of bits in each chunk
+   * \param csr set to the probability of successfully receiving each chunk
+   */
+  virtual void GetChunkSuccessRates (WifiMode mode, uint32_t n, const double *snr,
+                                     const uint32_t *nbits, double *csr) const;
 };
 
 } //namespace ns3
@@ -128,10 +128,9 @@ InterferenceHelper::Event::GetPreambleType (void) const
  *       short period of time.
  ****************************************************************/
 
-InterferenceHelper::NiChange::NiChange (Time time, double delta, Ptr<InterferenceHelper::Event> event)
+InterferenceHelper::NiChange::NiChange (Time time, double delta)
   : m_time (time),
-    m_delta (delta),
-    m_event (event)
+    m_delta (delta)
 {
 }
 
@@ -153,11 +152,6 @@ InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o)
   return (m_time < o.m_time);
 }
 
- Ptr<InterferenceHelper::Event>
- InterferenceHelper::NiChange::GetEvent(void) const
- {
-   return m_event;
- }
 /****************************************************************
  *       The actual InterferenceHelper
  ****************************************************************/
@@ -165,6 +159,9 @@ InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o)
 InterferenceHelper::InterferenceHelper ()
   : m_errorRateModel (0),
     m_firstPower (0.0),
+    m_next (m_niChanges.end ()),
+    m_now (Seconds (0)),
+    m_nowPowerW (0.0),
     m_rxing (false),
     m_maxPacketDuration (0)
 {
@@ -195,6 +192,16 @@ InterferenceHelper::Add (uint32_t size, WifiTxVector txVector,
   return event;
 }
 
+void
+InterferenceHelper::AddInterference (Time duration, double rxPowerW)
+{
+  m_maxPacketDuration = std::max (m_maxPacketDuration, duration);
+  Update ();
+  Time now = Simulator::Now ();
+  AddNiChangeEvent (NiChange (now, rxPowerW));
+  AddNiChangeEvent (NiChange (now + duration, -rxPowerW));
+}
+
 
 void
 InterferenceHelper::SetNoiseFigure (double value)
@@ -223,18 +230,28 @@ InterferenceHelper::GetErrorRateModel (void) const
 Time
 InterferenceHelper::GetEnergyDuration (double energyW)
 {
-  Time now = Simulator::Now ();
-  double noiseInterferenceW = 0.0;
+  Update ();
+  Time now = m_now;
+  double noiseInterferenceW = m_nowPowerW;
+  // the changes at the current time are checked one by one, like the
+  // following ones
+  NiChanges::const_iterator i = m_next;
+  while (i != m_niChanges.begin ())
+    {
+      NiChanges::const_iterator previous = i;
+      previous--;
+      if (previous->GetTime () < now)
+        {
+          break;
+        }
+      i = previous;
+      noiseInterferenceW -= i->GetDelta ();
+    }
   Time end = now;
-  noiseInterferenceW = m_firstPower;
-  for (NiChanges::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
+  for (; i != m_niChanges.end (); i++)
     {
       noiseInterferenceW += i->GetDelta ();
       end = i->GetTime ();
-      if (end < now)
-        {
-          continue;
-        }
       if (noiseInterferenceW < energyW)
         {
           break;
@@ -245,28 +262,67 @@ InterferenceHelper::GetEnergyDuration (double energyW)
 
 void
 InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
+{
+  Update ();
+  AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW ()));
+  AddNiChangeEvent (NiChange (event->GetEndTime (), -event->GetRxPowerW ()));
+}
+
+void
+InterferenceHelper::Update (void)
 {
   Time now = Simulator::Now ();
-  //if (!m_rxing)
+  NS_ASSERT (now >= m_now);
+  m_now = now;
+  while (m_next != m_niChanges.end () && m_next->GetTime () <= now)
+    {
+      m_nowPowerW += m_next->GetDelta ();
+      m_next++;
+    }
+  if (m_next == m_niChanges.end ())
+    {
+      // all the signals have ended, drop the rounding errors
+      m_nowPowerW = 0.0;
+    }
+  // no signal ending from now on started before the longest signal ago
   if (now > m_maxPacketDuration)
     {
-       NiChanges::iterator nowIterator = m_niChanges.begin ();
-       while (nowIterator != m_niChanges.end () && nowIterator->GetEvent()->GetEndTime() <= now)
+      Time oldest = now - m_maxPacketDuration;
+      while (m_niChanges.begin () != m_next && m_niChanges.begin ()->GetTime () < oldest)
+        {
+          m_firstPower += m_niChanges.begin ()->GetDelta ();
+          m_niChanges.erase (m_niChanges.begin ());
+        }
+      if (m_niChanges.begin () == m_next)
         {
-          m_firstPower += nowIterator->GetDelta ();
-          nowIterator++;
+          // no change left before now, drop the rounding errors
+          m_firstPower = m_nowPowerW;
         }
-       m_niChanges.erase (m_niChanges.begin (), nowIterator);
-       m_niChanges.insert (m_niChanges.begin (), NiChange (event->GetStartTime (), event->GetRxPowerW (), event));
+    }
+}
+
+double
+InterferenceHelper::GetPowerW (Time time) const
+{
+  double powerW;
+  NiChanges::const_iterator i;
+  if (time >= m_now)
+    {
+      powerW = m_nowPowerW;
+      i = m_next;
     }
   else
     {
-      AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW (), event));
+      powerW = m_firstPower;
+      i = m_niChanges.begin ();
+    }
+  for (; i != m_niChanges.end () && i->GetTime () <= time; i++)
+    {
+      powerW += i->GetDelta ();
     }
-  AddNiChangeEvent (NiChange (event->GetEndTime (), -event->GetRxPowerW (), event));
+  return powerW;
 }
 
-
 double
 InterferenceHelper::CalculateSnr (double signal, double noiseInterference, WifiMode mode) const
 {
@@ -283,20 +339,16 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, WifiM
 }
 
 double
-InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event, NiChanges::const_iterator *first,
+                                                 NiChanges::const_iterator *last) const
 {
-  double noiseInterference = m_firstPower;
-  
-  for (NiChanges::const_iterator i = m_niChanges.begin () + 1; i != m_niChanges.end (); i++)
+  double noiseInterference = GetPowerW (event->GetStartTime ());
+  if (event->GetEndTime () > event->GetStartTime ())
     {
-      if ((event->GetEndTime () == i->GetTime ()) && event->GetRxPowerW () == -i->GetDelta ())
-        {
-          break;
-        }
-      ni->push_back (*i);
+      noiseInterference -= event->GetRxPowerW ();
     }
-   ni->insert (ni->begin (), NiChange (event->GetStartTime (), noiseInterference, event));
-   ni->push_back (NiChange (event->GetEndTime (), 0, event));
+  *first = m_niChanges.upper_bound (NiChange (event->GetStartTime (), 0));
+  *last = m_niChanges.lower_bound (NiChange (event->GetEndTime (), 0));
   return noiseInterference;
 }
 
@@ -313,13 +365,45 @@ InterferenceHelper::CalculateChunkSuccessRate (double snir, Time duration, WifiM
   return csr;
 }
 
+void
+InterferenceHelper::AddPayloadChunk (double snir, Time duration, WifiMode mode) const
+{
+  if (duration == NanoSeconds (0))
+    {
+      return;
+    }
+  uint32_t rate = mode.GetPhyRate ();
+  uint64_t nbits = (uint64_t)(rate * duration.GetSeconds ());
+  m_chunkSnrs.push_back (snir);
+  m_chunkBits.push_back ((uint32_t)nbits);
+}
+
 double
-InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculatePayloadChunksSuccessRate (WifiMode mode) const
+{
+  uint32_t n = m_chunkSnrs.size ();
+  double psr = 1.0;
+  if (n > 0)
+    {
+      m_chunkRates.resize (n);
+      m_errorRateModel->GetChunkSuccessRates (mode, n, &m_chunkSnrs[0], &m_chunkBits[0], &m_chunkRates[0]);
+      for (uint32_t i = 0; i < n; i++)
+        {
+          psr *= m_chunkRates[i];
+        }
+    }
+  m_chunkSnrs.clear ();
+  m_chunkBits.clear ();
+  return psr;
+}
+
+double
+InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event> event, double noiseInterferenceW,
+                                             NiChanges::const_iterator first, NiChanges::const_iterator last) const
 {
   NS_LOG_FUNCTION (this);
-  double psr = 1.0; /* Packet Success Rate */
-  NiChanges::iterator j = ni->begin ();
-  Time previous = (*j).GetTime ();
+  NiChanges::const_iterator j = first;
+  Time previous = event->GetStartTime ();
   WifiMode payloadMode = event->GetPayloadMode ();
   WifiPreamble preamble = event->GetPreambleType ();
   Time plcpHeaderStart;
@@ -334,7 +418,7 @@ InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event
  if (payloadMode.GetModulationClass () != WIFI_MOD_CLASS_S1G)
  {
   //plcpHeaderStart = (*j).GetTime () + WifiPhy::GetPlcpPreambleDuration (payloadMode, preamble); //packet start time + preamble
-  plcpHeaderStart = (*j).GetEvent()->GetStartTime() + WifiPhy::GetPlcpPreambleDuration (event->GetTxVector().GetMode(), preamble);
+  plcpHeaderStart = event->GetStartTime () + WifiPhy::GetPlcpPreambleDuration (event->GetTxVector().GetMode(), preamble);
   plcpHsigHeaderStart = plcpHeaderStart + WifiPhy::GetPlcpHeaderDuration (payloadMode, preamble); //packet start time + preamble + L-SIG
   plcpHtTrainingSymbolsStart = plcpHsigHeaderStart + WifiPhy::GetPlcpHtSigHeaderDuration (preamble); //packet start time + preamble + L-SIG + HT-SIG
   plcpPayloadStart = plcpHtTrainingSymbolsStart + WifiPhy::GetPlcpHtTrainingSymbolDuration (preamble,event->GetTxVector ()); //packet start time + preamble + L-SIG + HT-SIG + HT Training
@@ -342,59 +426,66 @@ InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event
  else
    {
   //plcpHeaderStart = (*j).GetTime () + WifiPhy::GetPlcpPreambleDuration (payloadMode, preamble); //packet start time + preamble
-  plcpHeaderStart = (*j).GetEvent()->GetStartTime() + WifiPhy::GetPlcpPreambleDuration (event->GetTxVector().GetMode(), preamble);
+  plcpHeaderStart = event->GetStartTime () + WifiPhy::GetPlcpPreambleDuration (event->GetTxVector().GetMode(), preamble);
   plcpTrainingSymbolsStart = plcpHeaderStart + WifiPhy::GetPlcpHeaderDuration (payloadMode, preamble); //packet start time + preamble + L-SIG
   plcpSigAStart = plcpTrainingSymbolsStart + WifiPhy::GetPlcpTrainingSymbolDuration (preamble,event->GetTxVector()); //packet start time + preamble + L-SIG + LTF
   plcpS1gTrainingSymbolsStart = plcpSigAStart + WifiPhy::GetPlcpSigADuration (preamble); //packet start time + preamble + L-SIG + LTF + S1G-A
   plcpSigBStart = plcpS1gTrainingSymbolsStart + WifiPhy::GetPlcpS1gTrainingSymbolDuration (preamble,event->GetTxVector()); //packet start time + preamble + L-SIG + LTF + S1G-A + S1G Training
   plcpPayloadStart = plcpSigBStart + WifiPhy::GetPlcpSigBDuration (preamble); ////packet start time + preamble + L-SIG + LTF + S1G-A + S1G Training + S1G-B
    }
-  double noiseInterferenceW = (*j).GetDelta ();
   double powerW = event->GetRxPowerW ();
-  j++;
-  while (ni->end () != j)
+  while (true)
     {
-      Time current = (*j).GetTime ();
+      // the last chunk ends with the event
+      Time current = j != last ? (*j).GetTime () : event->GetEndTime ();
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
       NS_ASSERT (current >= previous);
       //Case 1: Both previous and current point to the payload
       if (previous >= plcpPayloadStart)
         {
-          psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                          noiseInterferenceW,
-                                                          payloadMode),
-                                            current - previous,
-                                            payloadMode);
+          AddPayloadChunk (CalculateSnr (powerW,
+                                         noiseInterferenceW,
+                                         payloadMode),
+                           current - previous,
+                           payloadMode);
 
-          NS_LOG_DEBUG ("Both previous and current point to the payload: mode=" << payloadMode << ", psr=" << psr);
+          NS_LOG_DEBUG ("Both previous and current point to the payload: mode=" << payloadMode);
         }
       //Case 2: previous is before payload and current is in the payload
       else if (current >= plcpPayloadStart)
         {
-          psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                          noiseInterferenceW,
-                                                          payloadMode),
-                                            current - plcpPayloadStart,
-                                            payloadMode);
-          NS_LOG_DEBUG ("previous is before payload and current is in the payload: mode=" << payloadMode << ", psr=" << psr);
+          AddPayloadChunk (CalculateSnr (powerW,
+                                         noiseInterferenceW,
+                                         payloadMode),
+                           current - plcpPayloadStart,
+                           payloadMode);
+          NS_LOG_DEBUG ("previous is before payload and current is in the payload: mode=" << payloadMode);
         }
 
+      if (j == last)
+        {
+          break;
+        }
       noiseInterferenceW += (*j).GetDelta ();
-      previous = (*j).GetTime ();
+      previous = current;
       j++;
     }
 
+  // all the chunks of the payload are sent with the same mode
+  double psr = CalculatePayloadChunksSuccessRate (payloadMode); /* Packet Success Rate */
+  NS_LOG_DEBUG ("payload mode=" << payloadMode << ", psr=" << psr);
   double per = 1 - psr;
   return per;
 }
 
 double
-InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event> event, double noiseInterferenceW,
+                                            NiChanges::const_iterator first, NiChanges::const_iterator last) const
 {
   NS_LOG_FUNCTION (this);
   double psr = 1.0; /* Packet Success Rate */
-  NiChanges::iterator j = ni->begin ();
-  Time previous = (*j).GetTime ();
+  NiChanges::const_iterator j = first;
+  Time previous = event->GetStartTime ();
   WifiMode payloadMode = event->GetPayloadMode ();
   WifiPreamble preamble = event->GetPreambleType ();
   WifiMode htHeaderMode;
@@ -416,7 +507,7 @@ InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event>
 if (payloadMode.GetModulationClass () != WIFI_MOD_CLASS_S1G)
  {
   //Time plcpHeaderStart = (*j).GetTime () + WifiPhy::GetPlcpPreambleDuration (payloadMode, preamble); //packet start time + preamble
-  Time plcpHeaderStart = (*j).GetEvent()->GetStartTime() + WifiPhy::GetPlcpPreambleDuration (event->GetTxVector ().GetMode(), preamble);
+  Time plcpHeaderStart = event->GetStartTime () + WifiPhy::GetPlcpPreambleDuration (event->GetTxVector ().GetMode(), preamble);
   Time plcpHsigHeaderStart = plcpHeaderStart + WifiPhy::GetPlcpHeaderDuration (payloadMode, preamble); //packet start time + preamble + L-SIG
   Time plcpHtTrainingSymbolsStart = plcpHsigHeaderStart + WifiPhy::GetPlcpHtSigHeaderDuration (preamble); //packet start time + preamble + L-SIG + HT-SIG
   Time plcpPayloadStart = plcpHtTrainingSymbolsStart + WifiPhy::GetPlcpHtTrainingSymbolDuration (preamble, event->GetTxVector ()); //packet start time + preamble + L-SIG + HT-SIG + HT Training
@@ -424,19 +515,18 @@ if (payloadMode.GetModulationClass () != WIFI_MOD_CLASS_S1G)
 else
  {
   //Time plcpHeaderStart = (*j).GetTime () + WifiPhy::GetPlcpPreambleDuration (payloadMode, preamble); //packet start time + preamble
-  Time plcpHeaderStart = (*j).GetEvent()->GetStartTime() + WifiPhy::GetPlcpPreambleDuration (event->GetTxVector ().GetMode(), preamble);
+  Time plcpHeaderStart = event->GetStartTime () + WifiPhy::GetPlcpPreambleDuration (event->GetTxVector ().GetMode(), preamble);
   Time plcpTrainingSymbolsStart = plcpHeaderStart + WifiPhy::GetPlcpHeaderDuration (payloadMode, preamble); //packet start time + preamble + L-SIG
   Time plcpSigAStart = plcpTrainingSymbolsStart + WifiPhy::GetPlcpTrainingSymbolDuration (preamble,event->GetTxVector()); //packet start time + preamble + L-SIG + LTF
   Time plcpS1gTrainingSymbolsStart = plcpSigAStart + WifiPhy::GetPlcpSigADuration (preamble); //packet start time + preamble + L-SIG + LTF + S1G-A
   Time plcpSigBStart = plcpS1gTrainingSymbolsStart + WifiPhy::GetPlcpS1gTrainingSymbolDuration (preamble,event->GetTxVector()); //packet start time + preamble + L-SIG + LTF + S1G-A + S1G Training
   Time plcpPayloadStart = plcpSigBStart + WifiPhy::GetPlcpSigBDuration (preamble); ////packet start time + preamble + L-SIG + LTF + S1G-A + S1G Training + S1G-B
  }
-  double noiseInterferenceW = (*j).GetDelta ();
   double powerW = event->GetRxPowerW ();
-  j++;
-  while (ni->end () != j)
+  while (true)
     {
-      Time current = (*j).GetTime ();
+      // the last chunk ends with the event
+      Time current = j != last ? (*j).GetTime () : event->GetEndTime ();
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
       NS_ASSERT (current >= previous);
    if (payloadMode.GetModulationClass () != WIFI_MOD_CLASS_S1G)
@@ -715,8 +805,12 @@ else
          }
       }      
 
+      if (j == last)
+        {
+          break;
+        }
       noiseInterferenceW += (*j).GetDelta ();
-      previous = (*j).GetTime ();
+      previous = current;
       j++;
     }
 
@@ -727,8 +821,9 @@ else
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> event)
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  NiChanges::const_iterator first;
+  NiChanges::const_iterator last;
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &first, &last);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetPayloadMode ());
@@ -736,7 +831,7 @@ InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> e
   /* calculate the SNIR at the start of the packet and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculatePlcpPayloadPer (event, &ni);
+  double per = CalculatePlcpPayloadPer (event, noiseInterferenceW, first, last);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -747,8 +842,9 @@ InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> e
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<InterferenceHelper::Event> event)
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  NiChanges::const_iterator first;
+  NiChanges::const_iterator last;
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &first, &last);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              WifiPhy::GetPlcpHeaderMode (event->GetPayloadMode (), event->GetPreambleType ()));
@@ -756,7 +852,7 @@ InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<InterferenceHelper::Event> ev
   /* calculate the SNIR at the start of the plcp header and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculatePlcpHeaderPer (event, &ni);
+  double per = CalculatePlcpHeaderPer (event, noiseInterferenceW, first, last);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -805,15 +901,12 @@ InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<InterferenceHelper::Event> ev
  double
  InterferenceHelper::CalculateSinrAtTime (Ptr <InterferenceHelper::Event> event, Time time)
  {
-   double noiseInterferenceW = 0;
    NS_ASSERT (event->GetEndTime() >= time && event->GetStartTime() <= time);
-   NiChanges::iterator itr = GetPosition (time);
-
-   for (NiChanges::const_iterator i = m_niChanges.begin(); i < itr; i++)
+   Update ();
+   double noiseInterferenceW = GetPowerW (time);
+   if (event->GetEndTime () > time)
      {
-       if (i->GetEvent() == event)
-         continue;
-       noiseInterferenceW += i->GetDelta();
+       noiseInterferenceW -= event->GetRxPowerW ();
      }
    double sinr = CalculateSnr (event->GetRxPowerW (),
                               noiseInterferenceW,
@@ -839,20 +932,25 @@ void
 InterferenceHelper::EraseEvents (void)
 {
   m_niChanges.clear ();
+  m_next = m_niChanges.end ();
+  m_nowPowerW = 0.0;
   m_rxing = false;
   m_firstPower = 0.0;
 }
 
-InterferenceHelper::NiChanges::iterator
-InterferenceHelper::GetPosition (Time moment)
-{
-  return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (moment, 0, NULL));
-}
-
 void
 InterferenceHelper::AddNiChangeEvent (NiChange change)
 {
-  m_niChanges.insert (GetPosition (change.GetTime ()), change);
+  // after the changes at the same time
+  NiChanges::iterator it = m_niChanges.insert (change);
+  if (change.GetTime () <= m_now)
+    {
+      m_nowPowerW += change.GetDelta ();
+    }
+  else if (m_next == m_niChanges.end () || change.GetTime () < m_next->GetTime ())
+    {
+      m_next = it;
+    }
 }
 
 void
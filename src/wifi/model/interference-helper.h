@@ -22,8 +22,9 @@
 #define INTERFERENCE_HELPER_H
 
 #include <stdint.h>
-#include <vector>
+#include <set>
 #include <list>
+#include <vector>
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
 #include "wifi-phy-standard.h"
@@ -202,6 +203,14 @@ private:
   Ptr<InterferenceHelper::Event> Add (uint32_t size, WifiTxVector txvector,
                                       enum WifiPreamble preamble,
                                       Time duration, double rxPower);
+  /**
+   * Add the signal of a packet which will not be received, as
+   * interference only.  Unlike Add, no Event is created.
+   *
+   * \param duration the duration of the signal
+   * \param rxPower receive power (W)
+   */
+  void AddInterference (Time duration, double rxPower);
 
   /**
    * Calculate the SNIR at the start of the plcp payload and accumulate
@@ -270,7 +279,7 @@ public:
      * \param time time of the event
      * \param delta the power
      */
-    NiChange (Time time, double delta, Ptr<InterferenceHelper::Event> event);
+    NiChange (Time time, double delta);
     /**
      * Return the event time.
      *
@@ -290,21 +299,17 @@ public:
      * \return true if a < o.time, false otherwise
      */
     bool operator < (const NiChange& o) const;
-    /**
-     * Get events associated with this niChange
-     */
-    Ptr<InterferenceHelper::Event> GetEvent (void) const;
 
 
 private:
     Time m_time;
     double m_delta;
-    Ptr<InterferenceHelper::Event> m_event;  
   };
   /**
-   * typedef for a vector of NiChanges
+   * typedef for a set of NiChanges sorted by time, changes at the same
+   * time in the order they were added
    */
-  typedef std::vector <NiChange> NiChanges;
+  typedef std::multiset <NiChange> NiChanges;
   /**
    * typedef for a list of Events
    */
@@ -317,14 +322,28 @@ private:
    */
   void AppendEvent (Ptr<Event> event);
   /**
-   * Calculate noise and interference power in W.
+   * Calculate noise and interference power in W at the start of the event.
    *
    * \param event
-   * \param ni
+   * \param first set to the first change after the start of the event
+   * \param last set to the first change at or after the end of the event
    *
    * \return noise and interference power
    */
-  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const;
+  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges::const_iterator *first,
+                                      NiChanges::const_iterator *last) const;
+  /**
+   * \param time a time, not before the start of the oldest change kept
+   *
+   * \return the sum of the powers of the signals received at this time (W),
+   * including the ones starting at this time and not the ones ending at it
+   */
+  double GetPowerW (Time time) const;
+  /**
+   * Move m_now and m_nowPowerW to the current time and forget the
+   * changes older than the longest signal.
+   */
+  void Update (void);
   /**
    * Calculate SNR (linear ratio) from the given signal power and noise+interference power.
    * (Mode is not currently used)
@@ -347,37 +366,64 @@ private:
    * \return the success rate
    */
   double CalculateChunkSuccessRate (double snir, Time duration, WifiMode mode) const;
+  /**
+   * Keep a chunk of the payload, for CalculatePayloadChunksSuccessRate.
+   *
+   * \param snir SINR
+   * \param duration the duration of the chunk
+   * \param mode the payload mode
+   */
+  void AddPayloadChunk (double snir, Time duration, WifiMode mode) const;
+  /**
+   * Calculate the success rate of the chunks kept by AddPayloadChunk in a
+   * single call to the error rate model, and forget them.
+   *
+   * \param mode the payload mode
+   *
+   * \return the success rate of all the chunks
+   */
+  double CalculatePayloadChunksSuccessRate (WifiMode mode) const;
   /**
    * Calculate the error rate of the given plcp payload. The plcp payload can be divided into
    * multiple chunks (e.g. due to interference from other transmissions).
    *
    * \param event
-   * \param ni
+   * \param noiseInterferenceW noise and interference power at the start of the event
+   * \param first the first change after the start of the event
+   * \param last the first change at or after the end of the event
    *
    * \return the error rate of the packet
    */
-  double CalculatePlcpPayloadPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculatePlcpPayloadPer (Ptr<const Event> event, double noiseInterferenceW,
+                                  NiChanges::const_iterator first, NiChanges::const_iterator last) const;
   /**
    * Calculate the error rate of the plcp header. The plcp header can be divided into
    * multiple chunks (e.g. due to interference from other transmissions).
    *
    * \param event
-   * \param ni
+   * \param noiseInterferenceW noise and interference power at the start of the event
+   * \param first the first change after the start of the event
+   * \param last the first change at or after the end of the event
    *
    * \return the error rate of the packet
    */
-  double CalculatePlcpHeaderPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculatePlcpHeaderPer (Ptr<const Event> event, double noiseInterferenceW,
+                                 NiChanges::const_iterator first, NiChanges::const_iterator last) const;
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel;
-  /// Experimental: needed for energy duration calculation
+  /// Power changes of the signals, starting at most the longest signal ago
   NiChanges m_niChanges;
-  double m_firstPower;
+  double m_firstPower;   //!< sum of the powers before the first change kept (W)
+  NiChanges::iterator m_next; //!< first change after m_now
+  Time m_now;            //!< time of the last Update
+  double m_nowPowerW;    //!< sum of the powers of the signals received at m_now (W)
   bool m_rxing;
   Time m_maxPacketDuration;
   Ptr<FrameCaptureModel> m_frameCaptureProbCalc;
-  /// Returns an iterator to the first nichange, which is later than moment
-  NiChanges::iterator GetPosition (Time moment);
+  mutable std::vector<double> m_chunkSnrs;   //!< SINR of the payload chunks being evaluated
+  mutable std::vector<uint32_t> m_chunkBits; //!< number of bits of the payload chunks being evaluated
+  mutable std::vector<double> m_chunkRates;  //!< success rate of the payload chunks being evaluated
   /**
    * Add NiChange to the list at the appropriate position.
    *
@@ -0,0 +1,272 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include "tabulated-error-rate-model.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TabulatedErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TabulatedErrorRateModel);
+
+/// Lower bound of the entries, exp (-100) bits in error being as good as none
+static const double TABLE_MIN = -100;
+/// Upper bound of the entries, exp (-exp (7)) being 0 in double
+static const double TABLE_MAX = 7;
+
+TypeId
+TabulatedErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TabulatedErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<TabulatedErrorRateModel> ()
+    .AddAttribute ("Model", "The error rate model to tabulate.",
+                   PointerValue (),
+                   MakePointerAccessor (&TabulatedErrorRateModel::SetModel,
+                                        &TabulatedErrorRateModel::GetModel),
+                   MakePointerChecker<ErrorRateModel> ())
+    .AddAttribute ("FileName", "The file to load the tables from, none if empty.",
+                   StringValue (""),
+                   MakeStringAccessor (&TabulatedErrorRateModel::SetFileName,
+                                       &TabulatedErrorRateModel::GetFileName),
+                   MakeStringChecker ())
+    .AddAttribute ("MinSnr", "The SNR of the first entry of the tables computed from now on (dB).",
+                   DoubleValue (-20.0),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::m_minSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr", "The SNR of the last entry of the tables computed from now on (dB).",
+                   DoubleValue (50.0),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::m_maxSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("Step", "The SNR between two entries of the tables computed from now on (dB).",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::m_stepDb),
+                   MakeDoubleChecker<double> (0.0))
+  ;
+  return tid;
+}
+
+TabulatedErrorRateModel::TabulatedErrorRateModel ()
+{
+}
+
+TabulatedErrorRateModel::~TabulatedErrorRateModel ()
+{
+}
+
+void
+TabulatedErrorRateModel::DoDispose (void)
+{
+  m_model = 0;
+  m_tables.clear ();
+  ErrorRateModel::DoDispose ();
+}
+
+void
+TabulatedErrorRateModel::SetModel (Ptr<ErrorRateModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_model = model;
+  m_tables.clear ();
+}
+
+Ptr<ErrorRateModel>
+TabulatedErrorRateModel::GetModel (void) const
+{
+  return m_model;
+}
+
+void
+TabulatedErrorRateModel::SetFileName (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_fileName = filename;
+  if (!filename.empty ())
+    {
+      Load (filename);
+    }
+}
+
+std::string
+TabulatedErrorRateModel::GetFileName (void) const
+{
+  return m_fileName;
+}
+
+void
+TabulatedErrorRateModel::Save (std::string filename) const
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ofstream os (filename.c_str ());
+  if (!os.is_open ())
+    {
+      NS_FATAL_ERROR ("Could not open " << filename);
+    }
+  os << std::setprecision (17);
+  for (uint32_t uid = 0; uid < m_tables.size (); uid++)
+    {
+      Table &table = m_tables[uid];
+      if (table.values.empty ())
+        {
+          continue;
+        }
+      for (uint32_t i = 0; i < table.values.size (); i++)
+        {
+          Fill (table, i);
+        }
+      os << table.mode.GetUniqueName () << " " << table.minSnrDb << " " << table.stepDb
+         << " " << table.values.size ();
+      for (std::vector<double>::const_iterator i = table.values.begin (); i != table.values.end (); i++)
+        {
+          os << " " << *i;
+        }
+      os << std::endl;
+    }
+}
+
+void
+TabulatedErrorRateModel::Load (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ifstream is (filename.c_str ());
+  if (!is.is_open ())
+    {
+      NS_FATAL_ERROR ("Could not open " << filename);
+    }
+  std::string name;
+  Table table;
+  uint32_t n;
+  while (is >> name >> table.minSnrDb >> table.stepDb >> n)
+    {
+      if (n < 2 || !(table.stepDb > 0))
+        {
+          NS_FATAL_ERROR ("Invalid table of " << name << " in " << filename);
+        }
+      table.values.resize (n);
+      for (uint32_t i = 0; i < n; i++)
+        {
+          is >> table.values[i];
+        }
+      if (!is)
+        {
+          NS_FATAL_ERROR ("Truncated table of " << name << " in " << filename);
+        }
+      table.mode = WifiMode (name);
+      uint32_t uid = table.mode.GetUid ();
+      if (uid >= m_tables.size ())
+        {
+          m_tables.resize (uid + 1);
+        }
+      m_tables[uid] = table;
+    }
+}
+
+TabulatedErrorRateModel::Table &
+TabulatedErrorRateModel::GetTable (WifiMode mode) const
+{
+  uint32_t uid = mode.GetUid ();
+  if (uid >= m_tables.size ())
+    {
+      m_tables.resize (uid + 1);
+    }
+  Table &table = m_tables[uid];
+  if (table.values.empty ())
+    {
+      uint32_t n = static_cast<uint32_t> ((m_maxSnrDb - m_minSnrDb) / m_stepDb + 0.5) + 1;
+      if (n < 2)
+        {
+          NS_FATAL_ERROR ("The tables need two entries at least");
+        }
+      NS_LOG_DEBUG ("tabulate " << mode << " with " << n << " entries");
+      table.mode = mode;
+      table.minSnrDb = m_minSnrDb;
+      table.stepDb = m_stepDb;
+      table.values.resize (n, std::numeric_limits<double>::quiet_NaN ());
+    }
+  return table;
+}
+
+void
+TabulatedErrorRateModel::Fill (Table &table, uint32_t i) const
+{
+  if (std::isnan (table.values[i]))
+    {
+      NS_ASSERT_MSG (m_model != 0, "No model to tabulate");
+      double snr = std::pow (10.0, (table.minSnrDb + i * table.stepDb) / 10.0);
+      double bitSuccessRate = m_model->GetChunkSuccessRate (table.mode, snr, 1);
+      double value = std::log (-std::log (bitSuccessRate));
+      table.values[i] = std::min (std::max (value, TABLE_MIN), TABLE_MAX);
+    }
+}
+
+double
+TabulatedErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  Table &table = GetTable (mode);
+  double position = (10.0 * std::log10 (snr) - table.minSnrDb) / table.stepDb;
+  // also true for a null SNR
+  if (!(position >= 0) || position >= table.values.size () - 1)
+    {
+      NS_ASSERT_MSG (m_model != 0, "No model for the SNRs off the tables");
+      return m_model->GetChunkSuccessRate (mode, snr, nbits);
+    }
+  uint32_t i = static_cast<uint32_t> (position);
+  Fill (table, i);
+  Fill (table, i + 1);
+  double value = table.values[i] + (table.values[i + 1] - table.values[i]) * (position - i);
+  return std::exp (-std::exp (value) * nbits);
+}
+
+void
+TabulatedErrorRateModel::GetChunkSuccessRates (WifiMode mode, uint32_t n, const double *snr,
+                                               const uint32_t *nbits, double *csr) const
+{
+  Table &table = GetTable (mode);
+  double last = table.values.size () - 1;
+  double minSnr = std::pow (10.0, table.minSnrDb / 10.0);
+  double maxSnr = std::pow (10.0, (table.minSnrDb + last * table.stepDb) / 10.0);
+  // the table is looked up once for all the chunks; exp and log10 are
+  // library calls, so the loop is not vectorized
+  for (uint32_t k = 0; k < n; k++)
+    {
+      // the chunks off the grid are given to the wrapped model
+      if (!(snr[k] >= minSnr) || snr[k] >= maxSnr)
+        {
+          NS_ASSERT_MSG (m_model != 0, "No model for the SNRs off the tables");
+          csr[k] = m_model->GetChunkSuccessRate (mode, snr[k], nbits[k]);
+          continue;
+        }
+      double position = (10.0 * std::log10 (snr[k]) - table.minSnrDb) / table.stepDb;
+      position = std::min (std::max (position, 0.0), last);
+      uint32_t i = std::min (static_cast<uint32_t> (position), static_cast<uint32_t> (last) - 1);
+      Fill (table, i);
+      Fill (table, i + 1);
+      double value = table.values[i] + (table.values[i + 1] - table.values[i]) * (position - i);
+      csr[k] = std::exp (-std::exp (value) * nbits[k]);
+    }
+}
+
+} //namespace ns3
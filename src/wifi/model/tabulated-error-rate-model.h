@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TABULATED_ERROR_RATE_MODEL_H
+#define TABULATED_ERROR_RATE_MODEL_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "wifi-mode.h"
+#include "error-rate-model.h"
+
+namespace ns3 {
+
+/**
+ * \brief Interpolate the error rate of another model from tables.
+ * \ingroup wifi
+ *
+ * The Yans, Nist and Dsss models all compute the success rate of a
+ * chunk as p^nbits, p being the success rate of a single bit.  This
+ * model asks the wrapped model for p on a grid of SNRs in dB, the first
+ * time an entry of the grid is needed, and keeps ln (-ln (p)), which
+ * varies slowly with the SNR in dB.  A chunk then costs a log10, a
+ * linear interpolation and two exp.  SNRs outside of the grid are given
+ * to the wrapped model.
+ *
+ * The tables can be saved to a file and loaded from it by later runs,
+ * using the same wrapped model.
+ */
+class TabulatedErrorRateModel : public ErrorRateModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  TabulatedErrorRateModel ();
+  virtual ~TabulatedErrorRateModel ();
+
+  /**
+   * \param model the model to tabulate
+   */
+  void SetModel (Ptr<ErrorRateModel> model);
+  /**
+   * \return the tabulated model
+   */
+  Ptr<ErrorRateModel> GetModel (void) const;
+
+  /**
+   * Load the tables of a file, if the name is not empty.
+   *
+   * \param filename the file to read
+   */
+  void SetFileName (std::string filename);
+  /**
+   * \return the file the tables were loaded from
+   */
+  std::string GetFileName (void) const;
+
+  /**
+   * Write the tables of the modes used so far, computing all their entries.
+   *
+   * \param filename the file to write
+   */
+  void Save (std::string filename) const;
+  /**
+   * Read tables written by Save, replacing the ones of the same modes.
+   *
+   * \param filename the file to read
+   */
+  void Load (std::string filename);
+
+  virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
+  virtual void GetChunkSuccessRates (WifiMode mode, uint32_t n, const double *snr,
+                                     const uint32_t *nbits, double *csr) const;
+
+
+private:
+  /// ln (-ln (success rate of a bit)) on a grid of SNRs
+  struct Table
+  {
+    WifiMode mode;              //!< the mode
+    double minSnrDb;            //!< SNR of the first entry (dB)
+    double stepDb;              //!< SNR between two entries (dB)
+    std::vector<double> values; //!< the entries, NaN until computed
+  };
+
+  virtual void DoDispose (void);
+  /**
+   * \param mode a Wi-Fi mode
+   *
+   * \return the table of the mode, added if needed
+   */
+  Table & GetTable (WifiMode mode) const;
+  /**
+   * Compute an entry of a table, if not known yet.
+   *
+   * \param table the table
+   * \param i the index of the entry
+   */
+  void Fill (Table &table, uint32_t i) const;
+
+  Ptr<ErrorRateModel> m_model;        //!< tabulated model
+  std::string m_fileName;             //!< file the tables were loaded from
+  double m_minSnrDb;                  //!< SNR of the first entry of new tables (dB)
+  double m_maxSnrDb;                  //!< SNR of the last entry of new tables (dB)
+  double m_stepDb;                    //!< SNR between two entries of new tables (dB)
+  mutable std::vector<Table> m_tables; //!< table of each mode, by uid
+};
+
+} //namespace ns3
+
+#endif /* TABULATED_ERROR_RATE_MODEL_H */
@@ -35,7 +35,8 @@ WifiMacQueue::Item::Item (Ptr<const Packet> packet,
                           Time tstamp)
   : packet (packet),
     hdr (hdr),
-    tstamp (tstamp)
+    tstamp (tstamp),
+    heapIndex (0)
 {
 }
 
@@ -60,7 +61,8 @@ WifiMacQueue::GetTypeId (void)
 
 WifiMacQueue::WifiMacQueue ()
   : m_size (0),
-    m_nextCleanup (0)
+    m_nAuthentication (0),
+    m_nAssocResp (0)
 {
 }
 
@@ -79,7 +81,6 @@ void
 WifiMacQueue::SetMaxDelay (Time delay)
 {
   m_maxDelay = delay;
-  m_nextCleanup = TimeStep (0);
 }
 
 uint32_t
@@ -97,38 +98,134 @@ WifiMacQueue::GetMaxDelay (void) const
 uint32_t
 WifiMacQueue::GetAuthRepNumber (void)
 {
-  if (m_queue.empty ())
+  return m_nAuthentication;
+}
+
+uint32_t
+WifiMacQueue::GetAssocRepNumber (void)
+{
+  return m_nAssocResp;
+}
+
+void
+WifiMacQueue::Index (PacketQueueI it, bool front)
+{
+  if (it->hdr.IsAuthentication ())
     {
-      return 0;
+      m_nAuthentication++;
     }
-  uint32_t AuthRepNumber = 0;
-  for (PacketQueueI i = m_queue.begin (); i != m_queue.end (); i++ )
+  else if (it->hdr.IsAssocResp ())
     {
-          if (i->hdr.IsAuthentication ())
-          {
-          AuthRepNumber++;
-        }
+      m_nAssocResp++;
+    }
+  else if (it->hdr.IsQosData ())
+    {
+      FlowId id (it->hdr.GetAddr1 (), it->hdr.GetQosTid ());
+      it->flow = m_flows.insert (std::make_pair (id, FlowQueue ())).first;
+      FlowQueue &flow = it->flow->second;
+      it->flowIt = flow.insert (front ? flow.begin () : flow.end (), it);
     }
-    return AuthRepNumber;
+  it->heapIndex = m_deadlines.size ();
+  m_deadlines.push_back (it);
+  HeapUp (it->heapIndex);
+  m_size++;
 }
 
-uint32_t
-WifiMacQueue::GetAssocRepNumber (void)
+WifiMacQueue::PacketQueueI
+WifiMacQueue::Erase (PacketQueueI it)
 {
-  if (m_queue.empty ())
+  if (it->hdr.IsAuthentication ())
     {
-      return 0;
+      m_nAuthentication--;
     }
-  uint32_t AssocRepNumber = 0;
-  for (PacketQueueI i = m_queue.begin (); i != m_queue.end (); i++ )
+  else if (it->hdr.IsAssocResp ())
     {
-          if (i->hdr.IsAssocResp ())
-          {
+      m_nAssocResp--;
+    }
+  else if (it->hdr.IsQosData ())
+    {
+      it->flow->second.erase (it->flowIt);
+      if (it->flow->second.empty ())
+        {
+          m_flows.erase (it->flow);
+        }
+    }
+  uint32_t i = it->heapIndex;
+  uint32_t last = m_deadlines.size () - 1;
+  if (i != last)
+    {
+      HeapSwap (i, last);
+      m_deadlines.pop_back ();
+      HeapDown (i);
+      HeapUp (i);
+    }
+  else
+    {
+      m_deadlines.pop_back ();
+    }
+  m_size--;
+  return m_queue.erase (it);
+}
 
-          AssocRepNumber++;
+void
+WifiMacQueue::HeapSwap (uint32_t i, uint32_t j)
+{
+  std::swap (m_deadlines[i], m_deadlines[j]);
+  m_deadlines[i]->heapIndex = i;
+  m_deadlines[j]->heapIndex = j;
+}
+
+void
+WifiMacQueue::HeapUp (uint32_t i)
+{
+  while (i > 0)
+    {
+      uint32_t parent = (i - 1) / 2;
+      if (m_deadlines[parent]->tstamp <= m_deadlines[i]->tstamp)
+        {
+          break;
         }
+      HeapSwap (i, parent);
+      i = parent;
     }
-    return AssocRepNumber;
+}
+
+void
+WifiMacQueue::HeapDown (uint32_t i)
+{
+  uint32_t n = m_deadlines.size ();
+  while (true)
+    {
+      uint32_t smallest = i;
+      uint32_t left = 2 * i + 1;
+      uint32_t right = left + 1;
+      if (left < n && m_deadlines[left]->tstamp < m_deadlines[smallest]->tstamp)
+        {
+          smallest = left;
+        }
+      if (right < n && m_deadlines[right]->tstamp < m_deadlines[smallest]->tstamp)
+        {
+          smallest = right;
+        }
+      if (smallest == i)
+        {
+          break;
+        }
+      HeapSwap (i, smallest);
+      i = smallest;
+    }
+}
+
+bool
+WifiMacQueue::FindFlowHead (uint8_t tid, Mac48Address addr, PacketQueueI &it)
+{
+  Flows::iterator flow = m_flows.find (FlowId (addr, tid));
+  if (flow == m_flows.end ())
+    {
+      return false;
+    }
+  it = flow->second.front ();
+  return true;
 }
 
 void
@@ -141,44 +238,17 @@ WifiMacQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
     }
   Time now = Simulator::Now ();
   m_queue.push_back (Item (packet, hdr, now));
-  m_size++;
+  Index (--m_queue.end (), false);
 }
 
 void
 WifiMacQueue::Cleanup (void)
 {
-  if (m_queue.empty ())
-    {
-      return;
-    }
-
   Time now = Simulator::Now ();
-  if (now < m_nextCleanup)
+  while (!m_deadlines.empty () && m_deadlines.front ()->tstamp + m_maxDelay <= now)
     {
-      return;
+      Erase (m_deadlines.front ());
     }
-
-  m_nextCleanup = now + m_maxDelay;
-  uint32_t n = 0;
-
-  for (PacketQueueI i = m_queue.begin (); i != m_queue.end (); )
-    {
-      Time deadline = i->tstamp + m_maxDelay;
-      if (deadline > now)
-        {
-          i++;
-          if (deadline < m_nextCleanup)
-            {
-              m_nextCleanup = deadline;
-            }
-        }
-      else
-        {
-          i = m_queue.erase (i);
-          n++;
-        }
-    }
-  m_size -= n;
 }
 
 Ptr<const Packet>
@@ -187,11 +257,10 @@ WifiMacQueue::Dequeue (WifiMacHeader *hdr)
   Cleanup ();
   if (!m_queue.empty ())
     {
-      Item i = m_queue.front ();
-      m_queue.pop_front ();
-      m_size--;
-      *hdr = i.hdr;
-      return i.packet;
+      Ptr<const Packet> packet = m_queue.front ().packet;
+      *hdr = m_queue.front ().hdr;
+      Erase (m_queue.begin ());
+      return packet;
     }
   return 0;
 }
@@ -215,22 +284,28 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
 {
   Cleanup ();
   Ptr<const Packet> packet = 0;
-  if (!m_queue.empty ())
+  PacketQueueI it;
+  if (type == WifiMacHeader::ADDR1)
     {
-      PacketQueueI it;
-      for (it = m_queue.begin (); it != m_queue.end (); ++it)
+      if (FindFlowHead (tid, dest, it))
         {
-          if (it->hdr.IsQosData ())
+          packet = it->packet;
+          *hdr = it->hdr;
+          Erase (it);
+        }
+      return packet;
+    }
+  for (it = m_queue.begin (); it != m_queue.end (); ++it)
+    {
+      if (it->hdr.IsQosData ())
+        {
+          if (GetAddressForPacket (type, it) == dest
+              && it->hdr.GetQosTid () == tid)
             {
-              if (GetAddressForPacket (type, it) == dest
-                  && it->hdr.GetQosTid () == tid)
-                {
-                  packet = it->packet;
-                  *hdr = it->hdr;
-                  m_queue.erase (it);
-                  m_size--;
-                  break;
-                }
+              packet = it->packet;
+              *hdr = it->hdr;
+              Erase (it);
+              break;
             }
         }
     }
@@ -242,9 +317,19 @@ WifiMacQueue::PeekByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                                    WifiMacHeader::AddressType type, Mac48Address dest, Time *timestamp)
 {
   Cleanup ();
+  PacketQueueI it;
+  if (type == WifiMacHeader::ADDR1)
+    {
+      if (FindFlowHead (tid, dest, it))
+        {
+          *hdr = it->hdr;
+          *timestamp = it->tstamp;
+          return it->packet;
+        }
+      return 0;
+    }
   if (!m_queue.empty ())
     {
-      PacketQueueI it;
       for (it = m_queue.begin (); it != m_queue.end (); ++it)
         {
           if (it->hdr.IsQosData ())
@@ -280,6 +365,10 @@ WifiMacQueue::Flush (void)
 {
   m_queue.erase (m_queue.begin (), m_queue.end ());
   m_size = 0;
+  m_nAuthentication = 0;
+  m_nAssocResp = 0;
+  m_flows.clear ();
+  m_deadlines.clear ();
 }
 
 Mac48Address
@@ -308,8 +397,7 @@ WifiMacQueue::Remove (Ptr<const Packet> packet)
     {
       if (it->packet == packet)
         {
-          m_queue.erase (it);
-          m_size--;
+          Erase (it);
           return true;
         }
     }
@@ -326,7 +414,7 @@ WifiMacQueue::PushFront (Ptr<const Packet> packet, const WifiMacHeader &hdr)
     }
   Time now = Simulator::Now ();
   m_queue.push_front (Item (packet, hdr, now));
-  m_size++;
+  Index (m_queue.begin (), true);
 }
 
 uint32_t
@@ -334,6 +422,11 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, WifiMacHeader::AddressTyp
                                           Mac48Address addr)
 {
   Cleanup ();
+  if (type == WifiMacHeader::ADDR1)
+    {
+      Flows::const_iterator flow = m_flows.find (FlowId (addr, tid));
+      return flow == m_flows.end () ? 0 : flow->second.size ();
+    }
   uint32_t nPackets = 0;
   if (!m_queue.empty ())
     {
@@ -366,8 +459,7 @@ WifiMacQueue::DequeueFirstAvailable (WifiMacHeader *hdr, Time &timestamp,
           *hdr = it->hdr;
           timestamp = it->tstamp;
           packet = it->packet;
-          m_queue.erase (it);
-          m_size--;
+          Erase (it);
           return packet;
         }
     }
@@ -404,8 +496,7 @@ WifiMacQueue::DropByAddress (Mac48Address dest)
         {
           if (it->hdr.GetAddr1 () == dest)
             {
-              it = m_queue.erase (it);
-              m_size--;
+              it = Erase (it);
             }
           else
             {
@@ -24,7 +24,9 @@
 #define WIFI_MAC_QUEUE_H
 
 #include <list>
+#include <map>
 #include <utility>
+#include <vector>
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
 #include "ns3/object.h"
@@ -47,6 +49,13 @@ class QosBlockedDestinations;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * Besides the FIFO list of all packets, the queue keeps, for every
+ * (ADDR1, TID) of QoS data, the list of its packets in FIFO order, and
+ * a min-heap of all packets ordered by timestamp. The per-flow lists
+ * serve the ADDR1 lookups of block ack and aggregation without a walk
+ * over the whole queue, and the heap lets Cleanup find expired packets
+ * without a walk either.
  */
 class WifiMacQueue : public Object
 {
@@ -75,14 +84,14 @@ public:
   uint32_t GetMaxSize (void) const;
 
   /**
-   * Return number of AssocRep in queue
+   * Return number of AssocRep in queue, in constant time
    *
    * \return number of AssocRep in queue
    */
   uint32_t GetAssocRepNumber (void);
 
   /**
-   * Return number of AuthRep in queue
+   * Return number of AuthRep in queue, in constant time
    *
    * \return number of AuthRep in queue
    */
@@ -175,7 +184,7 @@ public:
   bool Remove (Ptr<const Packet> packet);
   /**
    * Returns number of QoS packets having tid equals to <i>tid</i> and address
-   * specified by <i>type</i> equals to <i>addr</i>.
+   * specified by <i>type</i> equals to <i>addr</i>. Does not walk the queue for ADDR1.
    *
    * \param tid the given TID
    * \param type the given address type
@@ -239,6 +248,32 @@ protected:
    */
   virtual void Cleanup (void);
 
+  struct Item;
+  /**
+   * typedef for packet (struct Item) queue.
+   */
+  typedef std::list<struct Item> PacketQueue;
+  /**
+   * typedef for packet (struct Item) queue reverse iterator.
+   */
+  typedef std::list<struct Item>::reverse_iterator PacketQueueRI;
+  /**
+   * typedef for packet (struct Item) queue iterator.
+   */
+  typedef std::list<struct Item>::iterator PacketQueueI;
+  /**
+   * typedef for the packets of one (ADDR1, TID), in queue order.
+   */
+  typedef std::list<PacketQueueI> FlowQueue;
+  /**
+   * typedef for the key of the per-flow lists, (ADDR1, TID) of QoS data.
+   */
+  typedef std::pair<Mac48Address, uint8_t> FlowId;
+  /**
+   * typedef for the per-flow lists, without empty lists.
+   */
+  typedef std::map<FlowId, FlowQueue> Flows;
+
   /**
    * A struct that holds information about a packet for putting
    * in a packet queue.
@@ -258,35 +293,72 @@ protected:
     Ptr<const Packet> packet; //!< Actual packet
     WifiMacHeader hdr;        //!< Wifi MAC header associated with the packet
     Time tstamp;              //!< timestamp when the packet arrived at the queue
+    Flows::iterator flow;     //!< per-flow list of a QoS data packet
+    FlowQueue::iterator flowIt; //!< position in that list
+    uint32_t heapIndex;       //!< position in the deadline heap
   };
 
   /**
-   * typedef for packet (struct Item) queue.
+   * Return the appropriate address for the given packet (given by PacketQueue iterator).
+   *
+   * \param type
+   * \param it
+   *
+   * \return the address
    */
-  typedef std::list<struct Item> PacketQueue;
+  Mac48Address GetAddressForPacket (enum WifiMacHeader::AddressType type, PacketQueueI it);
   /**
-   * typedef for packet (struct Item) queue reverse iterator.
+   * Add a packet just inserted in m_queue to the counters, its flow list
+   * and the deadline heap.
+   *
+   * \param it the packet
+   * \param front whether the packet was inserted at the head of the queue
    */
-  typedef std::list<struct Item>::reverse_iterator PacketQueueRI;
+  void Index (PacketQueueI it, bool front);
   /**
-   * typedef for packet (struct Item) queue iterator.
+   * Remove a packet from the queue and from all indexes.
+   *
+   * \param it the packet
+   * \return the packet following it in the queue
    */
-  typedef std::list<struct Item>::iterator PacketQueueI;
+  PacketQueueI Erase (PacketQueueI it);
   /**
-   * Return the appropriate address for the given packet (given by PacketQueue iterator).
+   * Return the first QoS data packet of the given ADDR1 and TID.
    *
-   * \param type
-   * \param it
+   * \param tid the TID
+   * \param addr the ADDR1
+   * \param it receives the packet
+   * \return false if the queue holds no such packet
+   */
+  bool FindFlowHead (uint8_t tid, Mac48Address addr, PacketQueueI &it);
+  /**
+   * Move the deadline heap element at position i towards the root.
    *
-   * \return the address
+   * \param i the position
    */
-  Mac48Address GetAddressForPacket (enum WifiMacHeader::AddressType type, PacketQueueI it);
+  void HeapUp (uint32_t i);
+  /**
+   * Move the deadline heap element at position i towards the leaves.
+   *
+   * \param i the position
+   */
+  void HeapDown (uint32_t i);
+  /**
+   * Swap two deadline heap elements.
+   *
+   * \param i the position of the first
+   * \param j the position of the second
+   */
+  void HeapSwap (uint32_t i, uint32_t j);
 
   PacketQueue m_queue; //!< Packet (struct Item) queue
   uint32_t m_size;     //!< Current queue size
+  uint32_t m_nAuthentication; //!< Authentication frames in the queue
+  uint32_t m_nAssocResp;      //!< Association responses in the queue
+  Flows m_flows;       //!< QoS data packets per (ADDR1, TID)
+  std::vector<PacketQueueI> m_deadlines; //!< Min-heap of all packets by timestamp
   uint32_t m_maxSize;  //!< Queue capacity
   Time m_maxDelay;     //!< Time to live for packets in the queue
-  Time m_nextCleanup;  //!< Nearest packet deadline
 };
 
 } //namespace ns3
@@ -460,6 +460,138 @@ WifiPhy::GetPlcpPreambleDuration (WifiMode payloadMode, WifiPreamble preamble)
     }
 }
 
+/// Number of spatial streams up to which the symbol durations are kept
+static const uint8_t MAX_CACHED_NSS = 4;
+
+/**
+ * \param payloadMode a HT or S1G mode
+ * \param nss the number of spatial streams
+ *
+ * \return the duration of an OFDM symbol of the payload
+ */
+static Time
+ComputeSymbolDuration (WifiMode payloadMode, uint8_t nss)
+{
+  if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_HT)
+    {
+      Time symbolDuration;
+      //if short GI data rate is used then symbol duration is 3.6us else symbol duration is 4us
+      //In the future has to create a stationmanager that only uses these data rates if sender and reciever support GI
+      if (payloadMode.GetUniqueName () == "OfdmRate135MbpsBW40MHzShGi" || payloadMode.GetUniqueName () == "OfdmRate65MbpsBW20MHzShGi" )
+        {
+          symbolDuration = NanoSeconds (3600);
+        }
+      else
+        {
+          switch (payloadMode.GetDataRate () / nss)
+            {
+            //shortGi
+            case 7200000:
+            case 14400000:
+            case 21700000:
+            case 28900000:
+            case 43300000:
+            case 57800000:
+            case 72200000:
+            case 15000000:
+            case 30000000:
+            case 45000000:
+            case 60000000:
+            case 90000000:
+            case 120000000:
+            case 150000000:
+              symbolDuration = NanoSeconds (3600);
+              break;
+            default:
+              symbolDuration = MicroSeconds (4);
+            }
+        }
+      return symbolDuration;
+    }
+  else
+    {
+      Time symbolDuration;
+      if ( payloadMode.GetUniqueName() == "OfdmRate6_5MbpsBW16MHz" || payloadMode.GetUniqueName() == "OfdmRate3MbpsBW4MHz"  ||
+            payloadMode.GetUniqueName() == "OfdmRate13MbpsBW8MHz"   || payloadMode.GetUniqueName() == "OfdmRate26MbpsBW16MHz" ||
+            payloadMode.GetUniqueName() == "OfdmRate19_5MbpsBW8MHz" || payloadMode.GetUniqueName() == "OfdmRate39MbpsBW16MHz" ||
+            payloadMode.GetUniqueName() == "OfdmRate3MbpsBW1MHzShGi" || payloadMode.GetUniqueName() == "OfdmRate6_5MbpsBW2MHzShGi" ||
+            payloadMode.GetUniqueName() == "OfdmRate13_5MbpsBW4MHzShGi" || payloadMode.GetUniqueName() =="OfdmRate29_25MbpsBW8MHzShGi"  ||
+            payloadMode.GetUniqueName() == "OfdmRate58_5MbpsBW16MHzShGi" || payloadMode.GetUniqueName() == "OfdmRate4MbpsBW1MHzShGi" ||
+            payloadMode.GetUniqueName() == "OfdmRate18MbpsBW4MHzShGi" || payloadMode.GetUniqueName() == "OfdmRate39MbpsBW8MHzShGi" ||
+            payloadMode.GetUniqueName() == "OfdmRate78MbpsBW16MHzShGi" )
+        {
+            symbolDuration = MicroSeconds (36);
+        }
+      else if (payloadMode.GetModulationClass() == WIFI_MOD_CLASS_S1G )
+        {
+          switch (payloadMode.GetDataRate () / nss)
+            {
+                case 333300:
+                case 722200:
+                case 1500000:
+                case 3250000:
+                case 666700:
+                case 1444400:
+                case 6500000:
+                case 13000000:
+                case 1000000:
+                case 2166700:
+                case 4500000:
+                case 9750000:
+                case 19500000:
+                case 1333300:
+                case 2888900:
+                case 6000000:
+                case 2000000:
+                case 4333300:
+                case 9000000:
+                case 2666700:
+                case 5777800:
+                case 12000000:
+                case 26000000:
+                case 52000000:
+                case 3333300:
+                case 7222200:
+                case 15000000:
+                case 32500000:
+                case 65000000:
+                case 8666700:
+                case 4444400:
+                case 20000000:
+                case 43333300:
+                case 86666700:
+                case 166700:
+                  symbolDuration = MicroSeconds (36);
+                  break;
+                default:
+                  symbolDuration = MicroSeconds (40);
+             }
+          }
+      return symbolDuration;
+    }
+}
+
+Time
+WifiPhy::GetSymbolDuration (WifiMode payloadMode, uint8_t nss)
+{
+  // some short guard interval modes are told by their name, and comparing
+  // names allocates strings for every frame: keep the durations by uid
+  if (nss == 0 || nss > MAX_CACHED_NSS)
+    {
+      return ComputeSymbolDuration (payloadMode, nss);
+    }
+  uint32_t index = payloadMode.GetUid () * MAX_CACHED_NSS + nss - 1;
+  if (index >= m_symbolDurations.size ())
+    {
+      m_symbolDurations.resize (index + 1, Time (0));
+    }
+  if (m_symbolDurations[index].IsZero ())
+    {
+      m_symbolDurations[index] = ComputeSymbolDuration (payloadMode, nss);
+    }
+  return m_symbolDurations[index];
+}
+
 Time
 WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txvector, WifiPreamble preamble, double frequency, uint8_t packetType, uint8_t incFlag)
 {
@@ -549,40 +681,8 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txvector, WifiPreamble
       }
     case WIFI_MOD_CLASS_HT:
       {
-        Time symbolDuration;
+        Time symbolDuration = GetSymbolDuration (payloadMode, txvector.GetNss ());
         double m_Stbc;
-        //if short GI data rate is used then symbol duration is 3.6us else symbol duration is 4us
-        //In the future has to create a stationmanager that only uses these data rates if sender and reciever support GI
-        if (payloadMode.GetUniqueName () == "OfdmRate135MbpsBW40MHzShGi" || payloadMode.GetUniqueName () == "OfdmRate65MbpsBW20MHzShGi" )
-          {
-            symbolDuration = NanoSeconds (3600);
-          }
-        else
-          {
-            switch (payloadMode.GetDataRate () / (txvector.GetNss ()))
-              {
-              //shortGi
-              case 7200000:
-              case 14400000:
-              case 21700000:
-              case 28900000:
-              case 43300000:
-              case 57800000:
-              case 72200000:
-              case 15000000:
-              case 30000000:
-              case 45000000:
-              case 60000000:
-              case 90000000:
-              case 120000000:
-              case 150000000:
-                symbolDuration = NanoSeconds (3600);
-                break;
-              default:
-                symbolDuration = MicroSeconds (4);
-              }
-          }
-
         if (txvector.IsStbc ())
           {
             m_Stbc = 2;
@@ -653,64 +753,7 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txvector, WifiPreamble
       }
     case WIFI_MOD_CLASS_S1G:
       {
-        Time symbolDuration;
-        //
-        if ( payloadMode.GetUniqueName() == "OfdmRate6_5MbpsBW16MHz" || payloadMode.GetUniqueName() == "OfdmRate3MbpsBW4MHz"  ||
-              payloadMode.GetUniqueName() == "OfdmRate13MbpsBW8MHz"   || payloadMode.GetUniqueName() == "OfdmRate26MbpsBW16MHz" ||
-              payloadMode.GetUniqueName() == "OfdmRate19_5MbpsBW8MHz" || payloadMode.GetUniqueName() == "OfdmRate39MbpsBW16MHz" ||
-              payloadMode.GetUniqueName() == "OfdmRate3MbpsBW1MHzShGi" || payloadMode.GetUniqueName() == "OfdmRate6_5MbpsBW2MHzShGi" ||
-              payloadMode.GetUniqueName() == "OfdmRate13_5MbpsBW4MHzShGi" || payloadMode.GetUniqueName() =="OfdmRate29_25MbpsBW8MHzShGi"  ||
-              payloadMode.GetUniqueName() == "OfdmRate58_5MbpsBW16MHzShGi" || payloadMode.GetUniqueName() == "OfdmRate4MbpsBW1MHzShGi" ||
-              payloadMode.GetUniqueName() == "OfdmRate18MbpsBW4MHzShGi" || payloadMode.GetUniqueName() == "OfdmRate39MbpsBW8MHzShGi" ||
-              payloadMode.GetUniqueName() == "OfdmRate78MbpsBW16MHzShGi" )
-          {
-              symbolDuration = MicroSeconds (36);
-          }
-        else if (payloadMode.GetModulationClass() == WIFI_MOD_CLASS_S1G )
-          {
-            switch (payloadMode.GetDataRate ()/ (txvector.GetNss()))
-              {
-                  case 333300:
-                  case 722200:
-                  case 1500000:
-                  case 3250000:
-                  case 666700:
-                  case 1444400:
-                  case 6500000:
-                  case 13000000:
-                  case 1000000:
-                  case 2166700:
-                  case 4500000:
-                  case 9750000:
-                  case 19500000:
-                  case 1333300:
-                  case 2888900:
-                  case 6000000:
-                  case 2000000:
-                  case 4333300:
-                  case 9000000:
-                  case 2666700:
-                  case 5777800:
-                  case 12000000:
-                  case 26000000:
-                  case 52000000:
-                  case 3333300:
-                  case 7222200:
-                  case 15000000:
-                  case 32500000:
-                  case 65000000:
-                  case 8666700:
-                  case 4444400:
-                  case 20000000:
-                  case 43333300:
-                  case 86666700:
-                  case 166700:
-                    symbolDuration = MicroSeconds (36);
-                    break;
-                  default:
-                    symbolDuration = MicroSeconds (40);
-               }
-            }
+        Time symbolDuration = GetSymbolDuration (payloadMode, txvector.GetNss ());
         double m_Stbc;
         if (txvector.IsStbc())
           {
@@ -806,12 +849,62 @@ else
   return duration;
 }
 
+bool
+WifiPhy::AirtimeKey::operator < (const AirtimeKey &o) const
+{
+  if (modeUid != o.modeUid)
+    {
+      return modeUid < o.modeUid;
+    }
+  if (size != o.size)
+    {
+      return size < o.size;
+    }
+  if (preamble != o.preamble)
+    {
+      return preamble < o.preamble;
+    }
+  if (nss != o.nss)
+    {
+      return nss < o.nss;
+    }
+  if (ness != o.ness)
+    {
+      return ness < o.ness;
+    }
+  if (stbc != o.stbc)
+    {
+      return stbc < o.stbc;
+    }
+  return band2_4GHz < o.band2_4GHz;
+}
+
 Time
 WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txvector, WifiPreamble preamble, double frequency, uint8_t packetType, uint8_t incFlag)
 {
-  Time duration = CalculatePlcpPreambleAndHeaderDuration (txvector, preamble)
-    + GetPayloadDuration (size, txvector, preamble, frequency, packetType, incFlag);
-  return duration;
+  if (packetType != 0)
+    {
+      //the MPDUs of an A-MPDU depend on the ones before them
+      Time duration = CalculatePlcpPreambleAndHeaderDuration (txvector, preamble)
+        + GetPayloadDuration (size, txvector, preamble, frequency, packetType, incFlag);
+      return duration;
+    }
+  AirtimeKey key;
+  key.modeUid = txvector.GetMode ().GetUid ();
+  key.size = size;
+  key.preamble = preamble;
+  key.nss = txvector.GetNss ();
+  key.ness = txvector.GetNess ();
+  key.stbc = txvector.IsStbc ();
+  key.band2_4GHz = frequency >= 2400 && frequency <= 2500;
+  Airtimes::iterator it = m_airtimes.lower_bound (key);
+  if (it == m_airtimes.end () || key < it->first)
+    {
+      Time duration = CalculatePlcpPreambleAndHeaderDuration (txvector, preamble)
+        + GetPayloadDuration (size, txvector, preamble, frequency, packetType, incFlag);
+      it = m_airtimes.insert (it, std::make_pair (key, duration));
+    }
+  return it->second;
 }
 
 void
@@ -22,6 +22,8 @@
 #define WIFI_PHY_H
 
 #include <stdint.h>
+#include <map>
+#include <vector>
 #include "ns3/callback.h"
 #include "ns3/packet.h"
 #include "ns3/object.h"
@@ -292,6 +294,9 @@ public:
    * \param incFlag this flag is used to indicate that the static variables need to be update or not. This function is called a couple of times for the same packet so static variables should not be increased each time.
    *
    * \return the total amount of time this PHY will stay busy for the transmission of these bytes.
+   *
+   * The durations of the frames which are not part of an A-MPDU are
+   * computed once and kept by the PHY.
    */
   Time CalculateTxDuration (uint32_t size, WifiTxVector txvector, enum WifiPreamble preamble, double frequency, uint8_t packetType, uint8_t incFlag);
 
@@ -1872,6 +1877,36 @@ private:
    */
   TracedCallback<Ptr<const Packet>, uint16_t, uint16_t, uint32_t, bool, WifiTxVector> m_phyMonitorSniffTxTrace;
 
+  /**
+   * \param payloadMode a HT or S1G mode
+   * \param nss the number of spatial streams
+   *
+   * \return the duration of an OFDM symbol of the payload, computed once per mode
+   */
+  Time GetSymbolDuration (WifiMode payloadMode, uint8_t nss);
+
+  /// The parameters the duration of a frame which is not part of an A-MPDU depends on
+  struct AirtimeKey
+  {
+    uint32_t modeUid; //!< uid of the payload mode
+    uint32_t size;    //!< size of the frame (bytes)
+    uint8_t preamble; //!< preamble type
+    uint8_t nss;      //!< number of spatial streams
+    uint8_t ness;     //!< number of extension spatial streams
+    bool stbc;        //!< whether STBC is used
+    bool band2_4GHz;  //!< whether the channel is in the 2.4 GHz band
+    /**
+     * \param o the other key
+     *
+     * \return true if this key is ordered before the other one
+     */
+    bool operator < (const AirtimeKey &o) const;
+  };
+  /// Durations of the frames sent or timed so far
+  typedef std::map<AirtimeKey, Time> Airtimes;
+
+  Airtimes m_airtimes;                 //!< durations of the frames which are not part of an A-MPDU
+  std::vector<Time> m_symbolDurations; //!< symbol duration of each mode by uid and number of spatial streams, zero until computed
   uint32_t m_totalAmpduNumSymbols; //!< Number of symbols previously transmitted for the MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
   uint32_t m_totalAmpduSize;       //!< Total size of the previously transmitted MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
 };
@@ -24,19 +24,114 @@
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/log.h"
+#include "ns3/abort.h"
 #include "ns3/pointer.h"
 #include "ns3/object-factory.h"
 #include "yans-wifi-channel.h"
 #include "yans-wifi-phy.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
+#include "ns3/cached-propagation-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("YansWifiChannel");
 
+YansWifiFrame::YansWifiFrame (Ptr<const Packet> packet, WifiTxVector txVector, WifiPreamble preamble,
+                              uint8_t packetType, Time duration)
+  : packet (packet),
+    txVector (txVector),
+    preamble (preamble),
+    packetType (packetType),
+    duration (duration)
+{
+}
+
+/**
+ * \ingroup wifi
+ *
+ * The position and velocity of the mobility model of a PHY, as seen by
+ * the thread of its node when the course last changed.  The position is
+ * extrapolated from them at the time of the thread which asks for it,
+ * without changing the snapshot, so that the threads of the senders
+ * only read it.
+ */
+class YansWifiMobilitySnapshot : public MobilityModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  /**
+   * Take the position and the velocity of a mobility model, at the
+   * current time.
+   *
+   * \param mobility the mobility model
+   */
+  void Update (Ptr<const MobilityModel> mobility);
+
+private:
+  virtual Vector DoGetPosition (void) const;
+  virtual void DoSetPosition (const Vector &position);
+  virtual Vector DoGetVelocity (void) const;
+
+  Vector m_position;  //!< position at m_time
+  Vector m_velocity;  //!< velocity from m_time
+  Time m_time;        //!< time of the snapshot
+};
+
+TypeId
+YansWifiMobilitySnapshot::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::YansWifiMobilitySnapshot")
+    .SetParent<MobilityModel> ()
+    .SetGroupName ("Wifi")
+  ;
+  return tid;
+}
+
+void
+YansWifiMobilitySnapshot::Update (Ptr<const MobilityModel> mobility)
+{
+  m_position = mobility->GetPosition ();
+  m_velocity = mobility->GetVelocity ();
+  m_time = Simulator::Now ();
+  // the propagation caches forget the pairs of this PHY
+  NotifyCourseChange ();
+}
+
+Vector
+YansWifiMobilitySnapshot::DoGetPosition (void) const
+{
+  double t = (Simulator::Now () - m_time).GetSeconds ();
+  return Vector (m_position.x + m_velocity.x * t,
+                 m_position.y + m_velocity.y * t,
+                 m_position.z + m_velocity.z * t);
+}
+
+void
+YansWifiMobilitySnapshot::DoSetPosition (const Vector &position)
+{
+  m_position = position;
+  m_velocity = Vector (0, 0, 0);
+  m_time = Simulator::Now ();
+  NotifyCourseChange ();
+}
+
+Vector
+YansWifiMobilitySnapshot::DoGetVelocity (void) const
+{
+  return m_velocity;
+}
+
 NS_OBJECT_ENSURE_REGISTERED (YansWifiChannel);
 
 TypeId
@@ -54,11 +149,33 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("Culling", "Skip the PHYs too far from the sender to receive a frame above CullingThreshold.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_culling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CullingThreshold", "Rx power (dBm, before the rx gain of the PHY) below which a PHY is skipped.",
+                   DoubleValue (-116.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_cullingThreshold),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("CullingCellSize", "Side (m) of the squares of the grid holding the PHYs for culling.",
+                   DoubleValue (500.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_cellSize),
+                   MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("SpectralMask", "Attenuations (dB) of the frames received 1, 2, ... channels away from the sender, "
+                   "separated by spaces.  If empty, frames do not cross channels.",
+                   StringValue (""),
+                   MakeStringAccessor (&YansWifiChannel::SetSpectralMask,
+                                       &YansWifiChannel::GetSpectralMask),
+                   MakeStringChecker ())
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_physValid (false),
+    m_physPartitioned (false),
+    m_channelsValid (false),
+    m_gridValid (false)
 {
 }
 
@@ -68,10 +185,34 @@ YansWifiChannel::~YansWifiChannel ()
   m_phyList.clear ();
 }
 
+void
+YansWifiChannel::DoDispose (void)
+{
+  for (std::map<Ptr<const MobilityModel>, std::vector<uint32_t> >::iterator i = m_mobilityPhys.begin ();
+       i != m_mobilityPhys.end (); i++)
+    {
+      ConstCast<MobilityModel> (i->first)->TraceDisconnectWithoutContext ("CourseChange",
+                                                                       MakeCallback (&YansWifiChannel::CourseChanged, this));
+    }
+  m_mobilityPhys.clear ();
+  m_phyMobility.clear ();
+  m_phyChannel.clear ();
+  m_phyContext.clear ();
+  m_phyIndex.clear ();
+  m_physValid = false;
+  m_channelPhys.clear ();
+  m_channelsValid = false;
+  m_grid.clear ();
+  m_gridValid = false;
+  m_rangesLoss = 0;
+  WifiChannel::DoDispose ();
+}
+
 void
 YansWifiChannel::SetPropagationLossModel (Ptr<PropagationLossModel> loss)
 {
   m_loss = loss;
+  m_ranges.clear ();
 }
 
 void
@@ -80,58 +221,332 @@ YansWifiChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel> delay)
   m_delay = delay;
 }
 
+void
+YansWifiChannel::SetSpectralMask (std::string mask)
+{
+  NS_LOG_FUNCTION (this << mask);
+  std::vector<double> maskDb;
+  std::istringstream is (mask);
+  double attenuationDb;
+  while (is >> attenuationDb)
+    {
+      maskDb.push_back (attenuationDb);
+    }
+  if (!is.eof ())
+    {
+      NS_FATAL_ERROR ("Invalid spectral mask \"" << mask << "\"");
+    }
+  m_spectralMask = mask;
+  m_maskDb = maskDb;
+}
+
+std::string
+YansWifiChannel::GetSpectralMask (void) const
+{
+  return m_spectralMask;
+}
+
+void
+YansWifiChannel::NotifyChannelNumberChanged (Ptr<const YansWifiPhy> phy)
+{
+  CriticalSection cs (m_mutex);
+  if (m_physValid)
+    {
+      std::map<const YansWifiPhy *, uint32_t>::const_iterator it = m_phyIndex.find (PeekPointer (phy));
+      NS_ASSERT (it != m_phyIndex.end ());
+      // in the thread of the PHY, which the senders do not touch
+      m_phyChannel[it->second] = phy->GetChannelNumber ();
+    }
+  m_channelsValid = false;
+}
+
+void
+YansWifiChannel::BuildChannels (void) const
+{
+  NS_LOG_FUNCTION (this);
+  m_channelPhys.clear ();
+  for (uint32_t j = 0; j < m_phyList.size (); j++)
+    {
+      m_channelPhys[m_phyChannel[j]].push_back (j);
+    }
+  m_channelsValid = true;
+}
+
+bool
+YansWifiChannel::IsPartitioned (void)
+{
+  return Simulator::GetContextPartition (0) != Simulator::GetContextPartition (1);
+}
+
+void
+YansWifiChannel::BuildPhys (void) const
+{
+  NS_LOG_FUNCTION (this);
+  m_physPartitioned = IsPartitioned ();
+  m_phyMobility.resize (m_phyList.size ());
+  m_phyChannel.resize (m_phyList.size ());
+  m_phyContext.resize (m_phyList.size ());
+  m_phyIndex.clear ();
+  for (std::map<Ptr<const MobilityModel>, std::vector<uint32_t> >::iterator i = m_mobilityPhys.begin ();
+       i != m_mobilityPhys.end (); i++)
+    {
+      i->second.clear ();
+    }
+  for (uint32_t j = 0; j < m_phyList.size (); j++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[j]->GetMobility ()->GetObject<MobilityModel> ();
+      NS_ASSERT (mobility != 0);
+      if (m_mobilityPhys.find (mobility) == m_mobilityPhys.end ())
+        {
+          mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&YansWifiChannel::CourseChanged, this));
+        }
+      m_mobilityPhys[mobility].push_back (j);
+      if (m_physPartitioned)
+        {
+          Ptr<YansWifiMobilitySnapshot> snapshot = CreateObject<YansWifiMobilitySnapshot> ();
+          snapshot->Update (mobility);
+          m_phyMobility[j] = snapshot;
+        }
+      else
+        {
+          m_phyMobility[j] = mobility;
+        }
+      m_phyChannel[j] = m_phyList[j]->GetChannelNumber ();
+      Ptr<Object> device = m_phyList[j]->GetDevice ();
+      m_phyContext[j] = device == 0 ? 0xffffffff : device->GetObject<NetDevice> ()->GetNode ()->GetId ();
+      m_phyIndex[PeekPointer (m_phyList[j])] = j;
+    }
+  m_physValid = true;
+  // the grid and the channels hold indexes in m_phyList
+  m_channelsValid = false;
+  m_gridValid = false;
+}
+
 void
 YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
                        WifiTxVector txVector, WifiPreamble preamble, uint8_t packetType, Time duration) const
 {
-  Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
+  // the other PHYs are only touched through the caches, without
+  // changing the reference counts of the objects of other threads
+  CriticalSection cs (m_mutex);
+  bool partitioned = IsPartitioned ();
+  if (!m_physValid || m_physPartitioned != partitioned)
+    {
+      NS_ABORT_MSG_IF (partitioned, "The PHYs of the channel changed since GetMinimumDelay, "
+                       "which must be called before Simulator::Run with several threads");
+      BuildPhys ();
+    }
+  // the snapshot of the sender, when the models see those of the receivers
+  Ptr<MobilityModel> senderMobility = m_physPartitioned ?
+    m_phyMobility[m_phyIndex.find (PeekPointer (sender))->second] : sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  // a single copy of the packet, shared by all the receptions
+  Ptr<const YansWifiFrame> frame = Create<YansWifiFrame> (packet->Copy (), txVector, preamble, packetType, duration);
+  double range = m_culling ? GetCullingRange (txPowerDbm) : std::numeric_limits<double>::infinity ();
+  if (range == std::numeric_limits<double>::infinity ())
     {
-      if (sender != (*i))
+      if (!m_channelsValid)
+        {
+          BuildChannels ();
+        }
+      uint32_t channelNumber = sender->GetChannelNumber ();
+      uint32_t low = channelNumber - std::min<uint32_t> (channelNumber, m_maskDb.size ());
+      uint32_t high = channelNumber + m_maskDb.size ();
+      m_candidates.clear ();
+      for (std::map<uint16_t, std::vector<uint32_t> >::const_iterator it = m_channelPhys.lower_bound (low);
+           it != m_channelPhys.end () && it->first <= high; it++)
         {
-          //For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
+          m_candidates.insert (m_candidates.end (), it->second.begin (), it->second.end ());
+        }
+      if (low != high)
+        {
+          // same order of receptions as over the whole PHY list
+          std::sort (m_candidates.begin (), m_candidates.end ());
+        }
+      for (std::vector<uint32_t>::const_iterator i = m_candidates.begin (); i != m_candidates.end (); i++)
+        {
+          if (m_phyList[*i] != sender)
             {
-              continue;
+              Deliver (*i, sender, senderMobility, frame, txPowerDbm);
             }
+        }
+      ScheduleReceptions (frame);
+      return;
+    }
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
+  if (!m_gridValid)
+    {
+      BuildGrid ();
+    }
+  Vector position = senderMobility->GetPosition ();
+  Cell low = GetCell (Vector (position.x - range, position.y - range, 0));
+  Cell high = GetCell (Vector (position.x + range, position.y + range, 0));
+  low.first = std::max (low.first, m_gridMin.first);
+  low.second = std::max (low.second, m_gridMin.second);
+  high.first = std::min (high.first, m_gridMax.first);
+  high.second = std::min (high.second, m_gridMax.second);
+
+  m_candidates.assign (m_moving.begin (), m_moving.end ());
+  if (low.first <= high.first && low.second <= high.second)
+    {
+      if ((high.first - low.first + 1) * (high.second - low.second + 1) <= static_cast<int64_t> (m_grid.size ()))
+        {
+          for (int64_t x = low.first; x <= high.first; x++)
             {
-              dstNode = 0xffffffff;
+              std::map<Cell, std::vector<uint32_t> >::const_iterator it = m_grid.lower_bound (Cell (x, low.second));
+              for (; it != m_grid.end () && it->first.first == x && it->first.second <= high.second; it++)
+                {
+                  m_candidates.insert (m_candidates.end (), it->second.begin (), it->second.end ());
+                }
             }
-          else
+        }
+      else
+        {
+          for (std::map<Cell, std::vector<uint32_t> >::const_iterator it = m_grid.begin (); it != m_grid.end (); it++)
             {
-              dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
+              if (it->first.first >= low.first && it->first.first <= high.first
+                  && it->first.second >= low.second && it->first.second <= high.second)
+                {
+                  m_candidates.insert (m_candidates.end (), it->second.begin (), it->second.end ());
+                }
             }
+        }
+    }
+  // same order of receptions as without culling
+  std::sort (m_candidates.begin (), m_candidates.end ());
+  NS_LOG_DEBUG ("range " << range << "m, " << m_candidates.size () << " of " << m_phyList.size () << " PHYs near the sender");
 
-          double *atts = new double[3];
-          *atts = rxPowerDbm;
-          *(atts + 1) = packetType;
-          *(atts + 2) = duration.GetNanoSeconds ();
+  for (std::vector<uint32_t>::const_iterator i = m_candidates.begin (); i != m_candidates.end (); i++)
+    {
+      if (m_phyList[*i] != sender
+          && senderMobility->GetDistanceFrom (m_phyMobility[*i]) <= range)
+        {
+          Deliver (*i, sender, senderMobility, frame, txPowerDbm);
+        }
+    }
+  ScheduleReceptions (frame);
+}
 
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive, this,
-                                          j, copy, atts, txVector, preamble);
+void
+YansWifiChannel::Deliver (uint32_t j, Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility,
+                          Ptr<const YansWifiFrame> frame, double txPowerDbm) const
+{
+  uint16_t rxChannel = m_phyChannel[j];
+  uint16_t txChannel = sender->GetChannelNumber ();
+  uint32_t distance = rxChannel > txChannel ? rxChannel - txChannel : txChannel - rxChannel;
+  double attenuationDb = 0;
+  if (distance != 0)
+    {
+      if (distance > m_maskDb.size ())
+        {
+          return;
         }
+      attenuationDb = m_maskDb[distance - 1];
     }
+
+  const Ptr<MobilityModel> &receiverMobility = m_phyMobility[j];
+  Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
+  double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility) - attenuationDb;
+  NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+
+  BatchTarget<Reception> target;
+  target.context = m_phyContext[j];
+  target.delay = delay;
+  target.arg.phy = j;
+  target.arg.rxPowerDbm = rxPowerDbm;
+  target.arg.interference = distance != 0;
+  m_receptions.push_back (target);
 }
 
 void
-YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, double *atts,
-                          WifiTxVector txVector, WifiPreamble preamble) const
+YansWifiChannel::ScheduleReceptions (Ptr<const YansWifiFrame> frame) const
 {
-  m_phyList[i]->StartReceivePreambleAndHeader (packet, *atts, txVector, preamble, *(atts + 1), NanoSeconds (*(atts + 2)));
-  delete[] atts;
+  if (m_receptions.empty ())
+    {
+      return;
+    }
+  uint32_t sender = Simulator::GetContextPartition (Simulator::GetContext ());
+  m_partitions.clear ();
+  for (std::vector<BatchTarget<Reception> >::const_iterator i = m_receptions.begin (); i != m_receptions.end (); i++)
+    {
+      uint32_t partition = Simulator::GetContextPartition (i->context);
+      if (std::find (m_partitions.begin (), m_partitions.end (), partition) == m_partitions.end ())
+        {
+          m_partitions.push_back (partition);
+        }
+    }
+  if (m_partitions.size () == 1)
+    {
+      // a single thread, or all the receivers in the same partition
+      Simulator::ScheduleWithContexts (m_receptions, &YansWifiChannel::Receive, this,
+                                       m_partitions[0] == sender ? frame : CopyFrame (frame));
+      m_receptions.clear ();
+      return;
+    }
+  for (std::vector<uint32_t>::const_iterator p = m_partitions.begin (); p != m_partitions.end (); p++)
+    {
+      m_partitionReceptions.clear ();
+      for (std::vector<BatchTarget<Reception> >::const_iterator i = m_receptions.begin (); i != m_receptions.end (); i++)
+        {
+          if (Simulator::GetContextPartition (i->context) == *p)
+            {
+              m_partitionReceptions.push_back (*i);
+            }
+        }
+      Simulator::ScheduleWithContexts (m_partitionReceptions, &YansWifiChannel::Receive, this,
+                                       *p == sender ? frame : CopyFrame (frame));
+    }
+  m_partitionReceptions.clear ();
+  m_receptions.clear ();
+}
+
+Ptr<const YansWifiFrame>
+YansWifiChannel::CopyFrame (Ptr<const YansWifiFrame> frame)
+{
+  Ptr<const Packet> packet = frame->packet;
+  uint32_t size = packet->GetSize ();
+  std::vector<uint8_t> bytes (size);
+  packet->CopyData (bytes.data (), size);
+  Ptr<Packet> copy = Create<Packet> (bytes.data (), size);
+
+  PacketTagIterator packetTags = packet->GetPacketTagIterator ();
+  while (packetTags.HasNext ())
+    {
+      PacketTagIterator::Item item = packetTags.Next ();
+      Tag *tag = dynamic_cast<Tag *> (item.GetTypeId ().GetConstructor () ());
+      NS_ASSERT (tag != 0);
+      item.GetTag (*tag);
+      copy->AddPacketTag (*tag);
+      delete tag;
+    }
+  ByteTagIterator byteTags = packet->GetByteTagIterator ();
+  while (byteTags.HasNext ())
+    {
+      ByteTagIterator::Item item = byteTags.Next ();
+      if (item.GetStart () != 0 || item.GetEnd () != size)
+        {
+          continue;
+        }
+      Tag *tag = dynamic_cast<Tag *> (item.GetTypeId ().GetConstructor () ());
+      NS_ASSERT (tag != 0);
+      item.GetTag (*tag);
+      copy->AddByteTag (*tag);
+      delete tag;
+    }
+  return Create<YansWifiFrame> (copy, frame->txVector, frame->preamble, frame->packetType, frame->duration);
+}
+
+void
+YansWifiChannel::Receive (Ptr<const YansWifiFrame> frame, Reception reception) const
+{
+  if (reception.interference)
+    {
+      m_phyList[reception.phy]->StartReceiveInterference (reception.rxPowerDbm, frame->duration);
+      return;
+    }
+  m_phyList[reception.phy]->StartReceivePreambleAndHeader (frame->packet, reception.rxPowerDbm, frame->txVector,
+                                                           frame->preamble, frame->packetType, frame->duration);
 }
 
 uint32_t
@@ -150,6 +565,9 @@ void
 YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
   m_phyList.push_back (phy);
+  m_physValid = false;
+  m_channelsValid = false;
+  m_gridValid = false;
 }
 
 void
@@ -159,6 +577,204 @@ YansWifiChannel::Remove (Ptr<YansWifiPhy> phy)
   if (it != m_phyList.end() )
     {
       m_phyList.erase (it);
+      m_physValid = false;
+      m_channelsValid = false;
+      m_gridValid = false;
+    }
+}
+
+/**
+ * \param loss a loss model
+ * \return true if the loss model and the ones chained to it are
+ * deterministic and do not increase the rx power with the distance
+ */
+static bool
+IsBoundedByDistance (Ptr<PropagationLossModel> loss)
+{
+  for (; loss != 0; loss = loss->GetNext ())
+    {
+      Ptr<CachedPropagationLossModel> cached = DynamicCast<CachedPropagationLossModel> (loss);
+      if (cached != 0)
+        {
+          if (!IsBoundedByDistance (cached->GetModel ()))
+            {
+              return false;
+            }
+          continue;
+        }
+      if (DynamicCast<FriisPropagationLossModel> (loss) == 0
+          && DynamicCast<LogDistancePropagationLossModel> (loss) == 0
+          && DynamicCast<ThreeLogDistancePropagationLossModel> (loss) == 0
+          && DynamicCast<RangePropagationLossModel> (loss) == 0)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+double
+YansWifiChannel::GetCullingRange (double txPowerDbm) const
+{
+  if (m_rangesLoss != m_loss)
+    {
+      m_ranges.clear ();
+      m_rangesLoss = m_loss;
+    }
+  std::map<double, double>::const_iterator it = m_ranges.find (txPowerDbm);
+  if (it != m_ranges.end ())
+    {
+      return it->second;
+    }
+
+  double range = std::numeric_limits<double>::infinity ();
+  if (IsBoundedByDistance (m_loss))
+    {
+      Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+      Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+      // the rx power is at least the threshold up to near, below it beyond far
+      double near = 0;
+      double far = 1;
+      b->SetPosition (Vector (far, 0, 0));
+      while (far < 1e9 && m_loss->CalcRxPower (txPowerDbm, a, b) >= m_cullingThreshold)
+        {
+          near = far;
+          far *= 2;
+          b->SetPosition (Vector (far, 0, 0));
+        }
+      if (far < 1e9)
+        {
+          while (far - near > 0.01)
+            {
+              double middle = (near + far) / 2;
+              b->SetPosition (Vector (middle, 0, 0));
+              if (m_loss->CalcRxPower (txPowerDbm, a, b) >= m_cullingThreshold)
+                {
+                  near = middle;
+                }
+              else
+                {
+                  far = middle;
+                }
+            }
+          range = far;
+        }
+    }
+  else
+    {
+      NS_LOG_WARN ("the loss model does not bound the range, no culling");
+    }
+  NS_LOG_DEBUG ("culling range for " << txPowerDbm << "dBm: " << range << "m");
+  m_ranges[txPowerDbm] = range;
+  return range;
+}
+
+Time
+YansWifiChannel::GetMinimumDelay (void) const
+{
+  CriticalSection cs (m_mutex);
+  BuildPhys ();
+  Time delay = Time::Max ();
+  for (uint32_t i = 0; i < m_phyList.size (); i++)
+    {
+      for (uint32_t j = i + 1; j < m_phyList.size (); j++)
+        {
+          if (m_phyContext[i] != 0xffffffff && m_phyContext[i] == m_phyContext[j])
+            {
+              // the receptions on the same node stay on its partition
+              continue;
+            }
+          delay = std::min (delay, m_delay->GetDelay (m_phyMobility[i], m_phyMobility[j]));
+        }
+    }
+  return delay;
+}
+
+YansWifiChannel::Cell
+YansWifiChannel::GetCell (const Vector &position) const
+{
+  return Cell (static_cast<int64_t> (std::floor (position.x / m_cellSize)),
+               static_cast<int64_t> (std::floor (position.y / m_cellSize)));
+}
+
+void
+YansWifiChannel::BuildGrid (void) const
+{
+  NS_LOG_FUNCTION (this);
+  m_grid.clear ();
+  m_moving.clear ();
+  m_phyCell.assign (m_phyList.size (), Cell ());
+  m_phyMoving.assign (m_phyList.size (), false);
+  m_gridMin = Cell (std::numeric_limits<int64_t>::max (), std::numeric_limits<int64_t>::max ());
+  m_gridMax = Cell (std::numeric_limits<int64_t>::min (), std::numeric_limits<int64_t>::min ());
+  for (uint32_t j = 0; j < m_phyList.size (); j++)
+    {
+      Place (j, m_phyMobility[j]);
+    }
+  m_gridValid = true;
+}
+
+void
+YansWifiChannel::Place (uint32_t j, Ptr<const MobilityModel> mobility) const
+{
+  Vector velocity = mobility->GetVelocity ();
+  if (velocity.x != 0 || velocity.y != 0 || velocity.z != 0)
+    {
+      m_phyMoving[j] = true;
+      m_moving.push_back (j);
+      return;
+    }
+  Cell cell = GetCell (mobility->GetPosition ());
+  m_phyMoving[j] = false;
+  m_phyCell[j] = cell;
+  m_grid[cell].push_back (j);
+  m_gridMin.first = std::min (m_gridMin.first, cell.first);
+  m_gridMin.second = std::min (m_gridMin.second, cell.second);
+  m_gridMax.first = std::max (m_gridMax.first, cell.first);
+  m_gridMax.second = std::max (m_gridMax.second, cell.second);
+}
+
+void
+YansWifiChannel::Unplace (uint32_t j) const
+{
+  if (m_phyMoving[j])
+    {
+      m_moving.erase (std::find (m_moving.begin (), m_moving.end (), j));
+      return;
+    }
+  std::vector<uint32_t> &phys = m_grid[m_phyCell[j]];
+  phys.erase (std::find (phys.begin (), phys.end (), j));
+  if (phys.empty ())
+    {
+      m_grid.erase (m_phyCell[j]);
+    }
+}
+
+void
+YansWifiChannel::CourseChanged (Ptr<const MobilityModel> mobility) const
+{
+  CriticalSection cs (m_mutex);
+  if (!m_physValid)
+    {
+      return;
+    }
+  std::map<Ptr<const MobilityModel>, std::vector<uint32_t> >::const_iterator it = m_mobilityPhys.find (mobility);
+  if (it == m_mobilityPhys.end ())
+    {
+      return;
+    }
+  for (std::vector<uint32_t>::const_iterator j = it->second.begin (); j != it->second.end (); j++)
+    {
+      if (m_physPartitioned)
+        {
+          // in the thread of the node, which the senders do not touch
+          static_cast<YansWifiMobilitySnapshot *> (PeekPointer (m_phyMobility[*j]))->Update (mobility);
+        }
+      if (m_gridValid)
+        {
+          Unplace (*j);
+          Place (*j, m_phyMobility[*j]);
+        }
     }
 }
 
@@ -22,21 +22,54 @@
 #define YANS_WIFI_CHANNEL_H
 
 #include <vector>
+#include <map>
+#include <string>
 #include <stdint.h>
 #include "ns3/packet.h"
+#include "ns3/simple-ref-count.h"
 #include "wifi-channel.h"
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
 #include "wifi-tx-vector.h"
 #include "ns3/nstime.h"
+#include "ns3/batch-event.h"
+#include "ns3/vector.h"
+#include "ns3/system-mutex.h"
 
 namespace ns3 {
 
 class NetDevice;
+class MobilityModel;
 class PropagationLossModel;
 class PropagationDelayModel;
 class YansWifiPhy;
 
+/**
+ * \ingroup wifi
+ *
+ * A frame sent on a YansWifiChannel.  A single frame is shared by the
+ * receptions scheduled for all the receiving PHYs of a simulation
+ * partition, which only get their rx power on their own.
+ */
+struct YansWifiFrame : public SimpleRefCount<YansWifiFrame>
+{
+  /**
+   * \param packet the packet, not modified afterwards
+   * \param txVector the TXVECTOR of the packet
+   * \param preamble the preamble of the packet
+   * \param packetType the type of packet, used for A-MPDU
+   * \param duration the transmission duration of the packet
+   */
+  YansWifiFrame (Ptr<const Packet> packet, WifiTxVector txVector, WifiPreamble preamble,
+                 uint8_t packetType, Time duration);
+
+  Ptr<const Packet> packet;  //!< the packet
+  WifiTxVector txVector;     //!< the TXVECTOR of the packet
+  WifiPreamble preamble;     //!< the preamble of the packet
+  uint8_t packetType;        //!< the type of packet
+  Time duration;             //!< the transmission duration of the packet
+};
+
 /**
  * \brief A Yans wifi channel
  * \ingroup wifi
@@ -48,6 +81,40 @@ class YansWifiPhy;
  * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
  * By default, no propagation models are set so, it is the caller's responsability
  * to set them before using the channel.
+ *
+ * With the Culling attribute, Send skips the PHYs farther from the sender
+ * than the distance at which the loss model brings the transmit power
+ * below CullingThreshold, without scheduling a reception for them.  The
+ * PHYs are kept in a grid of CullingCellSize squares, updated from the
+ * CourseChange trace of their mobility models; PHYs that move at a
+ * constant velocity are checked on every frame.  The distance is only
+ * derived for a chain of deterministic loss models that decrease with the
+ * distance alone (Friis, LogDistance, ThreeLogDistance, Range); with other
+ * models every PHY receives every frame, as without culling.  A skipped
+ * frame does not add to the interference at the PHY either, so the
+ * threshold should be well below the noise floor of the receivers (minus
+ * their RxGain).
+ *
+ * The PHYs are also kept by channel number, so that a frame only visits
+ * the PHYs of the channel of the sender.  With the SpectralMask attribute,
+ * the PHYs up to as many channels away as the mask has entries get the
+ * frame too, attenuated by the entry for their distance in channel
+ * numbers, as interference only.
+ *
+ * With MultiThreadedSimulatorImpl, the frames are sent under a lock, and
+ * the PHYs of each partition (see Simulator::GetContextPartition) share
+ * their own copy of the frame, which does not share any memory with the
+ * packets of the sender: the copy has a new uid, and keeps the packet
+ * tags and the byte tags which cover the whole packet only.  The loss
+ * and delay models are only used under the lock, in the thread of the
+ * sender, so the random loss models give results which depend on the
+ * order in which the threads send.  They do not see the mobility models
+ * of the PHYs, which belong to the threads of their nodes, but a snapshot
+ * of their position and velocity, taken by GetMinimumDelay and updated
+ * from their CourseChange trace: GetMinimumDelay must thus be called
+ * once the PHYs are in place, before Simulator::Run.  Within a window of
+ * the simulator, a node may see the course change of another one up to
+ * the Lookahead early.
  */
 class YansWifiChannel : public WifiChannel
 {
@@ -76,6 +143,24 @@ public:
    */
   void Remove (Ptr<YansWifiPhy> phy);
 
+  /**
+   * To be called by the PHYs when their channel number changes.
+   *
+   * \param phy the YansWifiPhy whose channel number changed
+   */
+  void NotifyChannelNumberChanged (Ptr<const YansWifiPhy> phy);
+
+  /**
+   * \param mask the attenuations (dB) of the frames received 1, 2, ...
+   * channels away from the sender, separated by spaces
+   */
+  void SetSpectralMask (std::string mask);
+  /**
+   * \return the attenuations (dB) of the frames received on the nearby
+   * channels
+   */
+  std::string GetSpectralMask (void) const;
+
   /**
    * \param loss the new propagation loss model.
    */
@@ -97,7 +182,8 @@ public:
    * This method should not be invoked by normal users. It is
    * currently invoked only from WifiPhy::Send. YansWifiChannel
    * delivers packets only between PHYs with the same m_channelNumber,
-   * e.g. PHYs that are operating on the same channel.
+   * e.g. PHYs that are operating on the same channel; the PHYs on the
+   * channels covered by the spectral mask only get interference.
    */
   void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
              WifiTxVector txVector, WifiPreamble preamble, uint8_t packetType, Time duration) const;
@@ -113,30 +199,157 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \param txPowerDbm the tx power
+   * \return the distance beyond which a frame sent with this power arrives
+   * below CullingThreshold, infinite if the loss model does not bound it
+   */
+  double GetCullingRange (double txPowerDbm) const;
+
+  /**
+   * The smallest propagation delay between the PHYs of different nodes,
+   * at their current positions: the lookahead of the events this
+   * channel schedules from one node to another, e.g. for the Lookahead
+   * attribute of MultiThreadedSimulatorImpl.  With several partitions,
+   * this also takes the snapshot of the PHYs which the frames are sent
+   * with, so it must be called before Simulator::Run.
+   *
+   * \return the smallest delay, Time::Max () with less than two nodes
+   */
+  Time GetMinimumDelay (void) const;
+
 
 private:
+  virtual void DoDispose (void);
+
   /**
    * A vector of pointers to YansWifiPhy.
    */
   typedef std::vector<Ptr<YansWifiPhy> > PhyList;
+  /// The reception of a frame by one PHY
+  struct Reception
+  {
+    uint32_t phy;       //!< index of the YansWifiPhy in the PHY list
+    double rxPowerDbm;  //!< the received power in dBm
+    bool interference;  //!< the frame was sent on another channel
+  };
   /**
    * This method is scheduled by Send for each associated YansWifiPhy.
    * The method then calls the corresponding YansWifiPhy that the first
    * bit of the packet has arrived.
    *
-   * \param i index of the corresponding YansWifiPhy in the PHY list
-   * \param packet the packet being sent
-   * \param atts a vector containing the received power in dBm and the packet type
-   * \param txVector the TXVECTOR of the packet
-   * \param preamble the type of preamble being used to send the packet
+   * \param frame the frame being sent
+   * \param reception the receiving PHY and its rx power
+   */
+  void Receive (Ptr<const YansWifiFrame> frame, Reception reception) const;
+  /**
+   * Add the reception of a frame by one PHY to m_receptions, if it is on
+   * the channel of the sender or close enough for the spectral mask.
+   *
+   * \param j index of the receiving YansWifiPhy in the PHY list
+   * \param sender the sending YansWifiPhy
+   * \param senderMobility the mobility model of the sender, or its snapshot
+   * \param frame the frame being sent
+   * \param txPowerDbm the tx power associated to the frame
+   */
+  void Deliver (uint32_t j, Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility,
+                Ptr<const YansWifiFrame> frame, double txPowerDbm) const;
+  /**
+   * Schedule all the receptions in m_receptions in a single operation.
+   *
+   * \param frame the frame being sent
+   */
+  void ScheduleReceptions (Ptr<const YansWifiFrame> frame) const;
+  /**
+   * Copy a frame for the PHYs of another partition than the sender.
+   *
+   * \param frame the frame being sent
+   * \return a copy of the frame, with a packet made from its bytes and
+   * tags
+   */
+  static Ptr<const YansWifiFrame> CopyFrame (Ptr<const YansWifiFrame> frame);
+
+  /// Put all PHYs into m_channelPhys
+  void BuildChannels (void) const;
+  /// Keep the mobility model, the channel number and the context of all PHYs
+  void BuildPhys (void) const;
+  /**
+   * \return true if the contexts are run by more than one partition
    */
-  void Receive (uint32_t i, Ptr<Packet> packet, double *atts,
-                WifiTxVector txVector, WifiPreamble preamble) const;
+  static bool IsPartitioned (void);
+
+  /// A cell of the culling grid
+  typedef std::pair<int64_t, int64_t> Cell;
+
+  /**
+   * \param position a position
+   * \return the grid cell of the position
+   */
+  Cell GetCell (const Vector &position) const;
+  /// Put all PHYs into the culling grid
+  void BuildGrid (void) const;
+  /**
+   * Put one PHY into the culling grid, or into the list of moving PHYs.
+   *
+   * \param j index of the PHY
+   * \param mobility its mobility model
+   */
+  void Place (uint32_t j, Ptr<const MobilityModel> mobility) const;
+  /**
+   * Take one PHY out of the culling grid or of the list of moving PHYs.
+   *
+   * \param j index of the PHY
+   */
+  void Unplace (uint32_t j) const;
+  /**
+   * Update the snapshot of the PHYs of a mobility model, and move them to
+   * their new cell.
+   *
+   * \param mobility the mobility model
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility) const;
 
 
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+
+  bool m_culling;                      //!< skip the PHYs out of range
+  double m_cullingThreshold;           //!< rx power below which a PHY is skipped (dBm)
+  double m_cellSize;                   //!< side of a grid cell (m)
+  std::string m_spectralMask;          //!< attenuations of the nearby channels, as set
+  std::vector<double> m_maskDb;        //!< attenuation (dB) by distance in channel numbers, from 1
+
+  mutable SystemMutex m_mutex;                       //!< held while sending a frame
+
+  mutable bool m_physValid;                          //!< the m_phy* vectors hold the PHYs of m_phyList
+  mutable bool m_physPartitioned;                    //!< m_phyMobility holds snapshots, for several partitions
+  /// mobility model of each PHY, or the snapshot of it
+  mutable std::vector<Ptr<MobilityModel> > m_phyMobility;
+  mutable std::vector<uint16_t> m_phyChannel;        //!< channel number of each PHY
+  mutable std::vector<uint32_t> m_phyContext;        //!< context (node) of each PHY
+  mutable std::map<const YansWifiPhy *, uint32_t> m_phyIndex; //!< index of each PHY in m_phyList
+  /// PHYs of each mobility model, whose CourseChange trace is connected
+  mutable std::map<Ptr<const MobilityModel>, std::vector<uint32_t> > m_mobilityPhys;
+
+  mutable bool m_channelsValid;                      //!< m_channelPhys holds the PHYs of m_phyList
+  mutable std::map<uint16_t, std::vector<uint32_t> > m_channelPhys; //!< PHYs by channel number
+
+  mutable bool m_gridValid;                          //!< the grid holds the PHYs of m_phyList
+  mutable std::map<Cell, std::vector<uint32_t> > m_grid; //!< PHYs at rest, by cell
+  mutable std::vector<Cell> m_phyCell;               //!< cell of each PHY at rest
+  mutable std::vector<bool> m_phyMoving;             //!< whether each PHY moves
+  mutable std::vector<uint32_t> m_moving;            //!< moving PHYs
+  mutable Cell m_gridMin;                            //!< lowest cell in use
+  mutable Cell m_gridMax;                            //!< highest cell in use
+  mutable std::map<double, double> m_ranges;         //!< culling range by tx power
+  mutable Ptr<PropagationLossModel> m_rangesLoss;    //!< loss model of m_ranges
+  mutable std::vector<uint32_t> m_candidates;        //!< PHYs near the sender
+  /// receptions of the frame being sent, all scheduled at once
+  mutable std::vector<BatchTarget<Reception> > m_receptions;
+  /// receptions of the frame being sent by the PHYs of one partition
+  mutable std::vector<BatchTarget<Reception> > m_partitionReceptions;
+  mutable std::vector<uint32_t> m_partitions;        //!< partitions of the receptions of the frame being sent
 };
 
 } //namespace ns3
@@ -44,6 +44,9 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("YansWifiPhy");
 
+/// Marks the modes whose MCS is not known yet
+static const uint32_t NO_MCS = 0xffffffff;
+
 NS_OBJECT_ENSURE_REGISTERED (YansWifiPhy);
 
 TypeId
@@ -470,6 +473,10 @@ YansWifiPhy::SetChannelNumber (uint16_t nch)
       //this is not channel switch, this is initialization
       NS_LOG_DEBUG ("start at channel " << nch);
       m_channelNumber = nch;
+      if (m_channel != 0)
+        {
+          m_channel->NotifyChannelNumberChanged (this);
+        }
       return;
     }
 
@@ -515,6 +522,10 @@ switchChannel:
    * out the state of the medium after the switching.
    */
   m_channelNumber = nch;
+  if (m_channel != 0)
+    {
+      m_channel->NotifyChannelNumberChanged (this);
+    }
 }
 
 uint16_t
@@ -610,7 +621,24 @@ YansWifiPhy::SetReceiveErrorCallback (RxErrorCallback callback)
 }
 
 void
-YansWifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet,
+YansWifiPhy::StartReceiveInterference (double rxPowerDbm, Time rxDuration)
+{
+  NS_LOG_FUNCTION (this << rxPowerDbm << rxDuration);
+  rxPowerDbm += m_rxGainDb;
+  m_interference.AddInterference (rxDuration, DbmToW (rxPowerDbm));
+  if (m_state->IsStateSleep ())
+    {
+      return;
+    }
+  Time delayUntilCcaEnd = m_interference.GetEnergyDuration (m_ccaMode1ThresholdW);
+  if (!delayUntilCcaEnd.IsZero ())
+    {
+      m_state->SwitchMaybeToCcaBusy (delayUntilCcaEnd);
+    }
+}
+
+void
+YansWifiPhy::StartReceivePreambleAndHeader (Ptr<const Packet> packet,
                                             double rxPowerDbm,
                                             WifiTxVector txVector,
                                             enum WifiPreamble preamble,
@@ -627,19 +655,17 @@ YansWifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet,
   Time preambleAndHeaderDuration = CalculatePlcpPreambleAndHeaderDuration (txVector, preamble);
   
 
+  //The frames which cannot be received are added as interference only,
+  //without an event.
   Ptr<InterferenceHelper::Event> event;
-  event = m_interference.Add (packet->GetSize (),
-                              txVector,
-                              preamble,
-                              rxDuration,
-                              rxPowerW);
-  double sinrAtTime = m_interference.CalculateSinrAtTime (event, Simulator::Now());
-  WifiMode plcpHeaderMode = WifiPhy::GetPlcpHeaderMode(event->GetPayloadMode(), preamble);
+  double sinrAtTime = 0;
+  WifiMode plcpHeaderMode = WifiPhy::GetPlcpHeaderMode (txVector.GetMode (), preamble);
   Time currentStage = Seconds (0);
 
   switch (m_state->GetState ())
     {
     case YansWifiPhy::SWITCHING:
+      m_interference.AddInterference (rxDuration, rxPowerW);
       NS_LOG_DEBUG ("drop packet because of channel switching");
       NotifyRxDrop (packet);
       m_plcpSuccess = false;
@@ -660,6 +686,12 @@ YansWifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet,
       break;
     case YansWifiPhy::RX:
       {
+        event = m_interference.Add (packet->GetSize (),
+                                    txVector,
+                                    preamble,
+                                    rxDuration,
+                                    rxPowerW);
+        sinrAtTime = m_interference.CalculateSinrAtTime (event, Simulator::Now ());
         NS_ASSERT (m_rxPacketEvent != NULL);
         currentStage = Simulator::Now () - m_rxPacketEvent->GetStartTime();
         //double oldsinr = m_interference.CalculateSinrAtTime (m_rxPacketEvent, Simulator::Now());
@@ -822,6 +854,7 @@ YansWifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet,
     	break;
   	}       
     case YansWifiPhy::TX:
+      m_interference.AddInterference (rxDuration, rxPowerW);
       NS_LOG_DEBUG ("drop packet because already in Tx (power=" <<
                     rxPowerW << "W)");
       NotifyRxDrop (packet);
@@ -837,6 +870,11 @@ YansWifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet,
             
       if (rxPowerW > m_edThresholdW) //checked here, no need to check in the payload reception (current implementation assumes constant rx power over the packet duration)
         {
+          event = m_interference.Add (packet->GetSize (),
+                                      txVector,
+                                      preamble,
+                                      rxDuration,
+                                      rxPowerW);
           if (preamble == WIFI_PREAMBLE_NONE && m_mpdusNum == 0)
             {
               NS_LOG_DEBUG ("drop packet because no preamble has been received");
@@ -896,6 +934,7 @@ YansWifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet,
         }
       else
         {
+          m_interference.AddInterference (rxDuration, rxPowerW);
           NS_LOG_DEBUG ("drop packet because signal power too Small (" << rxPowerW << "<" << m_edThresholdW << ")");
           NotifyRxDrop (packet);
           m_plcpSuccess = false;
@@ -903,6 +942,7 @@ YansWifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet,
         }
       break;
     case YansWifiPhy::SLEEP:
+      m_interference.AddInterference (rxDuration, rxPowerW);
       NS_LOG_DEBUG ("drop packet because in sleep mode");
       NotifyRxDrop (packet);
       m_plcpSuccess = false;
@@ -941,7 +981,7 @@ maybeCcaBusy:
 }
 
 void
-YansWifiPhy::StartReceivePacket (Ptr<Packet> packet,
+YansWifiPhy::StartReceivePacket (Ptr<const Packet> packet,
                                  WifiTxVector txVector,
                                  enum WifiPreamble preamble,
                                  uint8_t packetType,
@@ -1383,7 +1423,7 @@ YansWifiPhy::GetPowerDbm (uint8_t power) const
 }
 
 void
-YansWifiPhy::EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, uint8_t packetType, Ptr<InterferenceHelper::Event> event)
+YansWifiPhy::EndReceive (Ptr<const Packet> packet, enum WifiPreamble preamble, uint8_t packetType, Ptr<InterferenceHelper::Event> event)
 {
   NS_LOG_FUNCTION (this << packet << event);
   NS_ASSERT (IsStateRx ());
@@ -1420,7 +1460,8 @@ YansWifiPhy::EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, uint8_t
           double signalDbm = RatioToDb (event->GetRxPowerW ()) + 30;
           double noiseDbm = RatioToDb (event->GetRxPowerW () / snrPer.snr) - GetRxNoiseFigure () + 30;
           NotifyMonitorSniffRx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, isShortPreamble, event->GetTxVector (), signalDbm, noiseDbm);
-          m_state->SwitchFromRxEndOk (packet, snrPer.snr, event->GetTxVector (), event->GetPreambleType ());
+          // the MAC removes the headers, the other receivers share the packet
+          m_state->SwitchFromRxEndOk (packet->Copy (), snrPer.snr, event->GetTxVector (), event->GetPreambleType ());
           //std::cout<<Simulator::Now()<<" packetId= "<<packet->GetUid()<<" payloadSinr= "<< RatioToDb (snrPer.snr)  <<" psr= "<< 1.0 - snrPer.per<<std::endl;
         }
       else
@@ -1652,6 +1693,23 @@ YansWifiPhy::GetMcs (uint8_t mcs) const
 
 uint32_t
 YansWifiPhy::WifiModeToMcs (WifiMode mode)
+{
+  // the name comparisons below allocate strings, and the MCS is needed
+  // for every frame sent and received
+  uint32_t uid = mode.GetUid ();
+  if (uid >= m_modeMcs.size ())
+    {
+      m_modeMcs.resize (uid + 1, NO_MCS);
+    }
+  if (m_modeMcs[uid] == NO_MCS)
+    {
+      m_modeMcs[uid] = DoWifiModeToMcs (mode);
+    }
+  return m_modeMcs[uid];
+}
+
+uint32_t
+YansWifiPhy::DoWifiModeToMcs (WifiMode mode) const
 {
     uint32_t mcs = 0;
     if (mode.GetUniqueName() == "OfdmRate5_85MbpsBW16MHz" || mode.GetUniqueName() == "OfdmRate6_5MbpsBW16MHz" )
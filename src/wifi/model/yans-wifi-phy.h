@@ -99,9 +99,20 @@ public:
    */
   double GetChannelFrequencyMhz () const;
 
+  /**
+   * The first bit of a frame sent on another channel has arrived, its
+   * leakage into this channel only adds to the interference.
+   *
+   * \param rxPowerDbm the receive power in dBm, after the spectral mask
+   * \param rxDuration the duration of the frame
+   */
+  void StartReceiveInterference (double rxPowerDbm, Time rxDuration);
   /**
    * Starting receiving the plcp of a packet (i.e. the first bit of the preamble has arrived).
    *
+   * The packet is shared by all the PHYs receiving the frame and is only
+   * copied when it is passed up to the MAC.
+   *
    * \param packet the arriving packet
    * \param rxPowerDbm the receive power in dBm
    * \param txVector the TXVECTOR of the arriving packet
@@ -109,7 +120,7 @@ public:
    * \param packetType The type of the received packet (values: 0 not an A-MPDU, 1 corresponds to any packets in an A-MPDU except the last one, 2 is the last packet in an A-MPDU)
    * \param rxDuration the duration needed for the reception of the packet
    */
-  void StartReceivePreambleAndHeader (Ptr<Packet> packet,
+  void StartReceivePreambleAndHeader (Ptr<const Packet> packet,
                                       double rxPowerDbm,
                                       WifiTxVector txVector,
                                       WifiPreamble preamble,
@@ -124,7 +135,7 @@ public:
    * \param packetType The type of the received packet (values: 0 not an A-MPDU, 1 corresponds to any packets in an A-MPDU except the last one, 2 is the last packet in an A-MPDU)
    * \param event the corresponding event of the first time the packet arrives
    */
-  void StartReceivePacket (Ptr<Packet> packet,
+  void StartReceivePacket (Ptr<const Packet> packet,
                            WifiTxVector txVector,
                            WifiPreamble preamble,
                            uint8_t packetType,
@@ -439,6 +450,12 @@ virtual void SetChannelWidth (uint32_t channelwidth) ;
 private:
   virtual void DoInitialize (void);
   virtual void DoDispose (void);
+  /**
+   * \param mode a Wi-Fi mode
+   *
+   * \return the MCS of the mode, from its name or data rate
+   */
+  uint32_t DoWifiModeToMcs (WifiMode mode) const;
 
   /**
    * Configure YansWifiPhy with appropriate channel frequency and
@@ -531,7 +548,7 @@ void Configure80211ah (void);
    * \param packetType The type of the received packet (values: 0 not an A-MPDU, 1 corresponds to any packets in an A-MPDU except the last one, 2 is the last packet in an A-MPDU)
    * \param event the corresponding event of the first time the packet arrives
    */
-  void EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, uint8_t packetType, Ptr<InterferenceHelper::Event> event);
+  void EndReceive (Ptr<const Packet> packet, enum WifiPreamble preamble, uint8_t packetType, Ptr<InterferenceHelper::Event> event);
 
   bool     m_initialized;         //!< Flag for runtime initialization
   double   m_edThresholdW;        //!< Energy detection threshold in watts
@@ -599,6 +616,7 @@ void Configure80211ah (void);
 
   std::vector<uint32_t> m_bssMembershipSelectorSet;
   std::vector<uint8_t> m_deviceMcsSet;
+  std::vector<uint32_t> m_modeMcs;      //!< MCS of each mode, by uid, once computed
   EventId m_endRxEvent;
   EventId m_endPlcpRxEvent;
 
@@ -610,7 +628,7 @@ void Configure80211ah (void);
   uint16_t m_mpdusNum;                  //!< carries the number of expected mpdus that are part of an A-MPDU
   bool m_plcpSuccess;                   //!< Flag if the PLCP of the packet or the first MPDU in an A-MPDU has been received
 
-  Ptr<Packet> m_rxPacket;
+  Ptr<const Packet> m_rxPacket;
   Ptr<InterferenceHelper::Event> m_rxPacketEvent;
   bool m_doDataCapture;
   bool m_doPreambleCapture;
@@ -690,6 +690,36 @@ DcfManagerTest::DoRun (void)
   AddSwitchingEvt (80,20);
   AddAccessRequest (101, 2, 110, 0);
   EndTest ();
+
+  // Four DCFs with pending grants, a busy period in the middle of a
+  // backoff and an internal collision: every pass over the states uses
+  // the same access grant start.
+  //
+  //  20    60     66        78     83    89          99    103   109         121    126  132         156    161  167         199
+  //   | rx  | sifs |        |  tx1  | sifs |          | busy  | sifs |         |  tx0  | sifs |        |  tx2  | sifs |         | tx3
+  //
+  // DCF0 (aifsn 1): backoff 70..78 (2 slots), 93..97 (1 slot), 113..121 (2 slots)
+  // DCF1 (aifsn 2): backoff 74..78 (1 slot)
+  // DCF2 (aifsn 3): backoff 144..156 (3 slots)
+  // DCF3 (aifsn 6): backoff 0 slots ends at 156 with DCF2, internal collision,
+  //                 then 191..199 (2 slots)
+  StartTest (4, 6, 10);
+  AddDcfState (1);
+  AddDcfState (2);
+  AddDcfState (3);
+  AddDcfState (6);
+  AddRxOkEvt (20, 40);
+  AddAccessRequest (30, 5, 156, 2);
+  ExpectCollision (30, 3, 2); //backoff: 3 slots
+  AddAccessRequest (35, 5, 78, 1);
+  ExpectCollision (35, 1, 1); //backoff: 1 slot
+  AddAccessRequest (40, 5, 199, 3);
+  ExpectCollision (40, 0, 3); //backoff: 0 slots
+  AddAccessRequest (45, 5, 121, 0);
+  ExpectCollision (45, 5, 0); //backoff: 5 slots
+  AddCcaBusyEvt (99, 4);
+  ExpectInternalCollision (156, 2, 3); //backoff: 2 slots
+  EndTest ();
 }
 
 
@@ -0,0 +1,471 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/error-rate-model.h"
+#include "ns3/interference-helper.h"
+#include "ns3/wifi-phy.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("InterferenceHelperTest");
+
+/**
+ * An error rate model which keeps the chunks it is asked about, and
+ * gives each of them the same success rate.
+ */
+class ChunkRecordingErrorRateModel : public ErrorRateModel
+{
+public:
+  /// The SNR and the number of bits of a chunk
+  typedef std::pair<double, uint32_t> Chunk;
+
+  virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+  {
+    m_chunks.push_back (Chunk (snr, nbits));
+    return 0.9;
+  }
+
+  /// The chunks asked about since the last clear
+  mutable std::vector<Chunk> m_chunks;
+};
+
+/// The 802.11a mode of the events
+static WifiMode
+GetTestMode (void)
+{
+  return WifiPhy::GetOfdmRate6Mbps ();
+}
+
+/// The TXVECTOR of the events
+static WifiTxVector
+GetTestTxVector (void)
+{
+  WifiTxVector txVector;
+  txVector.SetMode (GetTestMode ());
+  txVector.SetNss (1);
+  return txVector;
+}
+
+/// The thermal noise over 20 MHz (W), with a noise figure of 1
+static const double NOISE_W = 1.3803e-23 * 290.0 * 20e6;
+
+/**
+ * \param duration the duration of a chunk
+ * \return its number of bits at the 12 Mbps coded rate of the mode,
+ *         truncated as InterferenceHelper does
+ */
+static uint32_t
+GetBits (Time duration)
+{
+  return (uint32_t)(GetTestMode ().GetPhyRate () * duration.GetSeconds ());
+}
+
+/**
+ * Check the SINR of the chunks of the payload, the SINR at a time and the
+ * energy duration against values computed by hand, on overlapping
+ * signals and after the oldest changes were forgotten.
+ */
+class InterferenceHelperTestCase : public TestCase
+{
+public:
+  InterferenceHelperTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Receive a frame.
+   * \param duration the duration of the frame
+   * \param powerW its rx power
+   * \param event set to the new event
+   */
+  void AddEvent (Time duration, double powerW, Ptr<InterferenceHelper::Event> *event);
+  /**
+   * Receive a signal which is not a frame.
+   * \param duration the duration of the signal
+   * \param powerW its rx power
+   */
+  void AddInterference (Time duration, double powerW);
+  /**
+   * Check the payload of an event.
+   * \param event the event
+   * \param snr the expected SNR at the start of the event
+   * \param chunks the expected chunks of its payload
+   */
+  void CheckPayload (Ptr<InterferenceHelper::Event> *event, double snr,
+                     std::vector<ChunkRecordingErrorRateModel::Chunk> chunks);
+  /**
+   * Check the SINR of an event at the current time.
+   * \param event the event
+   * \param sinr the expected SINR
+   */
+  void CheckSinr (Ptr<InterferenceHelper::Event> *event, double sinr);
+  /**
+   * Check the time until the power of the signals drops below a threshold.
+   * \param energyW the threshold
+   * \param duration the expected duration
+   */
+  void CheckEnergyDuration (double energyW, Time duration);
+
+  InterferenceHelper m_interference;
+  Ptr<ChunkRecordingErrorRateModel> m_model;
+};
+
+InterferenceHelperTestCase::InterferenceHelperTestCase ()
+  : TestCase ("Check the interference of overlapping signals against hand-computed values")
+{
+}
+
+void
+InterferenceHelperTestCase::AddEvent (Time duration, double powerW, Ptr<InterferenceHelper::Event> *event)
+{
+  *event = m_interference.Add (1000, GetTestTxVector (), WIFI_PREAMBLE_LONG, duration, powerW);
+}
+
+void
+InterferenceHelperTestCase::AddInterference (Time duration, double powerW)
+{
+  m_interference.AddInterference (duration, powerW);
+}
+
+void
+InterferenceHelperTestCase::CheckPayload (Ptr<InterferenceHelper::Event> *event, double snr,
+                                          std::vector<ChunkRecordingErrorRateModel::Chunk> chunks)
+{
+  m_model->m_chunks.clear ();
+  struct InterferenceHelper::SnrPer snrPer = m_interference.CalculatePlcpPayloadSnrPer (*event);
+  NS_TEST_EXPECT_MSG_EQ_TOL (snrPer.snr, snr, snr * 1e-12, "Wrong SNR at " << Simulator::Now ());
+  NS_TEST_ASSERT_MSG_EQ (m_model->m_chunks.size (), chunks.size (), "Wrong number of chunks at " << Simulator::Now ());
+  double psr = 1.0;
+  for (uint32_t i = 0; i < chunks.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (m_model->m_chunks[i].first, chunks[i].first, chunks[i].first * 1e-12,
+                                 "Wrong SNR of chunk " << i << " at " << Simulator::Now ());
+      NS_TEST_EXPECT_MSG_EQ (m_model->m_chunks[i].second, chunks[i].second,
+                             "Wrong size of chunk " << i << " at " << Simulator::Now ());
+      psr *= 0.9;
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (snrPer.per, 1 - psr, 1e-12, "Wrong PER at " << Simulator::Now ());
+}
+
+void
+InterferenceHelperTestCase::CheckSinr (Ptr<InterferenceHelper::Event> *event, double sinr)
+{
+  double actual = m_interference.CalculateSinrAtTime (*event, Simulator::Now ());
+  NS_TEST_EXPECT_MSG_EQ_TOL (actual, sinr, sinr * 1e-12, "Wrong SINR at " << Simulator::Now ());
+}
+
+void
+InterferenceHelperTestCase::CheckEnergyDuration (double energyW, Time duration)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_interference.GetEnergyDuration (energyW), duration,
+                         "Wrong energy duration above " << energyW << "W at " << Simulator::Now ());
+}
+
+void
+InterferenceHelperTestCase::DoRun (void)
+{
+  m_model = CreateObject<ChunkRecordingErrorRateModel> ();
+  m_interference.SetErrorRateModel (m_model);
+  m_interference.SetNoiseFigure (1.0);
+
+  typedef ChunkRecordingErrorRateModel::Chunk Chunk;
+  const double s = 1e-10;
+  Ptr<InterferenceHelper::Event> a;
+  Ptr<InterferenceHelper::Event> b;
+  Ptr<InterferenceHelper::Event> c;
+  Ptr<InterferenceHelper::Event> d;
+
+  //
+  // A from 0 to 100 us, its payload from 20 us (16 us of preamble and
+  // 4 us of header); interference from 30 to 70 us; B from 50 to 150 us
+  //
+  Simulator::Schedule (MicroSeconds (0), &InterferenceHelperTestCase::AddEvent, this,
+                       MicroSeconds (100), s, &a);
+  Simulator::Schedule (MicroSeconds (30), &InterferenceHelperTestCase::AddInterference, this,
+                       MicroSeconds (40), s);
+  Simulator::Schedule (MicroSeconds (50), &InterferenceHelperTestCase::AddEvent, this,
+                       MicroSeconds (100), 2 * s, &b);
+
+  // A and its interference received, B starting at that time
+  Simulator::Schedule (MicroSeconds (50), &InterferenceHelperTestCase::CheckSinr, this,
+                       &a, s / (NOISE_W + 3 * s));
+  Simulator::Schedule (MicroSeconds (60), &InterferenceHelperTestCase::CheckSinr, this,
+                       &b, 2 * s / (NOISE_W + 2 * s));
+  // 4s until 70 us, 3s until 100 us, 2s until 150 us
+  Simulator::Schedule (MicroSeconds (60), &InterferenceHelperTestCase::CheckEnergyDuration, this,
+                       3.5 * s, MicroSeconds (10));
+  Simulator::Schedule (MicroSeconds (60), &InterferenceHelperTestCase::CheckEnergyDuration, this,
+                       2.5 * s, MicroSeconds (40));
+  Simulator::Schedule (MicroSeconds (60), &InterferenceHelperTestCase::CheckEnergyDuration, this,
+                       1.5 * s, MicroSeconds (90));
+  // the interference ends right at 70 us
+  Simulator::Schedule (MicroSeconds (70), &InterferenceHelperTestCase::CheckSinr, this,
+                       &a, s / (NOISE_W + 2 * s));
+
+  std::vector<Chunk> aChunks;
+  aChunks.push_back (Chunk (s / NOISE_W, GetBits (MicroSeconds (10))));
+  aChunks.push_back (Chunk (s / (NOISE_W + s), GetBits (MicroSeconds (20))));
+  aChunks.push_back (Chunk (s / (NOISE_W + 3 * s), GetBits (MicroSeconds (20))));
+  aChunks.push_back (Chunk (s / (NOISE_W + 2 * s), GetBits (MicroSeconds (30))));
+  Simulator::Schedule (MicroSeconds (100), &InterferenceHelperTestCase::CheckPayload, this,
+                       &a, s / NOISE_W, aChunks);
+  // the end of A is the last change
+  Simulator::Schedule (MicroSeconds (100), &InterferenceHelperTestCase::CheckSinr, this,
+                       &a, s / (NOISE_W + 2 * s));
+
+  std::vector<Chunk> bChunks;
+  bChunks.push_back (Chunk (2 * s / (NOISE_W + s), GetBits (MicroSeconds (30))));
+  bChunks.push_back (Chunk (2 * s / NOISE_W, GetBits (MicroSeconds (50))));
+  Simulator::Schedule (MicroSeconds (150), &InterferenceHelperTestCase::CheckPayload, this,
+                       &b, 2 * s / (NOISE_W + 2 * s), bChunks);
+
+  //
+  // Once the longest signal (100 us) has ended, the older changes are
+  // dropped: interference from 250 to 330 us, C from 300 to 400 us,
+  // interference from 350 to 370 us.  At 400 us, the start of the first
+  // interference is forgotten, but still counts at the start of C.
+  //
+  Simulator::Schedule (MicroSeconds (250), &InterferenceHelperTestCase::CheckEnergyDuration, this,
+                       0.5 * s, MicroSeconds (0));
+  Simulator::Schedule (MicroSeconds (250), &InterferenceHelperTestCase::AddInterference, this,
+                       MicroSeconds (80), s);
+  Simulator::Schedule (MicroSeconds (300), &InterferenceHelperTestCase::AddEvent, this,
+                       MicroSeconds (100), s, &c);
+  Simulator::Schedule (MicroSeconds (350), &InterferenceHelperTestCase::AddInterference, this,
+                       MicroSeconds (20), s);
+  Simulator::Schedule (MicroSeconds (400), &InterferenceHelperTestCase::CheckEnergyDuration, this,
+                       0.5 * s, MicroSeconds (0));
+  std::vector<Chunk> cChunks;
+  cChunks.push_back (Chunk (s / (NOISE_W + s), GetBits (MicroSeconds (10))));
+  cChunks.push_back (Chunk (s / NOISE_W, GetBits (MicroSeconds (20))));
+  cChunks.push_back (Chunk (s / (NOISE_W + s), GetBits (MicroSeconds (20))));
+  cChunks.push_back (Chunk (s / NOISE_W, GetBits (MicroSeconds (30))));
+  Simulator::Schedule (MicroSeconds (400), &InterferenceHelperTestCase::CheckPayload, this,
+                       &c, s / (NOISE_W + s), cChunks);
+  Simulator::Schedule (MicroSeconds (400), &InterferenceHelperTestCase::CheckSinr, this,
+                       &c, s / NOISE_W);
+
+  //
+  // D from 600 to 650 us, E from 620 to 720 us, F from 650 to 680 us.  At
+  // the end of D, the power of D counts neither at its start nor at its
+  // end, and F, starting at that time, does.
+  //
+  Simulator::Schedule (MicroSeconds (600), &InterferenceHelperTestCase::AddEvent, this,
+                       MicroSeconds (50), s, &d);
+  Simulator::Schedule (MicroSeconds (620), &InterferenceHelperTestCase::AddInterference, this,
+                       MicroSeconds (100), 2 * s);
+  Simulator::Schedule (MicroSeconds (650), &InterferenceHelperTestCase::AddInterference, this,
+                       MicroSeconds (30), s);
+  std::vector<Chunk> dChunks;
+  dChunks.push_back (Chunk (s / (NOISE_W + 2 * s), GetBits (MicroSeconds (30))));
+  Simulator::Schedule (MicroSeconds (650), &InterferenceHelperTestCase::CheckPayload, this,
+                       &d, s / NOISE_W, dChunks);
+  Simulator::Schedule (MicroSeconds (650), &InterferenceHelperTestCase::CheckSinr, this,
+                       &d, s / (NOISE_W + 3 * s));
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_interference.EraseEvents ();
+}
+
+/**
+ * Check the SINR of the chunks of the payload and at random times against
+ * a brute-force sum over all the signals, on random signals.
+ */
+class InterferenceHelperCrossCheckTestCase : public TestCase
+{
+public:
+  InterferenceHelperCrossCheckTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /// A signal received
+  struct Signal
+  {
+    Time start;      //!< start of the signal
+    Time end;        //!< end of the signal
+    double powerW;   //!< rx power of the signal
+    Ptr<InterferenceHelper::Event> event; //!< the event of a frame, 0 for interference
+  };
+  /**
+   * Receive a random signal, and schedule the checks of a frame.
+   * \param i the index of the signal
+   */
+  void AddSignal (uint32_t i);
+  /**
+   * \param i the index of a signal
+   * \param time a time
+   * \return the power of the other signals at that time
+   */
+  double GetInterferenceW (uint32_t i, Time time) const;
+  /**
+   * Check the chunks of the payload of a frame at its end.
+   * \param i the index of the signal of the frame
+   */
+  void CheckPayload (uint32_t i);
+  /**
+   * Check the SINR of a frame at the current time.
+   * \param i the index of the signal of the frame
+   */
+  void CheckSinr (uint32_t i);
+
+  InterferenceHelper m_interference;
+  Ptr<ChunkRecordingErrorRateModel> m_model;
+  Ptr<UniformRandomVariable> m_random;
+  std::vector<Signal> m_signals;
+};
+
+InterferenceHelperCrossCheckTestCase::InterferenceHelperCrossCheckTestCase ()
+  : TestCase ("Check the interference of random signals against a brute-force sum")
+{
+}
+
+void
+InterferenceHelperCrossCheckTestCase::AddSignal (uint32_t i)
+{
+  Signal &signal = m_signals[i];
+  signal.start = Simulator::Now ();
+  // whole microseconds, so that changes often happen at the same time,
+  // and longer than the 20 us before the payload
+  Time duration = MicroSeconds (m_random->GetInteger (24, 200));
+  signal.end = signal.start + duration;
+  signal.powerW = m_random->GetValue (0.1, 10.0) * NOISE_W;
+  if (m_random->GetValue () < 0.3)
+    {
+      m_interference.AddInterference (duration, signal.powerW);
+      return;
+    }
+  signal.event = m_interference.Add (1000, GetTestTxVector (), WIFI_PREAMBLE_LONG, duration, signal.powerW);
+  Simulator::Schedule (duration, &InterferenceHelperCrossCheckTestCase::CheckPayload, this, i);
+  Simulator::Schedule (MicroSeconds (m_random->GetInteger (0, duration.GetMicroSeconds ())),
+                       &InterferenceHelperCrossCheckTestCase::CheckSinr, this, i);
+}
+
+double
+InterferenceHelperCrossCheckTestCase::GetInterferenceW (uint32_t i, Time time) const
+{
+  double interferenceW = 0;
+  for (uint32_t j = 0; j < m_signals.size (); j++)
+    {
+      if (j != i && m_signals[j].start <= time && m_signals[j].end > time)
+        {
+          interferenceW += m_signals[j].powerW;
+        }
+    }
+  return interferenceW;
+}
+
+void
+InterferenceHelperCrossCheckTestCase::CheckPayload (uint32_t i)
+{
+  const Signal &signal = m_signals[i];
+  WifiMode mode = GetTestMode ();
+  Time payloadStart = signal.start + WifiPhy::GetPlcpPreambleDuration (mode, WIFI_PREAMBLE_LONG)
+    + WifiPhy::GetPlcpHeaderDuration (mode, WIFI_PREAMBLE_LONG);
+  // the chunks start and end at the changes of the other signals
+  std::vector<Time> bounds;
+  bounds.push_back (payloadStart);
+  for (uint32_t j = 0; j < m_signals.size (); j++)
+    {
+      Time changes[] = {m_signals[j].start, m_signals[j].end};
+      for (uint32_t k = 0; k < 2; k++)
+        {
+          if (j != i && changes[k] > payloadStart && changes[k] < signal.end)
+            {
+              bounds.push_back (changes[k]);
+            }
+        }
+    }
+  bounds.push_back (signal.end);
+  std::sort (bounds.begin (), bounds.end ());
+  std::vector<ChunkRecordingErrorRateModel::Chunk> chunks;
+  for (uint32_t k = 0; k + 1 < bounds.size (); k++)
+    {
+      Time duration = bounds[k + 1] - bounds[k];
+      if (duration.IsStrictlyPositive ())
+        {
+          double snr = signal.powerW / (NOISE_W + GetInterferenceW (i, bounds[k]));
+          chunks.push_back (ChunkRecordingErrorRateModel::Chunk (snr, GetBits (duration)));
+        }
+    }
+
+  m_model->m_chunks.clear ();
+  struct InterferenceHelper::SnrPer snrPer = m_interference.CalculatePlcpPayloadSnrPer (signal.event);
+  double snr = signal.powerW / (NOISE_W + GetInterferenceW (i, signal.start));
+  NS_TEST_EXPECT_MSG_EQ_TOL (snrPer.snr, snr, snr * 1e-9, "Wrong SNR of signal " << i);
+  NS_TEST_ASSERT_MSG_EQ (m_model->m_chunks.size (), chunks.size (), "Wrong number of chunks of signal " << i);
+  for (uint32_t k = 0; k < chunks.size (); k++)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (m_model->m_chunks[k].first, chunks[k].first, chunks[k].first * 1e-9,
+                                 "Wrong SNR of chunk " << k << " of signal " << i);
+      NS_TEST_EXPECT_MSG_EQ (m_model->m_chunks[k].second, chunks[k].second,
+                             "Wrong size of chunk " << k << " of signal " << i);
+    }
+}
+
+void
+InterferenceHelperCrossCheckTestCase::CheckSinr (uint32_t i)
+{
+  const Signal &signal = m_signals[i];
+  Time now = Simulator::Now ();
+  double sinr = signal.powerW / (NOISE_W + GetInterferenceW (i, now));
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_interference.CalculateSinrAtTime (signal.event, now), sinr, sinr * 1e-9,
+                             "Wrong SINR of signal " << i << " at " << now);
+}
+
+void
+InterferenceHelperCrossCheckTestCase::DoRun (void)
+{
+  m_model = CreateObject<ChunkRecordingErrorRateModel> ();
+  m_interference.SetErrorRateModel (m_model);
+  m_interference.SetNoiseFigure (1.0);
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+
+  // bursts of overlapping signals, with gaps longer than the longest one
+  m_signals.resize (500);
+  Time start = MicroSeconds (0);
+  for (uint32_t i = 0; i < m_signals.size (); i++)
+    {
+      start += MicroSeconds (m_random->GetInteger (0, i % 50 == 49 ? 1000 : 40));
+      Simulator::Schedule (start, &InterferenceHelperCrossCheckTestCase::AddSignal, this, i);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_interference.EraseEvents ();
+  m_signals.clear ();
+}
+
+class InterferenceHelperTestSuite : public TestSuite
+{
+public:
+  InterferenceHelperTestSuite ();
+};
+
+InterferenceHelperTestSuite::InterferenceHelperTestSuite ()
+  : TestSuite ("wifi-interference-helper", UNIT)
+{
+  AddTestCase (new InterferenceHelperTestCase, TestCase::QUICK);
+  AddTestCase (new InterferenceHelperCrossCheckTestCase, TestCase::QUICK);
+}
+
+static InterferenceHelperTestSuite g_interferenceHelperTestSuite;
@@ -278,6 +278,106 @@ TxDurationTest::DoRun (void)
 }
 
 
+/**
+ * Check that the durations kept by the PHY are the ones it computes,
+ * whatever the order of the frames it is asked about.
+ */
+class TxDurationCacheTest : public TestCase
+{
+public:
+  TxDurationCacheTest ();
+  virtual ~TxDurationCacheTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \param phy the PHY
+   * \param size size of the frame in octets
+   * \param payloadMode the WifiMode used
+   * \param preamble the WifiPreamble used
+   * \param frequency the channel center frequency (MHz)
+   *
+   * \return the duration of the frame in microseconds
+   */
+  double GetTxDuration (Ptr<YansWifiPhy> phy, uint32_t size, WifiMode payloadMode, WifiPreamble preamble, double frequency);
+};
+
+TxDurationCacheTest::TxDurationCacheTest ()
+  : TestCase ("Wifi TX Duration kept by the PHY")
+{
+}
+
+TxDurationCacheTest::~TxDurationCacheTest ()
+{
+}
+
+double
+TxDurationCacheTest::GetTxDuration (Ptr<YansWifiPhy> phy, uint32_t size, WifiMode payloadMode, WifiPreamble preamble, double frequency)
+{
+  WifiTxVector txVector;
+  txVector.SetMode (payloadMode);
+  txVector.SetNss (1);
+  txVector.SetStbc (0);
+  txVector.SetNess (0);
+  return ((double)phy->CalculateTxDuration (size, txVector, preamble, frequency, 0, 0).GetNanoSeconds ()) / 1000;
+}
+
+void
+TxDurationCacheTest::DoRun (void)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+
+  //802.11a, asked twice in a different order
+  for (uint32_t round = 0; round < 2; round++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (GetTxDuration (phy, 1536, WifiPhy::GetOfdmRate54Mbps (), WIFI_PREAMBLE_LONG, CHANNEL_36_MHZ), 248, "wrong 802.11a duration in round " << round);
+      NS_TEST_EXPECT_MSG_EQ (GetTxDuration (phy, 14, WifiPhy::GetOfdmRate54Mbps (), WIFI_PREAMBLE_LONG, CHANNEL_36_MHZ), 24, "wrong 802.11a duration in round " << round);
+      NS_TEST_EXPECT_MSG_EQ (GetTxDuration (phy, 76, WifiPhy::GetOfdmRate54Mbps (), WIFI_PREAMBLE_LONG, CHANNEL_36_MHZ), 32, "wrong 802.11a duration in round " << round);
+      NS_TEST_EXPECT_MSG_EQ (GetTxDuration (phy, 76, WifiPhy::GetErpOfdmRate54Mbps (), WIFI_PREAMBLE_LONG, CHANNEL_1_MHZ), 38, "wrong 802.11g duration in round " << round);
+    }
+
+  //the HT durations depend on the band: the frequency is part of the key
+  NS_TEST_EXPECT_MSG_EQ (GetTxDuration (phy, 1536, WifiPhy::GetOfdmRate65MbpsBW20MHz (), WIFI_PREAMBLE_HT_MF, CHANNEL_36_MHZ), 228, "wrong 5 GHz 802.11n duration");
+  NS_TEST_EXPECT_MSG_EQ (GetTxDuration (phy, 1536, WifiPhy::GetOfdmRate65MbpsBW20MHz (), WIFI_PREAMBLE_HT_MF, CHANNEL_1_MHZ), 234, "wrong 2.4 GHz 802.11n duration");
+  NS_TEST_EXPECT_MSG_EQ (GetTxDuration (phy, 1536, WifiPhy::GetOfdmRate65MbpsBW20MHz (), WIFI_PREAMBLE_HT_MF, CHANNEL_36_MHZ), 228, "5 GHz 802.11n duration taken from 2.4 GHz");
+
+  //802.11ah, asked in two orders: 40 us symbols of 12 bits at 300 kbps,
+  //36 us symbols of 72 bits at 2 Mbps, 8 + 8 * size + 6 payload bits,
+  //560 us (S1G_1M) or 240 us (S1G_SHORT) of preamble and header
+  struct
+  {
+    WifiMode mode;
+    WifiPreamble preamble;
+    uint32_t size;
+    double duration;
+  } s1g[] = {
+    {WifiPhy::GetOfdmRate300KbpsBW1MHz (), WIFI_PREAMBLE_S1G_1M, 14, 560 + 11 * 40},
+    {WifiPhy::GetOfdmRate300KbpsBW1MHz (), WIFI_PREAMBLE_S1G_1M, 76, 560 + 52 * 40},
+    {WifiPhy::GetOfdmRate300KbpsBW1MHz (), WIFI_PREAMBLE_S1G_1M, 1536, 560 + 1026 * 40},
+    {WifiPhy::GetOfdmRate300KbpsBW1MHz (), WIFI_PREAMBLE_S1G_SHORT, 14, 240 + 11 * 40},
+    {WifiPhy::GetOfdmRate300KbpsBW1MHz (), WIFI_PREAMBLE_S1G_SHORT, 76, 240 + 52 * 40},
+    {WifiPhy::GetOfdmRate300KbpsBW1MHz (), WIFI_PREAMBLE_S1G_SHORT, 1536, 240 + 1026 * 40},
+    {WifiPhy::GetOfdmRate2MbpsBW1MHz (), WIFI_PREAMBLE_S1G_1M, 14, 560 + 2 * 36},
+    {WifiPhy::GetOfdmRate2MbpsBW1MHz (), WIFI_PREAMBLE_S1G_1M, 76, 560 + 9 * 36},
+    {WifiPhy::GetOfdmRate2MbpsBW1MHz (), WIFI_PREAMBLE_S1G_1M, 1536, 560 + 171 * 36},
+    {WifiPhy::GetOfdmRate2MbpsBW1MHz (), WIFI_PREAMBLE_S1G_SHORT, 14, 240 + 2 * 36},
+    {WifiPhy::GetOfdmRate2MbpsBW1MHz (), WIFI_PREAMBLE_S1G_SHORT, 76, 240 + 9 * 36},
+    {WifiPhy::GetOfdmRate2MbpsBW1MHz (), WIFI_PREAMBLE_S1G_SHORT, 1536, 240 + 171 * 36},
+  };
+  uint32_t n = sizeof (s1g) / sizeof (s1g[0]);
+  for (uint32_t round = 0; round < 2; round++)
+    {
+      for (uint32_t j = 0; j < n; j++)
+        {
+          uint32_t i = (round == 0) ? j : n - 1 - j;
+          NS_TEST_EXPECT_MSG_EQ (GetTxDuration (phy, s1g[i].size, s1g[i].mode, s1g[i].preamble, 900), s1g[i].duration,
+                                 "wrong 802.11ah duration: mode=" << s1g[i].mode << " preamble=" << s1g[i].preamble
+                                 << " size=" << s1g[i].size << " round=" << round);
+        }
+    }
+}
+
+
 class TxDurationTestSuite : public TestSuite
 {
 public:
@@ -291,3 +391,18 @@ TxDurationTestSuite::TxDurationTestSuite ()
 }
 
 static TxDurationTestSuite g_txDurationTestSuite;
+
+
+class TxDurationCacheTestSuite : public TestSuite
+{
+public:
+  TxDurationCacheTestSuite ();
+};
+
+TxDurationCacheTestSuite::TxDurationCacheTestSuite ()
+  : TestSuite ("devices-wifi-tx-duration-cache", UNIT)
+{
+  AddTestCase (new TxDurationCacheTest, TestCase::QUICK);
+}
+
+static TxDurationCacheTestSuite g_txDurationCacheTestSuite;
@@ -25,11 +25,13 @@
 #include "ns3/adhoc-wifi-mac.h"
 #include "ns3/yans-wifi-phy.h"
 #include "ns3/arf-wifi-manager.h"
+#include "ns3/constant-rate-wifi-manager.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/error-rate-model.h"
 #include "ns3/yans-error-rate-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
 #include "ns3/node.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
@@ -41,6 +43,17 @@
 #include "ns3/edca-txop-n.h"
 #include "ns3/config.h"
 #include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/auth-threshold-policy.h"
+#include "ns3/wifi-mac-queue.h"
+#include "ns3/auth-admission-controller.h"
+#include "ns3/uinteger.h"
+#include "ns3/default-simulator-impl.h"
+#include "ns3/multi-threaded-simulator-impl.h"
+#include "ns3/nstime.h"
+#include <fstream>
+#include <sstream>
 
 using namespace ns3;
 
@@ -482,6 +495,545 @@ Bug555TestCase::DoRun (void)
 }
 
 
+//-----------------------------------------------------------------------------
+class MlpAuthThresholdPolicyTest : public TestCase
+{
+public:
+  MlpAuthThresholdPolicyTest () : TestCase ("MlpAuthThresholdPolicy")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    // 4 -> 5 relu -> 1: y = 2 x0 + 0.5 (x0 + x1 + x2 + x3) + 10, with x clipped at 0
+    std::string filename = CreateTempDirFilename ("policy.bin");
+    std::ofstream out (filename.c_str (), std::ios::binary);
+    uint32_t header[] = {0x31504c4d, 2, 4, 5, 1};
+    float w1[] = {1, 0, 0, 0,
+                  0, 1, 0, 0,
+                  0, 0, 1, 0,
+                  0, 0, 0, 1,
+                  1, 1, 1, 1};
+    float b1[] = {0, 0, 0, 0, 0};
+    uint32_t header2[] = {5, 1, 0};
+    float w2[] = {2, 0, 0, 0, 0.5};
+    float b2[] = {10};
+    out.write ((const char *) header, sizeof (header));
+    out.write ((const char *) w1, sizeof (w1));
+    out.write ((const char *) b1, sizeof (b1));
+    out.write ((const char *) header2, sizeof (header2));
+    out.write ((const char *) w2, sizeof (w2));
+    out.write ((const char *) b2, sizeof (b2));
+    out.close ();
+
+    Ptr<MlpAuthThresholdPolicy> policy = CreateObject<MlpAuthThresholdPolicy> ();
+    NS_TEST_ASSERT_MSG_EQ (policy->Load (filename), true, "weights file not loaded");
+    NS_TEST_ASSERT_MSG_EQ (policy->GetInputSize (), 4, "wrong input size");
+    NS_TEST_ASSERT_MSG_EQ (policy->GetOutputSize (), 1, "wrong output size");
+
+    float features[] = {3, -4, 5, 100};
+    NS_TEST_EXPECT_MSG_EQ (policy->GetThreshold (features), 68, "wrong threshold");
+    float large[] = {600, 0, 0, 0};
+    NS_TEST_EXPECT_MSG_EQ (policy->GetThreshold (large), 1023, "threshold not clamped");
+
+    NS_TEST_EXPECT_MSG_EQ (policy->Load (CreateTempDirFilename ("missing.bin")), false, "missing file loaded");
+  }
+};
+
+
+//-----------------------------------------------------------------------------
+class AuthAdmissionControllerTest : public TestCase
+{
+public:
+  AuthAdmissionControllerTest () : TestCase ("AuthAdmissionController")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    AuthAdmissionInput in;
+    in.saturatedAssociated = true;
+    in.beaconInterval = MilliSeconds (500);
+
+    Ptr<AuthAdmissionController> step = CreateObject<StepAuthAdmissionController> ();
+    step->SetAttribute ("Step", UintegerValue (60));
+    step->Update (in);
+    step->Update (in);
+    NS_TEST_EXPECT_MSG_EQ (in.threshold, 120, "short queue, threshold not raised");
+    in.queueSize = 10;
+    step->Update (in);
+    NS_TEST_EXPECT_MSG_EQ (in.threshold, 60, "long queue, threshold not lowered");
+
+    // wait with all stations admitted, learn by doubling the step, then work around the result
+    Ptr<AuthAdmissionController> cac = CreateObject<CacAuthAdmissionController> ();
+    uint32_t queue[] = {0, 5, 0, 0, 0, 3};
+    uint16_t expected[] = {1023, 0, 1, 3, 7, 5};
+    for (uint32_t i = 0; i < sizeof (queue) / sizeof (queue[0]); i++)
+      {
+        in.queueSize = queue[i];
+        cac->Update (in);
+        NS_TEST_EXPECT_MSG_EQ (in.threshold, expected[i], "wrong threshold at beacon " << i);
+      }
+
+    // recorded inputs are read back as written
+    in.tau = MicroSeconds (1234);
+    in.associatingStasAppear = true;
+    std::stringstream ss;
+    ss << in;
+    AuthAdmissionInput read;
+    ss >> read;
+    NS_TEST_EXPECT_MSG_EQ (read.queueSize, in.queueSize, "queue size not read back");
+    NS_TEST_EXPECT_MSG_EQ (read.tau, in.tau, "tau not read back");
+    NS_TEST_EXPECT_MSG_EQ (read.beaconInterval, in.beaconInterval, "beacon interval not read back");
+    NS_TEST_EXPECT_MSG_EQ (read.associatingStasAppear, true, "flag not read back");
+    NS_TEST_EXPECT_MSG_EQ (read.threshold, in.threshold, "threshold not read back");
+  }
+};
+
+
+//-----------------------------------------------------------------------------
+class WifiMacQueueCountersTest : public TestCase
+{
+public:
+  WifiMacQueueCountersTest () : TestCase ("WifiMacQueue per-subtype and per-flow counters")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    Mac48Address sta1 ("00:00:00:00:00:01");
+    Mac48Address sta2 ("00:00:00:00:00:02");
+    m_queue = CreateObject<WifiMacQueue> ();
+    m_queue->SetMaxDelay (MilliSeconds (10));
+
+    WifiMacHeader auth;
+    auth.SetType (WIFI_MAC_MGT_AUTHENTICATION);
+    auth.SetAddr1 (sta1);
+    WifiMacHeader assoc;
+    assoc.SetType (WIFI_MAC_MGT_ASSOCIATION_RESPONSE);
+    assoc.SetAddr1 (sta2);
+    WifiMacHeader qos;
+    qos.SetType (WIFI_MAC_QOSDATA);
+    qos.SetAddr1 (sta1);
+    qos.SetQosTid (3);
+
+    Ptr<const Packet> authPacket = Create<Packet> ();
+    m_queue->Enqueue (authPacket, auth);
+    m_queue->Enqueue (Create<Packet> (), assoc);
+    m_queue->PushFront (Create<Packet> (), auth);
+    m_queue->Enqueue (Create<Packet> (), qos);
+    m_queue->Enqueue (Create<Packet> (), qos);
+    qos.SetAddr1 (sta2);
+    m_queue->Enqueue (Create<Packet> (), qos);
+    CheckCounters (2, 1, 2, 1);
+
+    WifiMacHeader hdr;
+    m_queue->Dequeue (&hdr);
+    NS_TEST_EXPECT_MSG_EQ (hdr.IsAuthentication (), true, "PushFront did not put the packet first");
+    CheckCounters (1, 1, 2, 1);
+    m_queue->Remove (authPacket);
+    CheckCounters (0, 1, 2, 1);
+    m_queue->DequeueByTidAndAddress (&hdr, 3, WifiMacHeader::ADDR1, sta1);
+    CheckCounters (0, 1, 1, 1);
+    m_queue->DropByAddress (sta2);
+    CheckCounters (0, 0, 1, 0);
+
+    // expired packets leave the counters with the Cleanup that drops them
+    Simulator::Schedule (MilliSeconds (5), &WifiMacQueue::Enqueue, m_queue, Create<Packet> (), auth);
+    Simulator::Schedule (MilliSeconds (12), &WifiMacQueueCountersTest::CheckCounters, this, 1, 0, 0, 0);
+    Simulator::Run ();
+    m_queue->Flush ();
+    CheckCounters (0, 0, 0, 0);
+    Simulator::Destroy ();
+
+    // the per-flow lookups keep the FIFO order of the queue, PushFront included
+    qos.SetAddr1 (sta1);
+    Ptr<const Packet> first = Create<Packet> ();
+    Ptr<const Packet> second = Create<Packet> ();
+    Ptr<const Packet> third = Create<Packet> ();
+    m_queue->Enqueue (second, qos);
+    m_queue->Enqueue (Create<Packet> (), auth);
+    m_queue->Enqueue (third, qos);
+    m_queue->PushFront (first, qos);
+    Time tstamp;
+    NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (&hdr, 3, WifiMacHeader::ADDR1, sta1, &tstamp), first, "wrong head of flow");
+    NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (&hdr, 4, WifiMacHeader::ADDR1, sta1, &tstamp), 0, "packet of another TID");
+    NS_TEST_EXPECT_MSG_EQ (m_queue->Remove (second), true, "packet not removed");
+    NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (&hdr, 3, WifiMacHeader::ADDR1, sta1), first, "wrong head of flow");
+    NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (&hdr, 3, WifiMacHeader::ADDR1, sta1), third, "wrong head of flow");
+    NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (&hdr, 3, WifiMacHeader::ADDR1, sta1), 0, "flow not empty");
+    CheckCounters (1, 0, 0, 0);
+    m_queue->Flush ();
+  }
+
+private:
+  void CheckCounters (uint32_t nAuth, uint32_t nAssoc, uint32_t nSta1, uint32_t nSta2)
+  {
+    // GetNPacketsByTidAndAddress runs the Cleanup
+    NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (3, WifiMacHeader::ADDR1, Mac48Address ("00:00:00:00:00:01")),
+                           nSta1, "wrong number of packets for 00:00:00:00:00:01");
+    NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (3, WifiMacHeader::ADDR1, Mac48Address ("00:00:00:00:00:02")),
+                           nSta2, "wrong number of packets for 00:00:00:00:00:02");
+    NS_TEST_EXPECT_MSG_EQ (m_queue->GetAuthRepNumber (), nAuth, "wrong number of AuthReps");
+    NS_TEST_EXPECT_MSG_EQ (m_queue->GetAssocRepNumber (), nAssoc, "wrong number of AssocReps");
+    NS_TEST_EXPECT_MSG_EQ (m_queue->GetSize (), nAuth + nAssoc + nSta1 + nSta2, "wrong queue size");
+  }
+
+  Ptr<WifiMacQueue> m_queue;
+};
+
+
+//-----------------------------------------------------------------------------
+class YansWifiChannelCullingTest : public TestCase
+{
+public:
+  YansWifiChannelCullingTest () : TestCase ("YansWifiChannel culling")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    // near, far and then near, moving near and then far from the sender
+    RunOne (false);
+    NS_TEST_EXPECT_MSG_EQ (m_rx[0], 2, "frames lost without culling");
+    NS_TEST_EXPECT_MSG_EQ (m_rx[1], 2, "frames lost without culling");
+    NS_TEST_EXPECT_MSG_EQ (m_rx[2], 2, "frames lost without culling");
+    RunOne (true);
+    NS_TEST_EXPECT_MSG_EQ (m_rx[0], 2, "frame to a PHY in range culled");
+    NS_TEST_EXPECT_MSG_EQ (m_rx[1], 1, "frame to a PHY out of range not culled, or grid not updated");
+    NS_TEST_EXPECT_MSG_EQ (m_rx[2], 1, "moving PHY not tracked");
+  }
+
+private:
+  static void RxBegin (uint32_t *count, Ptr<const Packet> packet)
+  {
+    (*count)++;
+  }
+  static void SendOnePacket (Ptr<WifiNetDevice> dev)
+  {
+    dev->Send (Create<Packet> (), dev->GetBroadcast (), 1);
+  }
+  Ptr<WifiNetDevice> CreateOne (Ptr<MobilityModel> mobility, Ptr<YansWifiChannel> channel)
+  {
+    Ptr<Node> node = CreateObject<Node> ();
+    Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+    Ptr<WifiMac> mac = CreateObject<AdhocWifiMac> ();
+    mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+    Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+    phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+    phy->SetChannel (channel);
+    phy->SetDevice (dev);
+    phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+    node->AggregateObject (mobility);
+    mac->SetAddress (Mac48Address::Allocate ());
+    dev->SetMac (mac);
+    dev->SetPhy (phy);
+    dev->SetRemoteStationManager (CreateObject<ConstantRateWifiManager> ());
+    node->AddDevice (dev);
+    return dev;
+  }
+  void RunOne (bool culling)
+  {
+    Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+    channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+    channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+    channel->SetAttribute ("Culling", BooleanValue (culling));
+    channel->SetAttribute ("CullingThreshold", DoubleValue (-60));
+    channel->SetAttribute ("CullingCellSize", DoubleValue (20));
+
+    Ptr<ConstantPositionMobilityModel> senderMobility = CreateObject<ConstantPositionMobilityModel> ();
+    Ptr<WifiNetDevice> sender = CreateOne (senderMobility, channel);
+    Ptr<ConstantPositionMobilityModel> near = CreateObject<ConstantPositionMobilityModel> ();
+    near->SetPosition (Vector (5, 0, 0));
+    Ptr<ConstantPositionMobilityModel> far = CreateObject<ConstantPositionMobilityModel> ();
+    far->SetPosition (Vector (30, 0, 0));
+    Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+    moving->SetPosition (Vector (100, 0, 0));
+    moving->SetVelocity (Vector (-95, 0, 0));
+    Ptr<MobilityModel> receivers[] = {near, far, moving};
+    for (uint32_t i = 0; i < 3; i++)
+      {
+        m_rx[i] = 0;
+        CreateOne (receivers[i], channel)->GetPhy ()->TraceConnectWithoutContext ("PhyRxBegin", MakeBoundCallback (&RxBegin, &m_rx[i]));
+      }
+    if (culling)
+      {
+        double range = channel->GetCullingRange (DynamicCast<YansWifiPhy> (sender->GetPhy ())->GetTxPowerStart ());
+        NS_TEST_EXPECT_MSG_GT (range, 5, "culling range too short");
+        NS_TEST_EXPECT_MSG_LT (range, 20, "culling range too long");
+      }
+
+    Simulator::Schedule (Seconds (1.0), &SendOnePacket, sender);
+    Simulator::Schedule (Seconds (1.5), &ConstantPositionMobilityModel::SetPosition, far, Vector (5, 5, 0));
+    Simulator::Schedule (Seconds (2.0), &SendOnePacket, sender);
+    Simulator::Stop (Seconds (3.0));
+    Simulator::Run ();
+    Simulator::Destroy ();
+  }
+
+  uint32_t m_rx[3];
+};
+
+
+//-----------------------------------------------------------------------------
+class YansWifiChannelSpectralMaskTest : public TestCase
+{
+public:
+  YansWifiChannelSpectralMaskTest () : TestCase ("YansWifiChannel spectral mask")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    // receivers on the channel of the sender, 1 and 2 channels away
+    RunOne ("");
+    NS_TEST_EXPECT_MSG_EQ (m_rx[0], 1, "frame not received on the same channel");
+    NS_TEST_EXPECT_MSG_EQ (m_rx[1] + m_rx[2], 0, "frame received on another channel");
+    NS_TEST_EXPECT_MSG_EQ (m_ccaBusy[1], false, "leakage without spectral mask");
+    NS_TEST_EXPECT_MSG_EQ (m_ccaBusy[2], false, "leakage without spectral mask");
+    RunOne ("20");
+    NS_TEST_EXPECT_MSG_EQ (m_rx[0], 1, "frame not received on the same channel");
+    NS_TEST_EXPECT_MSG_EQ (m_rx[1] + m_rx[2], 0, "frame received on another channel");
+    NS_TEST_EXPECT_MSG_EQ (m_ccaBusy[1], true, "no leakage into the adjacent channel");
+    NS_TEST_EXPECT_MSG_EQ (m_ccaBusy[2], false, "leakage beyond the spectral mask");
+  }
+
+private:
+  static void RxBegin (uint32_t *count, Ptr<const Packet> packet)
+  {
+    (*count)++;
+  }
+  static void SendOnePacket (Ptr<WifiNetDevice> dev)
+  {
+    dev->Send (Create<Packet> (), dev->GetBroadcast (), 1);
+  }
+  void TxBegin (Ptr<const Packet> packet)
+  {
+    Simulator::Schedule (MicroSeconds (10), &YansWifiChannelSpectralMaskTest::CheckCcaBusy, this);
+  }
+  void CheckCcaBusy (void)
+  {
+    for (uint32_t i = 0; i < 3; i++)
+      {
+        m_ccaBusy[i] = m_phys[i]->IsStateCcaBusy ();
+      }
+  }
+  Ptr<WifiNetDevice> CreateOne (Vector position, uint16_t channelNumber, Ptr<YansWifiChannel> channel)
+  {
+    Ptr<Node> node = CreateObject<Node> ();
+    Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+    Ptr<WifiMac> mac = CreateObject<AdhocWifiMac> ();
+    mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+    Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+    mobility->SetPosition (position);
+    Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+    phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+    phy->SetChannel (channel);
+    phy->SetDevice (dev);
+    phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+    phy->SetChannelNumber (channelNumber);
+    node->AggregateObject (mobility);
+    mac->SetAddress (Mac48Address::Allocate ());
+    dev->SetMac (mac);
+    dev->SetPhy (phy);
+    dev->SetRemoteStationManager (CreateObject<ConstantRateWifiManager> ());
+    node->AddDevice (dev);
+    return dev;
+  }
+  void RunOne (std::string mask)
+  {
+    Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+    channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+    channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+    channel->SetAttribute ("SpectralMask", StringValue (mask));
+
+    Ptr<WifiNetDevice> sender = CreateOne (Vector (0, 0, 0), 36, channel);
+    sender->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&YansWifiChannelSpectralMaskTest::TxBegin, this));
+    for (uint32_t i = 0; i < 3; i++)
+      {
+        m_rx[i] = 0;
+        m_ccaBusy[i] = false;
+        Ptr<WifiNetDevice> dev = CreateOne (Vector (5, i, 0), 36 + i, channel);
+        m_phys[i] = DynamicCast<YansWifiPhy> (dev->GetPhy ());
+        m_phys[i]->TraceConnectWithoutContext ("PhyRxBegin", MakeBoundCallback (&RxBegin, &m_rx[i]));
+      }
+
+    Simulator::Schedule (Seconds (1.0), &SendOnePacket, sender);
+    Simulator::Stop (Seconds (2.0));
+    Simulator::Run ();
+    Simulator::Destroy ();
+    for (uint32_t i = 0; i < 3; i++)
+      {
+        m_phys[i] = 0;
+      }
+  }
+
+  uint32_t m_rx[3];
+  bool m_ccaBusy[3];
+  Ptr<YansWifiPhy> m_phys[3];
+};
+
+
+//-----------------------------------------------------------------------------
+/**
+ * Check that the frames of a YansWifiChannel reach the MACs of the nodes
+ * at the same times with the nodes split between two threads of
+ * MultiThreadedSimulatorImpl as with DefaultSimulatorImpl.
+ */
+class YansWifiChannelThreadsTest : public TestCase
+{
+public:
+  YansWifiChannelThreadsTest () : TestCase ("YansWifiChannel with two threads")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    RunOne (CreateObject<DefaultSimulatorImpl> ());
+    std::vector<std::vector<Rx> > expected = m_rx;
+
+    Ptr<MultiThreadedSimulatorImpl> impl = CreateObject<MultiThreadedSimulatorImpl> ();
+    impl->SetAttribute ("Threads", UintegerValue (2));
+    RunOne (impl);
+
+    for (uint32_t i = 0; i < m_rx.size (); i++)
+      {
+        NS_TEST_EXPECT_MSG_GT (expected[i].size (), 0, "Node " << i << " received no frame");
+        NS_TEST_ASSERT_MSG_EQ (m_rx[i].size (), expected[i].size (), "Wrong number of frames received by node " << i);
+        for (uint32_t j = 0; j < m_rx[i].size (); j++)
+          {
+            NS_TEST_EXPECT_MSG_EQ (m_rx[i][j].first, expected[i][j].first, "Frame " << j << " of node " << i << " at the wrong time");
+            NS_TEST_EXPECT_MSG_EQ (m_rx[i][j].second, expected[i][j].second, "Frame " << j << " of node " << i << " is wrong");
+          }
+      }
+  }
+
+private:
+  /// The time and size of a frame received by a node
+  typedef std::pair<uint64_t, uint32_t> Rx;
+
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+  {
+    // each node is only touched by the thread of its partition
+    m_rx[device->GetNode ()->GetId ()].push_back (Rx (Simulator::Now ().GetTimeStep (), packet->GetSize ()));
+    return true;
+  }
+  static void SendOnePacket (Ptr<WifiNetDevice> dev, Mac48Address to, uint32_t size)
+  {
+    dev->Send (Create<Packet> (size), to, 1);
+  }
+  Ptr<WifiNetDevice> CreateOne (Vector position, Ptr<YansWifiChannel> channel)
+  {
+    Ptr<Node> node = CreateObject<Node> ();
+    Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+    Ptr<WifiMac> mac = CreateObject<AdhocWifiMac> ();
+    mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+    Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+    mobility->SetPosition (position);
+    Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+    phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+    phy->SetChannel (channel);
+    phy->SetDevice (dev);
+    phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+    node->AggregateObject (mobility);
+    mac->SetAddress (Mac48Address::Allocate ());
+    dev->SetMac (mac);
+    dev->SetPhy (phy);
+    dev->SetRemoteStationManager (CreateObject<ConstantRateWifiManager> ());
+    node->AddDevice (dev);
+    AssignWifiRandomStreams (mac, 100 * node->GetId ());
+    dev->SetReceiveCallback (MakeCallback (&YansWifiChannelThreadsTest::Receive, this));
+    return dev;
+  }
+  void RunOne (Ptr<SimulatorImpl> impl)
+  {
+    Simulator::SetImplementation (impl);
+    Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+    channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+    channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+    // nodes 0 and 2 on one thread, 1 and 3 on the other, each sending
+    // to the next one at the same times, so that they contend
+    std::vector<Ptr<WifiNetDevice> > devices;
+    for (uint32_t i = 0; i < 4; i++)
+      {
+        devices.push_back (CreateOne (Vector (10.0 * i, 1.0 * i * i, 0), channel));
+      }
+    m_rx.clear ();
+    m_rx.resize (devices.size ());
+    for (uint32_t i = 0; i < devices.size (); i++)
+      {
+        Ptr<WifiNetDevice> to = devices[(i + 1) % devices.size ()];
+        for (uint32_t k = 0; k < 20; k++)
+          {
+            Simulator::ScheduleWithContext (devices[i]->GetNode ()->GetId (), Seconds (1.0) + MilliSeconds (2 * k),
+                                            &SendOnePacket, devices[i], Mac48Address::ConvertFrom (to->GetAddress ()),
+                                            500 + 10 * i + k);
+          }
+      }
+    // DefaultSimulatorImpl has no lookahead
+    impl->SetAttributeFailSafe ("Lookahead", TimeValue (channel->GetMinimumDelay ()));
+    Simulator::Stop (Seconds (2.0));
+    Simulator::Run ();
+    Simulator::Destroy ();
+  }
+
+  /// The frames received by each node
+  std::vector<std::vector<Rx> > m_rx;
+};
+
+
+//-----------------------------------------------------------------------------
+/**
+ * Check that a frame which the PHY drops up front, because it arrives
+ * while the PHY transmits, still keeps the CCA busy once the transmission
+ * is over, although no reception event is created for it.
+ */
+class YansWifiPhyDroppedRxTest : public TestCase
+{
+public:
+  YansWifiPhyDroppedRxTest () : TestCase ("YansWifiPhy frame dropped while transmitting")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+    channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+    channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+    // at the same place, without propagation delay
+    Ptr<YansWifiPhy> shortSender = CreateOne (channel);
+    Ptr<YansWifiPhy> longSender = CreateOne (channel);
+
+    Simulator::Schedule (Seconds (1.0), &YansWifiPhyDroppedRxTest::SendOnePacket, shortSender, 100);
+    Simulator::Schedule (Seconds (1.0), &YansWifiPhyDroppedRxTest::SendOnePacket, longSender, 1000);
+    // after the 100 bytes frame, before the end of the 1000 bytes one
+    Simulator::Schedule (Seconds (1.0) + MicroSeconds (500), &YansWifiPhyDroppedRxTest::Check, this, shortSender, longSender);
+    Simulator::Run ();
+    Simulator::Destroy ();
+  }
+
+private:
+  static Ptr<YansWifiPhy> CreateOne (Ptr<YansWifiChannel> channel)
+  {
+    Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+    phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+    phy->SetChannel (channel);
+    phy->SetMobility (CreateObject<ConstantPositionMobilityModel> ());
+    phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+    return phy;
+  }
+  static void SendOnePacket (Ptr<YansWifiPhy> phy, uint32_t size)
+  {
+    WifiTxVector txVector;
+    txVector.SetMode (WifiPhy::GetOfdmRate6Mbps ());
+    txVector.SetTxPowerLevel (0);
+    txVector.SetNss (1);
+    phy->SendPacket (Create<Packet> (size), txVector, WIFI_PREAMBLE_LONG, 0);
+  }
+  void Check (Ptr<YansWifiPhy> shortSender, Ptr<YansWifiPhy> longSender)
+  {
+    NS_TEST_ASSERT_MSG_EQ (longSender->IsStateTx (), true, "the long frame has already ended");
+    NS_TEST_EXPECT_MSG_EQ (shortSender->IsStateCcaBusy (), true, "dropped frame not kept as interference");
+    NS_TEST_EXPECT_MSG_EQ (shortSender->GetDelayUntilIdle (), longSender->GetDelayUntilIdle (),
+                           "CCA busy until the wrong time");
+  }
+};
+
+
 //-----------------------------------------------------------------------------
 class WifiTestSuite : public TestSuite
 {
@@ -495,6 +1047,14 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new WifiTest, TestCase::QUICK);
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); //Bug 991
+  AddTestCase (new MlpAuthThresholdPolicyTest, TestCase::QUICK);
+  AddTestCase (new AuthAdmissionControllerTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueCountersTest, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelCullingTest, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelSpectralMaskTest, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelThreadsTest, TestCase::QUICK);
+  AddTestCase (new YansWifiPhyDroppedRxTest, TestCase::QUICK);
+  // last, so that its known failure does not stop the cases above
   AddTestCase (new Bug555TestCase, TestCase::QUICK); //Bug 555
 }
 
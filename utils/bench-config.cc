@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+
+using namespace ns3;
+
+#define LOG(x)   std::cout << x << std::endl
+
+/// Number of trace sinks called, so that the connections are not optimized away
+static uint32_t g_sinks = 0;
+
+/**
+ * A trace sink of PhyTxBegin.
+ *
+ * \param context the context of the trace source
+ * \param packet the packet
+ */
+static void
+TxBegin (std::string context, Ptr<const Packet> packet)
+{
+  g_sinks++;
+}
+
+/**
+ * Print the time of a step of the benchmark.
+ *
+ * \param name the name of the step
+ * \param time the clock started before the step
+ */
+static void
+Report (std::string name, SystemWallClockMs &time)
+{
+  int64_t ms = time.End ();
+  LOG (std::left << std::setw (24) << name << ms << " ms");
+  time.Start ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nodes = 10000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the configuration of the wifi devices of many nodes\n"
+             "through wildcard paths, as scratch/halow_bs does.");
+  cmd.AddValue ("nodes", "number of nodes (default 1E4)", nodes);
+  cmd.Parse (argc, argv);
+
+  LOG (nodes << " nodes");
+  SystemWallClockMs time;
+  time.Start ();
+
+  NodeContainer c;
+  c.Create (nodes);
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  QosWifiMacHelper mac = QosWifiMacHelper::Default ();
+  mac.SetType ("ns3::AdhocWifiMac");
+  WifiHelper wifi = WifiHelper::Default ();
+  wifi.Install (phy, mac, c);
+  Report ("Install", time);
+
+  Config::Set ("/NodeList/*/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/BE_EdcaTxopN/Queue/MaxPacketNumber",
+               UintegerValue (60000));
+  Config::Set ("/NodeList/*/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/BE_EdcaTxopN/Queue/MaxDelay",
+               TimeValue (Seconds (6000)));
+  Report ("Config::Set (x2)", time);
+
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyTxBegin", MakeCallback (&TxBegin));
+  Report ("Config::Connect", time);
+
+  Config::MatchContainer matches = Config::LookupMatches ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac");
+  Report ("Config::LookupMatches", time);
+  LOG (matches.GetN () << " matches, " << g_sinks << " sinks called");
+
+  Simulator::Destroy ();
+  return 0;
+}
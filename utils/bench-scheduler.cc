@@ -0,0 +1,254 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <sstream>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+#define LOG(x)   std::cout << x << std::endl
+
+/// An operation on the event list
+struct Op
+{
+  char type;                //!< 'i', 'b', 'n' or 'r', as written by RecordingScheduler
+  Scheduler::EventKey key;  //!< key of the event inserted or removed
+  uint32_t count;           //!< number of events of a batch
+};
+
+/**
+ * Read the operations written by RecordingScheduler.
+ *
+ * \param input the stream to read
+ * \param ops the operations read
+ */
+static void
+ReadTrace (std::istream &input, std::vector<Op> &ops)
+{
+  std::string line;
+  while (std::getline (input, line))
+    {
+      std::istringstream is (line);
+      Op op;
+      op.key.m_ts = 0;
+      op.key.m_uid = 0;
+      op.key.m_context = 0;
+      op.count = 0;
+      if (!(is >> op.type))
+        {
+          continue;
+        }
+      switch (op.type)
+        {
+        case 'i':
+          is >> op.key.m_ts >> op.key.m_uid >> op.key.m_context;
+          break;
+        case 'b':
+          is >> op.count;
+          break;
+        case 'n':
+          break;
+        case 'r':
+          is >> op.key.m_ts >> op.key.m_uid;
+          break;
+        default:
+          NS_FATAL_ERROR ("Unknown operation in line \"" << line << "\"");
+        }
+      if (!is)
+        {
+          NS_FATAL_ERROR ("Invalid line \"" << line << "\"");
+        }
+      ops.push_back (op);
+    }
+}
+
+/**
+ * Make the operations of the hold model: a population of events, each
+ * event run scheduling a new one after an exponential delay.
+ *
+ * \param population the number of pending events
+ * \param total the number of events to run
+ * \param ops the operations made
+ */
+static void
+MakeHoldTrace (uint32_t population, uint32_t total, std::vector<Op> &ops)
+{
+  Ptr<ExponentialRandomVariable> delay = CreateObject<ExponentialRandomVariable> ();
+  delay->SetAttribute ("Mean", DoubleValue (100));
+  // the time of each pending event, to know the time of the next one
+  std::priority_queue<uint64_t, std::vector<uint64_t>, std::greater<uint64_t> > pending;
+  uint32_t uid = 0;
+  Op op;
+  op.count = 0;
+  op.key.m_context = 0;
+  for (uint32_t i = 0; i < population; i++)
+    {
+      op.type = 'i';
+      op.key.m_ts = static_cast<uint64_t> (delay->GetValue ());
+      op.key.m_uid = uid++;
+      ops.push_back (op);
+      pending.push (op.key.m_ts);
+    }
+  for (uint32_t i = 0; i < total; i++)
+    {
+      uint64_t now = pending.top ();
+      pending.pop ();
+      op.type = 'n';
+      ops.push_back (op);
+      op.type = 'i';
+      op.key.m_ts = now + static_cast<uint64_t> (delay->GetValue ());
+      op.key.m_uid = uid++;
+      ops.push_back (op);
+      pending.push (op.key.m_ts);
+    }
+  while (!pending.empty ())
+    {
+      pending.pop ();
+      op.type = 'n';
+      ops.push_back (op);
+    }
+}
+
+/**
+ * Replay the operations on a scheduler.
+ *
+ * \param scheduler the scheduler
+ * \param ops the operations
+ * \return a hash of the order of the events removed, the same for all
+ * the schedulers
+ */
+static uint64_t
+Replay (Ptr<Scheduler> scheduler, const std::vector<Op> &ops)
+{
+  uint64_t hash = 0;
+  std::vector<Scheduler::Event> batch;
+  Scheduler::Event ev;
+  ev.impl = 0;
+  for (std::vector<Op>::const_iterator i = ops.begin (); i != ops.end (); i++)
+    {
+      switch (i->type)
+        {
+        case 'i':
+          ev.key = i->key;
+          scheduler->Insert (ev);
+          break;
+        case 'b':
+          batch.resize (i->count);
+          for (uint32_t k = 0; k < batch.size (); k++)
+            {
+              i++;
+              NS_ABORT_MSG_IF (i == ops.end () || i->type != 'i', "Truncated batch");
+              batch[k].impl = 0;
+              batch[k].key = i->key;
+            }
+          scheduler->InsertBatch (batch);
+          break;
+        case 'n':
+          hash = hash * 31 + scheduler->RemoveNext ().key.m_uid;
+          break;
+        case 'r':
+          ev.key = i->key;
+          scheduler->Remove (ev);
+          break;
+        }
+    }
+  // the events still pending at the end of the trace
+  while (!scheduler->IsEmpty ())
+    {
+      hash = hash * 31 + scheduler->RemoveNext ().key.m_uid;
+    }
+  return hash;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string filename = "";
+  std::string schedulers = "ns3::MapScheduler,ns3::HeapScheduler,ns3::QuadHeapScheduler,ns3::CalendarScheduler";
+  uint32_t pop   =  100000;
+  uint32_t total = 1000000;
+  uint32_t runs  =       3;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the schedulers on recorded operations.\n"
+             "\n"
+             "The operations are read from the file given by --file=\"<filename>\",\n"
+             "or standard input with --file=\"-\", as written by a simulation run with\n"
+             "  --SchedulerType=ns3::RecordingScheduler\n"
+             "  --ns3::RecordingScheduler::FileName=<filename>\n"
+             "Without a file, the operations of the hold model are replayed,\n"
+             "with exponential delays of mean 100 ns.");
+  cmd.AddValue ("file",       "file of recorded operations",                       filename);
+  cmd.AddValue ("schedulers", "comma separated list of the schedulers to replay on", schedulers);
+  cmd.AddValue ("pop",        "event population of the hold model (default 1E5)",  pop);
+  cmd.AddValue ("total",      "events run by the hold model (default 1E6)",        total);
+  cmd.AddValue ("runs",       "number of runs of each scheduler (default 3)",      runs);
+  cmd.Parse (argc, argv);
+
+  std::vector<Op> ops;
+  if (filename == "")
+    {
+      LOG ("hold model, population " << pop << ", total " << total);
+      MakeHoldTrace (pop, total, ops);
+    }
+  else if (filename == "-")
+    {
+      LOG ("operations from stdin");
+      ReadTrace (std::cin, ops);
+    }
+  else
+    {
+      LOG ("operations from " << filename);
+      std::ifstream input (filename.c_str ());
+      NS_ABORT_MSG_IF (!input.is_open (), "Could not open " << filename);
+      ReadTrace (input, ops);
+    }
+  LOG ("found " << ops.size () << " operations");
+
+  LOG (std::left << std::setw (28) << "Scheduler" <<
+       std::setw (8) << "Run" <<
+       std::setw (12) << "Time (s)" <<
+       std::setw (14) << "Rate (op/s)" <<
+       "Order hash");
+  std::istringstream names (schedulers);
+  std::string name;
+  while (std::getline (names, name, ','))
+    {
+      ObjectFactory factory;
+      factory.SetTypeId (name);
+      for (uint32_t run = 0; run < runs; run++)
+        {
+          Ptr<Scheduler> scheduler = factory.Create<Scheduler> ();
+          SystemWallClockMs time;
+          time.Start ();
+          uint64_t hash = Replay (scheduler, ops);
+          double seconds = time.End () / 1000.0;
+          LOG (std::left << std::setw (28) << name <<
+               std::setw (8) << run <<
+               std::setw (12) << seconds <<
+               std::setw (14) << (seconds > 0 ? ops.size () / seconds : 0) <<
+               std::hex << hash << std::dec);
+          scheduler->Dispose ();
+        }
+    }
+  return 0;
+}
@@ -45,7 +45,8 @@ public:
   Bench (const uint32_t population, const uint32_t total)
   : m_population (population),
     m_total (total),
-    m_count (0)
+    m_count (0),
+    m_timeout (0)
   { };
   
   void SetRandomStream (Ptr<RandomVariableStream> stream)
@@ -62,15 +63,23 @@ public:
   {
     m_total = total;
   }
+
+  void SetTimeout (const uint64_t timeout)
+  {
+    m_timeout = timeout;
+  }
     
   void RunBench (void);
 private:
   void Cb (void);
+  void Timeout (void);
   
   Ptr<RandomVariableStream> m_rand;
   uint32_t m_population;
   uint32_t m_total;
   uint32_t m_count;
+  uint64_t m_timeout;
+  EventId m_timeoutEvent;
 };
 
 void
@@ -120,9 +129,21 @@ Bench::Cb (void)
 
   Time after = NanoSeconds (m_rand->GetValue ());
   Simulator::Schedule (after, &Bench::Cb, this);
+  if (m_timeout > 0)
+    {
+      // like the timeouts of a MAC, hardly ever reached
+      m_timeoutEvent.Cancel ();
+      m_timeoutEvent = Simulator::Schedule (NanoSeconds (m_timeout), &Bench::Timeout, this);
+    }
   ++m_count;
 }
 
+void
+Bench::Timeout (void)
+{
+  DEB ("timeout at " << Simulator::Now ().GetSeconds () << "s");
+}
+
 
 Ptr<RandomVariableStream>
 GetRandomStream (std::string filename)
@@ -186,10 +207,12 @@ int main (int argc, char *argv[])
   bool schedHeap = false;
   bool schedList = false;
   bool schedMap  = true;
+  bool schedQuad = false;
 
   uint32_t pop   =  100000;
   uint32_t total = 1000000;
   uint32_t runs  =       1;
+  uint64_t timeout =      0;
   std::string filename = "";
   
   CommandLine cmd;
@@ -205,10 +228,12 @@ int main (int argc, char *argv[])
   cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
+  cmd.AddValue ("quad",  "use QuadHeapScheduler",         schedQuad);
   cmd.AddValue ("debug", "enable debugging output",       g_debug);
   cmd.AddValue ("pop",   "event population size (default 1E5)",         pop);
   cmd.AddValue ("total", "total number of events to run (default 1E6)", total);
   cmd.AddValue ("runs",  "number of runs (default 1)",    runs);
+  cmd.AddValue ("timeout", "delay of the timeout each event cancels and schedules again, in ns (default 0, none)", timeout);
   cmd.AddValue ("file",  "file of relative event times",  filename);
   cmd.AddValue ("prec",  "printed output precision",      g_fwidth);
   cmd.Parse (argc, argv);
@@ -219,6 +244,7 @@ int main (int argc, char *argv[])
   if (schedCal)  { factory.SetTypeId ("ns3::CalendarScheduler"); }
   if (schedHeap) { factory.SetTypeId ("ns3::HeapScheduler");     }
   if (schedList) { factory.SetTypeId ("ns3::ListScheduler");     }  
+  if (schedQuad) { factory.SetTypeId ("ns3::QuadHeapScheduler"); }
   Simulator::SetScheduler (factory);
 
   LOGME (std::setprecision (g_fwidth - 6));
@@ -228,9 +254,11 @@ int main (int argc, char *argv[])
   LOGME ("population: " << pop);
   LOGME ("total events: " << total);
   LOGME ("runs: " << runs);
+  LOGME ("timeout: " << timeout);
   
   Bench *bench = new Bench (pop, total);
   bench->SetRandomStream (GetRandomStream (filename));
+  bench->SetTimeout (timeout);
 
   // table header
   LOG ("");